@@ -0,0 +1,959 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Benchmarks Expr kernels without VapourSynth: expressions of the benchmark
+// corpus and examples/ are compiled with Compiler for a synthetic format and
+// run on in-memory planes, so the numbers contain no framework overhead.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/TargetParser/Host.h"
+
+#include "../llvmexpr/analysis/AnalysisResults.hpp"
+#include "../llvmexpr/analysis/ExpressionAnalyzer.hpp"
+#include "../llvmexpr/frontend/InfixConverter.hpp"
+#include "../llvmexpr/frontend/Tokenizer.hpp"
+#include "../llvmexpr/jit/Compiler.hpp"
+#include "../llvmexpr/jit/Jit.hpp"
+#include "../llvmexpr/utils/IntegralImage.hpp"
+#include "../llvmexpr/utils/Trace.hpp"
+
+namespace {
+
+// VapourSynth aligns frame rows to this many bytes.
+constexpr size_t ROW_ALIGNMENT = 64;
+// Size and number of calls of the kernels measuring the fixed cost of a call.
+constexpr int OVERHEAD_WIDTH = 16;
+constexpr int OVERHEAD_HEIGHT = 2;
+constexpr int OVERHEAD_CALLS = 10000;
+// Frames timed per thread, however long they take.
+constexpr int MIN_ITERATIONS = 3;
+// Throughput ratios against the baseline below this are flagged.
+constexpr double REGRESSION_RATIO = 0.9;
+// Patch distance bands are whole mask tiles high in the plugin.
+constexpr int BAND_ROW_MULTIPLE = 16;
+
+struct Options {
+    std::string corpus = LLVMEXPR_SOURCE_ROOT "/benchmarks/corpus.json";
+    std::string examples = LLVMEXPR_SOURCE_ROOT "/examples";
+    std::string format = "grays";
+    int width = 1920;  // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    int height = 1080; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    std::vector<int> threads;
+    double min_time = 1.0;
+    std::string filter;
+    // The defaults of the plugin.
+    int opt_level = 5;   // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    int approx_math = 2;
+    int tile_width = -1;
+    int row_block = 1;
+    std::string json_path;
+    std::string baseline_path;
+};
+
+struct BenchFormat {
+    std::string_view name;
+    VSColorFamily color_family;
+    VSSampleType sample_type;
+    int bits_per_sample;
+    int sub_sampling_w;
+    int sub_sampling_h;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+constexpr std::array FORMATS = {
+    BenchFormat{"gray8", cfGray, stInteger, 8, 0, 0},
+    BenchFormat{"gray16", cfGray, stInteger, 16, 0, 0},
+    BenchFormat{"grays", cfGray, stFloat, 32, 0, 0},
+    BenchFormat{"yuv420p8", cfYUV, stInteger, 8, 1, 1},
+    BenchFormat{"yuv420p10", cfYUV, stInteger, 10, 1, 1},
+    BenchFormat{"yuv420p16", cfYUV, stInteger, 16, 1, 1},
+    BenchFormat{"yuv444p8", cfYUV, stInteger, 8, 0, 0},
+    BenchFormat{"yuv444ps", cfYUV, stFloat, 32, 0, 0},
+    BenchFormat{"rgb24", cfRGB, stInteger, 8, 0, 0},
+    BenchFormat{"rgbs", cfRGB, stFloat, 32, 0, 0},
+};
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+
+VSVideoInfo makeVideoInfo(const BenchFormat& format, int width, int height) {
+    VSVideoInfo vi = {};
+    vi.format.colorFamily = format.color_family;
+    vi.format.sampleType = format.sample_type;
+    vi.format.bitsPerSample = format.bits_per_sample;
+    vi.format.bytesPerSample =
+        (format.bits_per_sample + CHAR_BIT - 1) / CHAR_BIT;
+    vi.format.subSamplingW = format.sub_sampling_w;
+    vi.format.subSamplingH = format.sub_sampling_h;
+    vi.format.numPlanes = format.color_family == cfGray ? 1 : 3;
+    vi.width = width;
+    vi.height = height;
+    vi.numFrames = 1;
+    return vi;
+}
+
+int planeWidth(const VSVideoInfo& vi, int plane) {
+    return plane == 0 ? vi.width : vi.width >> vi.format.subSamplingW;
+}
+
+int planeHeight(const VSVideoInfo& vi, int plane) {
+    return plane == 0 ? vi.height : vi.height >> vi.format.subSamplingH;
+}
+
+struct BenchCase {
+    std::string name;
+    std::string source;
+    bool infix = false;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream) {
+        throw std::runtime_error(std::format("Cannot open '{}'.", path));
+    }
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+// The postfix expressions of benchmarks/corpus.json, then the infix
+// expressions of examples/, in file name order.
+std::vector<BenchCase> loadCases(const Options& options) {
+    std::vector<BenchCase> cases;
+    if (!options.corpus.empty()) {
+        llvm::Expected<llvm::json::Value> corpus =
+            llvm::json::parse(readFile(options.corpus));
+        if (!corpus) {
+            throw std::runtime_error(
+                std::format("Invalid corpus '{}': {}", options.corpus,
+                            llvm::toString(corpus.takeError())));
+        }
+        const llvm::json::Object* root = corpus->getAsObject();
+        const llvm::json::Array* entries =
+            root != nullptr ? root->getArray("cases") : nullptr;
+        if (entries == nullptr) {
+            throw std::runtime_error(std::format(
+                "Corpus '{}' has no \"cases\" array.", options.corpus));
+        }
+        for (const llvm::json::Value& entry : *entries) {
+            const llvm::json::Object* object = entry.getAsObject();
+            std::optional<llvm::StringRef> name;
+            std::optional<llvm::StringRef> expr;
+            if (object != nullptr) {
+                name = object->getString("name");
+                expr = object->getString("expr");
+            }
+            if (!name || !expr) {
+                throw std::runtime_error(std::format(
+                    "Corpus '{}' has a case without a name or expr.",
+                    options.corpus));
+            }
+            cases.push_back({name->str(), expr->str(), false});
+        }
+    }
+    if (!options.examples.empty()) {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry :
+             std::filesystem::directory_iterator(options.examples)) {
+            if (entry.path().extension() == ".expr") {
+                paths.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+        for (const auto& path : paths) {
+            cases.push_back({"examples/" + path.stem().string(),
+                             readFile(path.string()), true});
+        }
+    }
+    std::erase_if(cases, [&](const BenchCase& bench_case) {
+        return !bench_case.name.contains(options.filter);
+    });
+    return cases;
+}
+
+// Converts an infix example for `plane` with the macros the plugin defines
+// for a single input clip of format `vi`.
+std::string toPostfix(const std::string& source, const VSVideoInfo& vi,
+                      int plane) {
+    const int sample_type = vi.format.sampleType == stFloat ? 1 : 0;
+    std::map<std::string, std::string> macros;
+    macros["__EXPR__"] = "";
+    macros["__WIDTH__"] = std::to_string(vi.width);
+    macros["__HEIGHT__"] = std::to_string(vi.height);
+    macros["__INPUT_NUM__"] = "1";
+    macros["__OUTPUT_BITDEPTH__"] = std::to_string(vi.format.bitsPerSample);
+    macros["__OUTPUT_COLORFAMILY__"] = std::to_string(vi.format.colorFamily);
+    macros["__SUBSAMPLE_W__"] = std::to_string(vi.format.subSamplingW);
+    macros["__SUBSAMPLE_H__"] = std::to_string(vi.format.subSamplingH);
+    macros["__PLANE_NO__"] = std::to_string(plane);
+    macros["__OUTPUT_SAMPLETYPE__"] = std::to_string(sample_type);
+    macros["__INPUT_BITDEPTH_0__"] = std::to_string(vi.format.bitsPerSample);
+    macros["__INPUT_COLORFAMILY_0__"] = std::to_string(vi.format.colorFamily);
+    macros["__INPUT_SAMPLETYPE_0__"] = std::to_string(sample_type);
+    return convertInfixToPostfix(source, 1, infix2postfix::Mode::Expr,
+                                 &macros);
+}
+
+// A compiled plane kernel and the layout of its rwptrs beyond the clips.
+struct Kernel {
+    ProcessProc func = nullptr;
+    std::shared_ptr<JitCode> code; // keeps func loaded
+    bool approx_math = false;
+    std::vector<std::pair<int, int>> integral_planes;
+    std::vector<analysis::PatchDistanceKey> patches;
+    std::vector<std::pair<int, int>> plane_reads;
+    std::vector<int> extra_outputs;
+    size_t num_reductions = 0;
+    // Rows per call for kernels reading patch distances, 0 for one call
+    // over the whole plane.
+    int band_rows = 0;
+};
+
+struct Program {
+    VSVideoInfo vi = {};
+    int num_clips = 1;
+    size_t num_props = 0;
+    std::vector<Kernel> kernels; // one per plane
+};
+
+// Compiles the first `num_planes` planes of `postfix` (one expression per
+// plane) for clips of format `vi`, like Expr does: with the loop options of
+// the options, and a row range for planes reading patch distances. Kernels
+// stay loaded for the whole run, so every program gets its own kernel names.
+Program compileProgram(const std::vector<std::string>& postfix,
+                       const VSVideoInfo& vi, int num_planes,
+                       const Options& options) {
+    static int num_programs = 0;
+    const int program_id = num_programs++;
+    Program program;
+    program.vi = vi;
+    std::vector<std::vector<Token>> tokens(num_planes);
+    for (int plane = 0; plane < num_planes; ++plane) {
+        program.num_clips =
+            std::max(program.num_clips, countClips(postfix.at(plane)));
+    }
+    std::map<std::pair<int, std::string>, int> prop_map;
+    for (int plane = 0; plane < num_planes; ++plane) {
+        {
+            const TraceScope trace("frontend", "tokenize");
+            tokens[plane] = tokenize(postfix.at(plane), program.num_clips,
+                                     ExprMode::EXPR);
+        }
+        if (hasTemporalAccess(tokens[plane])) {
+            throw std::runtime_error("Temporal accesses are not supported.");
+        }
+        for (const auto& token : tokens[plane]) {
+            if (token.type == TokenType::PROP_ACCESS ||
+                token.type == TokenType::PROP_EXISTS) {
+                const auto& payload =
+                    std::get<TokenPayload_PropAccess>(token.payload);
+                // 0 is for frame number N
+                prop_map.try_emplace({payload.clip_idx, payload.prop_name},
+                                     static_cast<int>(prop_map.size()) + 1);
+            }
+        }
+    }
+    program.num_props = prop_map.size();
+
+    const std::vector<const VSVideoInfo*> in_vi(program.num_clips,
+                                                &program.vi);
+    for (int plane = 0; plane < num_planes; ++plane) {
+        analysis::AnalysisManager manager(tokens[plane], false);
+        {
+            const TraceScope trace("frontend", "analyze");
+            analysis::ExpressionAnalyzer analyzer(manager);
+            analyzer.analyze();
+        }
+        Kernel kernel;
+        kernel.integral_planes =
+            manager.getResult<analysis::IntegralUsagePass>().planes;
+        kernel.patches =
+            manager.getResult<analysis::PatchDistanceUsagePass>().patches;
+        kernel.plane_reads =
+            manager.getResult<analysis::PlaneReadUsagePass>().planes;
+        for (const auto& [clip_idx, plane_idx] : kernel.plane_reads) {
+            if (plane_idx >= vi.format.numPlanes) {
+                throw std::runtime_error(std::format(
+                    "Plane access: clip {} has no plane {}.", clip_idx,
+                    plane_idx));
+            }
+        }
+        kernel.extra_outputs =
+            manager.getResult<analysis::OutputUsagePass>().outputs;
+        kernel.num_reductions =
+            manager.getResult<analysis::ReductionUsagePass>()
+                .reductions.size();
+
+        LoopOptions loop_options{.tile_width = options.tile_width,
+                                 .row_block = options.row_block};
+        if (!kernel.patches.empty()) {
+            loop_options.row_range = true;
+            kernel.band_rows = patchDistanceBandRows(
+                kernel.patches.size(), planeWidth(vi, plane),
+                planeHeight(vi, plane), BAND_ROW_MULTIPLE);
+        }
+
+        const analysis::ExpressionAnalysisResults results(manager);
+        Compiler compiler(std::vector<Token>(tokens[plane]), &program.vi,
+                          in_vi, planeWidth(vi, plane),
+                          planeHeight(vi, plane), false, "", prop_map,
+                          std::format("process_kernel_bench_{}_plane{}",
+                                      program_id, plane),
+                          options.opt_level, options.approx_math,
+                          loop_options, results);
+        const CompiledFunction compiled = compiler.compile();
+        kernel.func = compiled.func_ptr;
+        kernel.code = compiled.code;
+        kernel.approx_math = compiled.approx_math;
+        program.kernels.push_back(std::move(kernel));
+    }
+    return program;
+}
+
+// A plane with rows aligned like the ones of VapourSynth frames.
+struct Plane {
+    std::vector<uint8_t> storage;
+    uint8_t* data = nullptr;
+    int stride = 0;
+};
+
+Plane makePlane(int width, int height, int bytes_per_sample) {
+    Plane plane;
+    const size_t row_bytes =
+        static_cast<size_t>(width) * static_cast<size_t>(bytes_per_sample);
+    plane.stride = static_cast<int>((row_bytes + ROW_ALIGNMENT - 1) /
+                                    ROW_ALIGNMENT * ROW_ALIGNMENT);
+    size_t space =
+        (static_cast<size_t>(plane.stride) * static_cast<size_t>(height)) +
+        ROW_ALIGNMENT;
+    plane.storage.resize(space);
+    void* ptr = plane.storage.data();
+    plane.data =
+        static_cast<uint8_t*>(std::align(ROW_ALIGNMENT, space - ROW_ALIGNMENT,
+                                         ptr, space));
+    return plane;
+}
+
+// Fills a plane with uniform noise over the range of its format.
+void fillNoise(Plane& plane, int width, int height,
+               const VSVideoFormat& format, std::mt19937& rng) {
+    const auto max_value = static_cast<uint32_t>(
+        (uint64_t{1} << format.bitsPerSample) - 1);
+    std::uniform_int_distribution<uint32_t> int_dist(0, max_value);
+    std::uniform_real_distribution<float> float_dist(0.0F, 1.0F);
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = plane.data + (static_cast<ptrdiff_t>(y) * plane.stride);
+        for (int x = 0; x < width; ++x) {
+            if (format.sampleType == stFloat) {
+                reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                    float*>(row)[x] = float_dist(rng);
+            } else if (format.bytesPerSample == 1) {
+                row[x] = static_cast<uint8_t>(int_dist(rng));
+            } else {
+                reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                    uint16_t*>(row)[x] = static_cast<uint16_t>(int_dist(rng));
+            }
+        }
+    }
+}
+
+// The buffers one thread runs a Program on, and the kernel arguments
+// pointing into them.
+struct Frame {
+    std::vector<std::vector<Plane>> clips; // [clip][plane]
+    std::vector<Plane> outputs;
+    std::vector<std::vector<double>> integral_tables;
+    std::vector<std::vector<float>> patch_tables;
+    std::vector<std::vector<uint8_t*>> patch_rows; // [plane][patch]
+    std::vector<std::vector<double>> reduction_results;
+    std::vector<std::vector<uint8_t*>> rwptrs; // per plane
+    std::vector<std::vector<int>> strides;
+    std::vector<float> props;
+};
+
+// Builds the arguments of every kernel in the layout appendKernelArgs uses.
+// The box sum and patch distance tables are computed here once, as they are
+// per-frame host work rather than part of the kernels.
+Frame makeFrame(const Program& program, unsigned seed) {
+    const VSVideoInfo& vi = program.vi;
+    const int num_planes = static_cast<int>(program.kernels.size());
+    std::mt19937 rng(seed);
+    Frame frame;
+    frame.clips.resize(program.num_clips);
+    for (auto& clip : frame.clips) {
+        for (int plane = 0; plane < vi.format.numPlanes; ++plane) {
+            clip.push_back(makePlane(planeWidth(vi, plane),
+                                     planeHeight(vi, plane),
+                                     vi.format.bytesPerSample));
+            fillNoise(clip.back(), planeWidth(vi, plane),
+                      planeHeight(vi, plane), vi.format, rng);
+        }
+    }
+    frame.props.assign(1 + program.num_props, 0.0F);
+    frame.rwptrs.resize(num_planes);
+    frame.strides.resize(num_planes);
+    frame.patch_rows.resize(num_planes);
+    frame.reduction_results.resize(num_planes);
+
+    for (int plane = 0; plane < num_planes; ++plane) {
+        const Kernel& kernel = program.kernels[plane];
+        const int width = planeWidth(vi, plane);
+        const int height = planeHeight(vi, plane);
+        auto& rwptrs = frame.rwptrs[plane];
+        auto& strides = frame.strides[plane];
+        auto push_plane = [&](const Plane& buffer) {
+            rwptrs.push_back(buffer.data);
+            strides.push_back(buffer.stride);
+        };
+
+        frame.outputs.push_back(
+            makePlane(width, height, vi.format.bytesPerSample));
+        push_plane(frame.outputs.back());
+        for (const auto& clip : frame.clips) {
+            push_plane(clip[plane]);
+        }
+        for (const auto& [clip_idx, plane_idx] : kernel.integral_planes) {
+            const int table_plane = plane_idx < 0 ? plane : plane_idx;
+            const Plane& src = frame.clips[clip_idx][table_plane];
+            const int table_width = planeWidth(vi, table_plane);
+            frame.integral_tables.emplace_back();
+            computeIntegralImage(src.data, src.stride, table_width,
+                                 planeHeight(vi, table_plane), vi.format,
+                                 frame.integral_tables.back());
+            rwptrs.push_back(reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                             uint8_t*>(frame.integral_tables.back().data()));
+            strides.push_back(integralImageStride(table_width));
+        }
+        for (const auto& patch : kernel.patches) {
+            const Plane& src = frame.clips[patch.clip_idx][plane];
+            std::vector<double> samples;
+            loadPlaneSamples(src.data, src.stride, width, height, vi.format,
+                             samples);
+            frame.patch_tables.emplace_back(static_cast<size_t>(width) *
+                                            height);
+            PatchDistanceScratch scratch;
+            computePatchDistance(samples, width, height, patch.dx, patch.dy,
+                                 patch.radius, 0, height,
+                                 frame.patch_tables.back().data(), scratch);
+            frame.patch_rows[plane].push_back(reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                uint8_t*>(frame.patch_tables.back().data()));
+            rwptrs.push_back(frame.patch_rows[plane].back());
+            strides.push_back(patchDistanceStride(width));
+        }
+        for (const auto& [clip_idx, plane_idx] : kernel.plane_reads) {
+            push_plane(frame.clips[clip_idx][plane_idx]);
+        }
+        for (size_t k = 0; k < kernel.extra_outputs.size(); ++k) {
+            frame.outputs.push_back(
+                makePlane(width, height, vi.format.bytesPerSample));
+            push_plane(frame.outputs.back());
+        }
+        if (kernel.num_reductions > 0) {
+            frame.reduction_results[plane].resize(kernel.num_reductions);
+            rwptrs.push_back(reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                             uint8_t*>(frame.reduction_results[plane].data()));
+            strides.push_back(0);
+        }
+    }
+    return frame;
+}
+
+void runFrame(const Program& program, Frame& frame) {
+    for (size_t plane = 0; plane < program.kernels.size(); ++plane) {
+        const Kernel& kernel = program.kernels[plane];
+        auto& rwptrs = frame.rwptrs[plane];
+        const auto& strides = frame.strides[plane];
+        if (kernel.band_rows == 0) {
+            kernel.func(nullptr, rwptrs.data(), strides.data(),
+                        frame.props.data());
+            continue;
+        }
+        // Band by band like the plugin, with the distance planes pointing at
+        // the first row of the band.
+        const size_t slot =
+            1 + frame.clips.size() + kernel.integral_planes.size();
+        const int height = planeHeight(program.vi, static_cast<int>(plane));
+        for (int y0 = 0; y0 < height; y0 += kernel.band_rows) {
+            for (size_t k = 0; k < kernel.patches.size(); ++k) {
+                rwptrs[slot + k] =
+                    frame.patch_rows[plane][k] +
+                    (static_cast<ptrdiff_t>(y0) * strides[slot + k]);
+            }
+            std::array<int32_t, 2> rows = {
+                y0, std::min(y0 + kernel.band_rows, height)};
+            kernel.func(rows.data(), rwptrs.data(), strides.data(),
+                        frame.props.data());
+        }
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Runs `iterations` frames on each of the frames concurrently, one thread
+// per frame, and returns the wall time in seconds.
+double runThreads(const Program& program, std::span<Frame> frames,
+                  int iterations) {
+    std::atomic<size_t> ready = 0;
+    std::atomic<bool> go = false;
+    std::vector<std::thread> workers;
+    workers.reserve(frames.size());
+    for (Frame& frame : frames) {
+        workers.emplace_back([&, target = &frame] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < iterations; ++i) {
+                runFrame(program, *target);
+            }
+        });
+    }
+    while (ready.load() < frames.size()) {
+        std::this_thread::yield();
+    }
+    const Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return secondsSince(start);
+}
+
+struct Run {
+    int threads;
+    double fps;
+    double mpix_per_s;
+};
+
+struct CaseResult {
+    std::string name;
+    std::string error;
+    bool approx_math = false;
+    double compile_ms = 0.0;
+    std::map<std::string, double> phases_ms;
+    double call_overhead_us = 0.0;
+    std::vector<Run> runs;
+};
+
+void benchmarkCase(const BenchCase& bench_case, const BenchFormat& format,
+                   const Options& options, CaseResult& result) {
+    const VSVideoInfo vi =
+        makeVideoInfo(format, options.width, options.height);
+    const int num_planes = vi.format.numPlanes;
+
+    std::vector<std::string> postfix(num_planes, bench_case.source);
+    if (bench_case.infix) {
+        for (int plane = 0; plane < num_planes; ++plane) {
+            postfix[plane] = toPostfix(bench_case.source, vi, plane);
+        }
+    }
+
+    Program program;
+    {
+        const PhaseTimes phase_times;
+        const Clock::time_point start = Clock::now();
+        program = compileProgram(postfix, vi, num_planes, options);
+        result.compile_ms = secondsSince(start) * 1e3;
+        for (const auto& [name, seconds] : phase_times.seconds()) {
+            result.phases_ms[name] = seconds * 1e3;
+        }
+    }
+    result.approx_math =
+        std::ranges::any_of(program.kernels, &Kernel::approx_math);
+
+    // Fixed cost of a call: the first plane on a frame of a few pixels.
+    {
+        const Program tiny = compileProgram(
+            postfix, makeVideoInfo(format, OVERHEAD_WIDTH, OVERHEAD_HEIGHT), 1,
+            options);
+        Frame frame = makeFrame(tiny, 0);
+        runFrame(tiny, frame);
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < OVERHEAD_CALLS; ++i) {
+            runFrame(tiny, frame);
+        }
+        result.call_overhead_us = secondsSince(start) * 1e6 / OVERHEAD_CALLS;
+    }
+
+    // Calibrate the number of frames on one thread, then time every thread
+    // count with that many frames per thread.
+    const int max_threads = std::ranges::max(options.threads);
+    std::vector<Frame> frames;
+    for (int t = 0; t < max_threads; ++t) {
+        frames.push_back(makeFrame(program, static_cast<unsigned>(t)));
+    }
+    runFrame(program, frames[0]);
+    int iterations = 0;
+    const Clock::time_point start = Clock::now();
+    while (iterations < MIN_ITERATIONS ||
+           secondsSince(start) < options.min_time) {
+        runFrame(program, frames[0]);
+        ++iterations;
+    }
+
+    const double pixels = static_cast<double>(vi.width) * vi.height;
+    for (int threads : options.threads) {
+        const double seconds = runThreads(
+            program, std::span(frames).first(static_cast<size_t>(threads)),
+            iterations);
+        const double fps = threads * iterations / seconds;
+        result.runs.push_back({threads, fps, fps * pixels / 1e6});
+    }
+}
+
+llvm::json::Value toJson(const std::vector<CaseResult>& results,
+                         const Options& options) {
+    llvm::json::Array cases;
+    for (const auto& result : results) {
+        llvm::json::Object object{{"name", result.name}};
+        if (!result.error.empty()) {
+            object["error"] = result.error;
+            cases.push_back(std::move(object));
+            continue;
+        }
+        llvm::json::Object phases;
+        for (const auto& [name, ms] : result.phases_ms) {
+            phases[name] = ms;
+        }
+        llvm::json::Array runs;
+        for (const auto& run : result.runs) {
+            runs.push_back(llvm::json::Object{{"threads", run.threads},
+                                              {"fps", run.fps},
+                                              {"mpix_per_s", run.mpix_per_s}});
+        }
+        object["approx_math"] = result.approx_math;
+        object["compile_ms"] = result.compile_ms;
+        object["phases_ms"] = std::move(phases);
+        object["call_overhead_us"] = result.call_overhead_us;
+        object["runs"] = std::move(runs);
+        cases.push_back(std::move(object));
+    }
+    return llvm::json::Object{
+        {"cpu", llvm::sys::getHostCPUName()},
+        {"format", options.format},
+        {"width", options.width},
+        {"height", options.height},
+        {"opt_level", options.opt_level},
+        {"approx_math", options.approx_math},
+        {"tile_width", options.tile_width},
+        {"row_block", options.row_block},
+        {"cases", std::move(cases)},
+    };
+}
+
+void printResults(const std::vector<CaseResult>& results) {
+    for (const auto& result : results) {
+        if (!result.error.empty()) {
+            std::cout << std::format("{:<32} FAILED ({})\n", result.name,
+                                     result.error);
+            continue;
+        }
+        std::cout << std::format("{:<32} compile {:8.2f} ms  call {:7.2f} us",
+                                 result.name, result.compile_ms,
+                                 result.call_overhead_us);
+        for (const auto& run : result.runs) {
+            std::cout << std::format("  {}T {:9.1f} Mpix/s", run.threads,
+                                     run.mpix_per_s);
+        }
+        std::cout << '\n';
+    }
+}
+
+// Prints the throughput and compile time of each case relative to the
+// matching case and thread count of a previous --json output.
+void compareBaseline(const std::vector<CaseResult>& results,
+                     const std::string& path) {
+    llvm::Expected<llvm::json::Value> baseline =
+        llvm::json::parse(readFile(path));
+    if (!baseline) {
+        throw std::runtime_error(std::format(
+            "Invalid baseline '{}': {}", path,
+            llvm::toString(baseline.takeError())));
+    }
+    const llvm::json::Object* root = baseline->getAsObject();
+    const llvm::json::Array* cases =
+        root != nullptr ? root->getArray("cases") : nullptr;
+    if (cases == nullptr) {
+        throw std::runtime_error(
+            std::format("Baseline '{}' has no \"cases\" array.", path));
+    }
+
+    std::cout << std::format("\nRelative to {} (<{} marked !):\n", path,
+                             REGRESSION_RATIO);
+    for (const auto& result : results) {
+        const llvm::json::Object* base = nullptr;
+        for (const llvm::json::Value& entry : *cases) {
+            const llvm::json::Object* object = entry.getAsObject();
+            if (object != nullptr &&
+                object->getString("name") == llvm::StringRef(result.name)) {
+                base = object;
+                break;
+            }
+        }
+        const llvm::json::Array* base_runs =
+            base != nullptr ? base->getArray("runs") : nullptr;
+        if (!result.error.empty() || base_runs == nullptr) {
+            continue;
+        }
+        std::string line = std::format("{:<32}", result.name);
+        if (auto compile_ms = base->getNumber("compile_ms")) {
+            line += std::format(" compile {:6.3f}x",
+                                result.compile_ms / *compile_ms);
+        }
+        for (const auto& run : result.runs) {
+            for (const llvm::json::Value& entry : *base_runs) {
+                const llvm::json::Object* base_run = entry.getAsObject();
+                if (base_run == nullptr ||
+                    base_run->getInteger("threads") != run.threads) {
+                    continue;
+                }
+                if (auto mpix = base_run->getNumber("mpix_per_s")) {
+                    const double ratio = run.mpix_per_s / *mpix;
+                    line += std::format("  {}T {:6.3f}x{}", run.threads, ratio,
+                                        ratio < REGRESSION_RATIO ? "!" : "");
+                }
+            }
+        }
+        std::cout << line << '\n';
+    }
+}
+
+void print_usage() {
+    std::cerr << "Usage: kernel_bench [options]\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  --corpus FILE      Postfix expressions to run (default: "
+                 "benchmarks/corpus.json,\n"
+                 "                     empty to skip)\n";
+    std::cerr << "  --examples DIR     Infix .expr files to run (default: "
+                 "examples/, empty to skip)\n";
+    std::cerr << "  --filter TEXT      Only run cases whose name contains "
+                 "TEXT\n";
+    std::cerr << "  --format NAME      Clip format (default: grays), one of:\n"
+                 "                    ";
+    for (const auto& format : FORMATS) {
+        std::cerr << ' ' << format.name;
+    }
+    std::cerr << '\n';
+    std::cerr << "  --size WxH         Frame size (default: 1920x1080)\n";
+    std::cerr << "  --threads N[,N..]  Thread counts to time (default: 1 and "
+                 "all cores)\n";
+    std::cerr << "  --min-time S       Seconds to run each case on one "
+                 "thread (default: 1)\n";
+    std::cerr << "  --opt-level N      opt_level of the kernels (default: "
+                 "5)\n";
+    std::cerr << "  --approx-math N    approx_math of the kernels (default: "
+                 "2)\n";
+    std::cerr << "  --tile-width N     tile_width of the kernels (default: "
+                 "-1)\n";
+    std::cerr << "  --row-block N      row_block of the kernels (default: "
+                 "1)\n";
+    std::cerr << "  --json FILE        Write the results as JSON\n";
+    std::cerr << "  --baseline FILE    Compare with the JSON of a previous "
+                 "run\n";
+}
+
+std::optional<int> parseInt(std::string_view text) {
+    int value = 0;
+    std::istringstream stream{std::string(text)};
+    if (!(stream >> value) || !stream.eof()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    auto args = std::span(argv, argc);
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << std::format("Error: {} requires an argument\n",
+                                     std::string(arg));
+            print_usage();
+            return 1;
+        }
+        const std::string_view value = args[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--examples") {
+            options.examples = value;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--format") {
+            options.format = value;
+        } else if (arg == "--size") {
+            std::istringstream size_stream{std::string(value)};
+            char separator = 0;
+            if (!(size_stream >> options.width >> separator >>
+                  options.height) ||
+                separator != 'x' || options.width <= 0 ||
+                options.height <= 0) {
+                std::cerr << "Error: --size must be WxH, e.g. 1920x1080\n";
+                return 1;
+            }
+        } else if (arg == "--threads") {
+            std::istringstream list{std::string(value)};
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                const std::optional<int> threads = parseInt(item);
+                if (!threads || *threads <= 0) {
+                    std::cerr << "Error: --threads must be a list of "
+                                 "positive integers, e.g. 1,4,8\n";
+                    return 1;
+                }
+                options.threads.push_back(*threads);
+            }
+        } else if (arg == "--min-time") {
+            std::istringstream stream{std::string(value)};
+            if (!(stream >> options.min_time) || options.min_time < 0) {
+                std::cerr << "Error: --min-time must be a number of "
+                             "seconds\n";
+                return 1;
+            }
+        } else if (arg == "--opt-level" || arg == "--approx-math") {
+            const std::optional<int> level = parseInt(value);
+            if (!level || *level < 0) {
+                std::cerr << std::format("Error: Invalid value '{}' for {}\n",
+                                         std::string(value),
+                                         std::string(arg));
+                return 1;
+            }
+            (arg == "--opt-level" ? options.opt_level : options.approx_math) =
+                *level;
+        } else if (arg == "--tile-width" || arg == "--row-block") {
+            // The values Expr accepts.
+            const std::optional<int> number = parseInt(value);
+            if (!number || (arg == "--tile-width" ? *number < -1
+                                                  : *number != 1 &&
+                                                        *number != 2 &&
+                                                        *number != 4)) {
+                std::cerr << std::format("Error: Invalid value '{}' for {}\n",
+                                         std::string(value),
+                                         std::string(arg));
+                return 1;
+            }
+            (arg == "--tile-width" ? options.tile_width : options.row_block) =
+                *number;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--baseline") {
+            options.baseline_path = value;
+        } else {
+            std::cerr << std::format("Error: Unknown option '{}'\n",
+                                     std::string(arg));
+            print_usage();
+            return 1;
+        }
+    }
+
+    const auto* format = std::ranges::find(FORMATS, options.format,
+                                           &BenchFormat::name);
+    if (format == FORMATS.end()) {
+        std::cerr << std::format("Error: Unknown format '{}'\n",
+                                 options.format);
+        print_usage();
+        return 1;
+    }
+    if (options.threads.empty()) {
+        options.threads.push_back(1);
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        if (cores > 1) {
+            options.threads.push_back(cores);
+        }
+    }
+
+    try {
+        const std::vector<BenchCase> cases = loadCases(options);
+        std::cout << std::format("CPU: {}, {} {}x{}\n",
+                                 llvm::sys::getHostCPUName().str(),
+                                 options.format, options.width,
+                                 options.height);
+
+        std::vector<CaseResult> results;
+        for (const auto& bench_case : cases) {
+            CaseResult& result = results.emplace_back();
+            result.name = bench_case.name;
+            try {
+                benchmarkCase(bench_case, *format, options, result);
+            } catch (const std::exception& e) {
+                result = CaseResult{.name = bench_case.name,
+                                    .error = e.what()};
+            }
+        }
+        printResults(results);
+
+        if (!options.json_path.empty()) {
+            std::error_code ec;
+            llvm::raw_fd_ostream stream(options.json_path, ec);
+            if (ec) {
+                throw std::runtime_error(
+                    std::format("Cannot open '{}': {}", options.json_path,
+                                ec.message()));
+            }
+            stream << llvm::formatv("{0:2}", toJson(results, options))
+                   << '\n';
+        }
+        if (!options.baseline_path.empty()) {
+            compareBaseline(results, options.baseline_path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("Error: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,770 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures the accuracy and throughput of the approx_math functions of
+// utils/Math.hpp at every vector width, next to the LLVM intrinsics the
+// precise kernels call and to the host libm. Errors are in ULPs of the float
+// result, against libm in double precision.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/TargetParser/Host.h"
+
+#include "../llvmexpr/jit/Jit.hpp"
+#include "../llvmexpr/utils/Math.hpp"
+
+namespace {
+
+// Inputs evaluated per batch while measuring errors. A multiple of every
+// vector width.
+constexpr size_t CHUNK_SIZE = size_t{1} << 16;
+// Inputs of the throughput loops, small enough to stay in L1.
+constexpr size_t THROUGHPUT_SIZE = 2048;
+// Upper bounds of the error histogram buckets, in ULPs.
+constexpr std::array<double, 7> BUCKET_LIMITS = {0.5, 1,   2,    4,
+                                                 16,  256, 65536};
+constexpr std::array<std::string_view, BUCKET_LIMITS.size() + 1>
+    BUCKET_NAMES = {"<=0.5", "<=1",   "<=2",    "<=4",
+                    "<=16",  "<=256", "<=65536", ">65536"};
+
+using ReferenceFn = double (*)(double, double);
+using LibmFn = float (*)(float, float);
+// Applies a function to `n` inputs of x (and y for binary functions).
+using LoopFn = void (*)(const float* x, const float* y, float* out,
+                        int64_t n);
+
+struct OpInfo {
+    MathOp op;
+    std::string_view name;
+    llvm::Intrinsic::ID intrinsic;
+    ReferenceFn reference;
+    LibmFn libm;
+    // Range of the throughput inputs.
+    float low;
+    float high;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+constexpr std::array OPS = {
+    OpInfo{MathOp::Exp, "exp", llvm::Intrinsic::exp,
+           [](double x, double) { return std::exp(x); },
+           [](float x, float) { return std::exp(x); }, -20.0F, 20.0F},
+    OpInfo{MathOp::Log, "log", llvm::Intrinsic::log,
+           [](double x, double) { return std::log(x); },
+           [](float x, float) { return std::log(x); }, 1e-3F, 1e3F},
+    OpInfo{MathOp::Sin, "sin", llvm::Intrinsic::sin,
+           [](double x, double) { return std::sin(x); },
+           [](float x, float) { return std::sin(x); }, -100.0F, 100.0F},
+    OpInfo{MathOp::Cos, "cos", llvm::Intrinsic::cos,
+           [](double x, double) { return std::cos(x); },
+           [](float x, float) { return std::cos(x); }, -100.0F, 100.0F},
+    OpInfo{MathOp::Tan, "tan", llvm::Intrinsic::tan,
+           [](double x, double) { return std::tan(x); },
+           [](float x, float) { return std::tan(x); }, -100.0F, 100.0F},
+    OpInfo{MathOp::Atan, "atan", llvm::Intrinsic::atan,
+           [](double x, double) { return std::atan(x); },
+           [](float x, float) { return std::atan(x); }, -100.0F, 100.0F},
+    OpInfo{MathOp::Atan2, "atan2", llvm::Intrinsic::atan2,
+           [](double y, double x) { return std::atan2(y, x); },
+           [](float y, float x) { return std::atan2(y, x); }, -100.0F,
+           100.0F},
+    OpInfo{MathOp::Acos, "acos", llvm::Intrinsic::acos,
+           [](double x, double) { return std::acos(x); },
+           [](float x, float) { return std::acos(x); }, -1.0F, 1.0F},
+    OpInfo{MathOp::Asin, "asin", llvm::Intrinsic::asin,
+           [](double x, double) { return std::asin(x); },
+           [](float x, float) { return std::asin(x); }, -1.0F, 1.0F},
+};
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+
+struct Options {
+    std::vector<std::string> ops;
+    std::vector<int> widths = {1, 4, 8, 16}; // NOLINT
+    bool exhaustive = false;
+    int per_binade = 4096;             // NOLINT
+    int64_t pairs = int64_t{1} << 22;  // NOLINT
+    double min_time = 0.2;             // NOLINT
+    std::string json_path;
+};
+
+// The approximation of `op` at `width` lanes (1 = scalar).
+template <int Width>
+llvm::Function* approxFunction(MathOp op, llvm::Module& module) {
+    MathFunctionGenerator<Width> generator(&module, module.getContext());
+    llvm::Function* result = nullptr;
+    std::apply(
+        [&](auto... op_constant) {
+            auto dispatch = [&](auto op_c) {
+                if (op_c.value == op) {
+                    result = generator.template getOrCreate<op_c.value>();
+                }
+            };
+            (dispatch(op_constant), ...);
+        },
+        SupportedMathOpsTuple{});
+    return result;
+}
+
+llvm::Function* approxFunction(MathOp op, int width, llvm::Module& module) {
+    switch (width) {
+    case 1:
+        return approxFunction<1>(op, module);
+    case 4:
+        return approxFunction<4>(op, module);
+    case 8: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+        return approxFunction<8>(op, module);
+    case 16: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+        return approxFunction<16>(op, module);
+    default:
+        throw std::runtime_error(
+            std::format("Unsupported vector width {}.", width));
+    }
+}
+
+llvm::Type* valueType(llvm::LLVMContext& context, int width) {
+    llvm::Type* float_ty = llvm::Type::getFloatTy(context);
+    if (width == 1) {
+        return float_ty;
+    }
+    return llvm::FixedVectorType::get(float_ty, width);
+}
+
+// Emits a LoopFn named `name` calling `callee` on `width` elements at a
+// time, with the fast-math flags of the kernels. `n` must be a multiple of
+// `width`.
+void emitLoop(llvm::Module& module, const std::string& name,
+              llvm::FunctionCallee callee, int arity, int width) {
+    llvm::LLVMContext& context = module.getContext();
+    llvm::IRBuilder<> builder(context);
+    llvm::FastMathFlags fmf;
+    fmf.setFast();
+    fmf.setNoNaNs(false);
+    builder.setFastMathFlags(fmf);
+
+    llvm::Type* ptr_ty = builder.getPtrTy();
+    llvm::Type* i64_ty = builder.getInt64Ty();
+    auto* func_ty = llvm::FunctionType::get(
+        builder.getVoidTy(), {ptr_ty, ptr_ty, ptr_ty, i64_ty}, false);
+    auto* func = llvm::Function::Create(
+        func_ty, llvm::Function::ExternalLinkage, name, module);
+    llvm::Value* x = func->getArg(0);
+    llvm::Value* y = func->getArg(1);
+    llvm::Value* out = func->getArg(2);
+    llvm::Value* n = func->getArg(3);
+
+    auto* entry_bb = llvm::BasicBlock::Create(context, "entry", func);
+    auto* loop_bb = llvm::BasicBlock::Create(context, "loop", func);
+    auto* exit_bb = llvm::BasicBlock::Create(context, "exit", func);
+
+    builder.SetInsertPoint(entry_bb);
+    builder.CreateCondBr(builder.CreateICmpSGT(n, builder.getInt64(0)),
+                         loop_bb, exit_bb);
+
+    builder.SetInsertPoint(loop_bb);
+    llvm::PHINode* i = builder.CreatePHI(i64_ty, 2, "i");
+    i->addIncoming(builder.getInt64(0), entry_bb);
+    llvm::Type* value_ty = valueType(context, width);
+    const llvm::Align align(sizeof(float));
+    std::vector<llvm::Value*> args;
+    for (llvm::Value* src : {x, y}) {
+        if (std::cmp_less(args.size(), arity)) {
+            args.push_back(builder.CreateAlignedLoad(
+                value_ty, builder.CreateGEP(builder.getFloatTy(), src, i),
+                align));
+        }
+    }
+    llvm::Value* result = builder.CreateCall(callee, args);
+    builder.CreateAlignedStore(
+        result, builder.CreateGEP(builder.getFloatTy(), out, i), align);
+    llvm::Value* next = builder.CreateAdd(i, builder.getInt64(width));
+    i->addIncoming(next, loop_bb);
+    builder.CreateCondBr(builder.CreateICmpSLT(next, n), loop_bb, exit_bb);
+
+    builder.SetInsertPoint(exit_bb);
+    builder.CreateRetVoid();
+}
+
+// Runs the O3 pipeline without the vectorizers, so that every loop keeps
+// the width it was written with.
+void optimize(llvm::Module& module) {
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    llvm::PipelineTuningOptions tuning;
+    tuning.LoopVectorization = false;
+    tuning.SLPVectorization = false;
+    llvm::PassBuilder pb(nullptr, tuning);
+    pb.registerModuleAnalyses(mam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    llvm::ModulePassManager mpm =
+        pb.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+    mpm.run(module, mam);
+}
+
+template <size_t I>
+void libmLoop(const float* x, const float* y, float* out, int64_t n) {
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = OPS[I].libm(x[i], y[i]);
+    }
+}
+
+template <size_t... I>
+constexpr std::array<LoopFn, sizeof...(I)>
+makeLibmLoops(std::index_sequence<I...> /*unused*/) {
+    return {&libmLoop<I>...};
+}
+
+const std::array<LoopFn, OPS.size()> LIBM_LOOPS =
+    makeLibmLoops(std::make_index_sequence<OPS.size()>{});
+
+// Spacing of floats at |reference|.
+double ulpOf(double reference) {
+    const auto magnitude = static_cast<float>(std::fabs(reference));
+    if (magnitude >= std::numeric_limits<float>::max()) {
+        return std::numeric_limits<float>::max() -
+               std::nextafter(std::numeric_limits<float>::max(), 0.0F);
+    }
+    return static_cast<double>(std::nextafter(
+               magnitude, std::numeric_limits<float>::infinity())) -
+           magnitude;
+}
+
+struct ErrorStats {
+    uint64_t count = 0;
+    uint64_t non_finite = 0; // wrong infinities or NaNs
+    double sum_ulp = 0.0;
+    double max_ulp = 0.0;
+    float worst_x = 0.0F;
+    float worst_y = 0.0F;
+    std::array<uint64_t, BUCKET_NAMES.size()> histogram{};
+
+    void add(float x, float y, float value, double reference) {
+        ++count;
+        const auto expected = static_cast<float>(reference);
+        if (!std::isfinite(expected) || !std::isfinite(value)) {
+            if (std::bit_cast<uint32_t>(value) !=
+                std::bit_cast<uint32_t>(expected)) {
+                ++non_finite;
+            } else {
+                ++histogram[0];
+            }
+            return;
+        }
+        const double ulp = std::fabs(value - reference) / ulpOf(reference);
+        sum_ulp += ulp;
+        if (ulp > max_ulp) {
+            max_ulp = ulp;
+            worst_x = x;
+            worst_y = y;
+        }
+        const auto* bucket = std::ranges::lower_bound(BUCKET_LIMITS, ulp);
+        ++histogram[bucket - BUCKET_LIMITS.begin()];
+    }
+};
+
+struct Implementation {
+    std::string name; // approx, llvm or libm
+    int width = 1;
+    LoopFn loop = nullptr;
+    ErrorStats errors;
+    double ns_per_element = 0.0;
+};
+
+struct OpResult {
+    const OpInfo* info = nullptr;
+    uint64_t inputs = 0;
+    uint64_t outside_domain = 0;
+    std::vector<Implementation> implementations;
+};
+
+// Inputs of the error measurements.
+class InputSource {
+  public:
+    virtual ~InputSource() = default;
+    // Fills up to CHUNK_SIZE inputs and returns how many, 0 at the end.
+    virtual size_t next(std::span<float> x, std::span<float> y) = 0;
+};
+
+// Every finite float, in bit pattern order.
+class ExhaustiveSource : public InputSource {
+  public:
+    size_t next(std::span<float> x, std::span<float> /*y*/) override {
+        size_t n = 0;
+        while (n < x.size() && bits <= std::numeric_limits<uint32_t>::max()) {
+            const auto value =
+                std::bit_cast<float>(static_cast<uint32_t>(bits++));
+            if (std::isfinite(value)) {
+                x[n++] = value;
+            }
+        }
+        return n;
+    }
+
+  private:
+    uint64_t bits = 0;
+};
+
+// For each sign and binade of finite floats, `per_binade` mantissas spread
+// evenly over the binade.
+class StratifiedSource : public InputSource {
+  public:
+    explicit StratifiedSource(int per_binade_in)
+        : per_binade(per_binade_in) {}
+
+    size_t next(std::span<float> x, std::span<float> /*y*/) override {
+        constexpr uint32_t MANTISSA_BITS = 23;
+        constexpr uint32_t MAX_EXPONENT = 254; // 255 is infinity and NaN
+        const uint32_t step =
+            std::max<uint32_t>(1, (1U << MANTISSA_BITS) / per_binade);
+        size_t n = 0;
+        while (n < x.size() && sign < 2) {
+            const uint32_t offset =
+                std::uniform_int_distribution<uint32_t>(0, step - 1)(rng);
+            const uint32_t mantissa = std::min(
+                (index * step) + offset, (1U << MANTISSA_BITS) - 1);
+            x[n++] = std::bit_cast<float>((sign << 31U) |
+                                          (exponent << MANTISSA_BITS) |
+                                          mantissa);
+            if (std::cmp_less(++index, per_binade)) {
+                continue;
+            }
+            index = 0;
+            if (++exponent > MAX_EXPONENT) {
+                exponent = 0;
+                ++sign;
+            }
+        }
+        return n;
+    }
+
+  private:
+    int per_binade;
+    uint32_t sign = 0;
+    uint32_t exponent = 0;
+    uint32_t index = 0;
+    std::mt19937 rng{0};
+};
+
+// `count` pairs with the sign, binade and mantissa of each element drawn
+// uniformly, for binary functions.
+class PairSource : public InputSource {
+  public:
+    explicit PairSource(int64_t count) : remaining(count) {}
+
+    size_t next(std::span<float> x, std::span<float> y) override {
+        const auto n = static_cast<size_t>(
+            std::min<int64_t>(remaining, static_cast<int64_t>(x.size())));
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = randomFloat();
+            y[i] = randomFloat();
+        }
+        remaining -= static_cast<int64_t>(n);
+        return n;
+    }
+
+  private:
+    int64_t remaining;
+    std::mt19937 rng{0};
+
+    float randomFloat() {
+        constexpr uint32_t MAX_BITS = 0x7F7FFFFF; // largest finite float
+        const uint32_t magnitude =
+            std::uniform_int_distribution<uint32_t>(0, MAX_BITS)(rng);
+        const uint32_t sign = rng() & 1U;
+        return std::bit_cast<float>((sign << 31U) | magnitude);
+    }
+};
+
+void measureErrors(OpResult& result, InputSource& source) {
+    const OpInfo& info = *result.info;
+    std::vector<float> x(CHUNK_SIZE);
+    std::vector<float> y(CHUNK_SIZE);
+    std::vector<float> out(CHUNK_SIZE);
+    std::vector<double> reference(CHUNK_SIZE);
+
+    while (const size_t n = source.next(x, y)) {
+        // Pad the chunk to a whole number of vectors.
+        std::fill(x.begin() + static_cast<ptrdiff_t>(n), x.end(), x[n - 1]);
+        std::fill(y.begin() + static_cast<ptrdiff_t>(n), y.end(), y[n - 1]);
+        size_t in_domain = 0;
+        for (size_t i = 0; i < n; ++i) {
+            reference[i] = info.reference(x[i], y[i]);
+            in_domain += std::isnan(reference[i]) ? 0 : 1;
+        }
+        result.inputs += in_domain;
+        result.outside_domain += n - in_domain;
+
+        for (auto& impl : result.implementations) {
+            impl.loop(x.data(), y.data(), out.data(),
+                      static_cast<int64_t>(CHUNK_SIZE));
+            for (size_t i = 0; i < n; ++i) {
+                if (!std::isnan(reference[i])) {
+                    impl.errors.add(x[i], y[i], out[i], reference[i]);
+                }
+            }
+        }
+    }
+}
+
+void measureThroughput(OpResult& result, double min_time) {
+    const OpInfo& info = *result.info;
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(info.low, info.high);
+    std::vector<float> x(THROUGHPUT_SIZE);
+    std::vector<float> y(THROUGHPUT_SIZE);
+    std::vector<float> out(THROUGHPUT_SIZE);
+    std::ranges::generate(x, [&] { return dist(rng); });
+    std::ranges::generate(y, [&] { return dist(rng); });
+
+    using Clock = std::chrono::steady_clock;
+    for (auto& impl : result.implementations) {
+        impl.loop(x.data(), y.data(), out.data(), THROUGHPUT_SIZE);
+        int64_t reps = 1;
+        double seconds = 0.0;
+        while (true) {
+            const Clock::time_point start = Clock::now();
+            for (int64_t r = 0; r < reps; ++r) {
+                impl.loop(x.data(), y.data(), out.data(), THROUGHPUT_SIZE);
+            }
+            seconds = std::chrono::duration<double>(Clock::now() - start)
+                          .count();
+            if (seconds >= min_time) {
+                break;
+            }
+            reps *= 2;
+        }
+        impl.ns_per_element =
+            seconds * 1e9 / static_cast<double>(reps * THROUGHPUT_SIZE);
+    }
+}
+
+std::string loopName(const OpInfo& info, const std::string& impl, int width) {
+    return std::format("process_math_bench_{}_{}_v{}", info.name, impl,
+                       width);
+}
+
+// JITs the approximation and intrinsic loops of `ops` at every width, and
+// returns the implementations to measure per op.
+std::vector<OpResult> buildImplementations(
+    const std::vector<const OpInfo*>& ops, const Options& options) {
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = std::make_unique<llvm::Module>("math_bench", *context);
+    OrcJit& jit = global_jit_nan_safe;
+    module->setDataLayout(jit.getDataLayout());
+
+    for (const OpInfo* info : ops) {
+        const int arity = getMathOpInfo(info->op).arity;
+        for (int width : options.widths) {
+            llvm::Function* approx = approxFunction(info->op, width, *module);
+            if (approx == nullptr) {
+                throw std::runtime_error(std::format(
+                    "Failed to generate {} at width {}.", info->name, width));
+            }
+            emitLoop(*module, loopName(*info, "approx", width), approx, arity,
+                     width);
+            emitLoop(*module,
+                     loopName(*info, "llvm", width),
+                     llvm::Intrinsic::getOrInsertDeclaration(
+                         module.get(), info->intrinsic,
+                         {valueType(*context, width)}),
+                     arity, width);
+        }
+    }
+    if (llvm::verifyModule(*module, &llvm::errs())) {
+        throw std::runtime_error("LLVM module verification failed.");
+    }
+    optimize(*module);
+    jit.addModule(std::move(module), std::move(context));
+
+    std::vector<OpResult> results;
+    for (const OpInfo* info : ops) {
+        OpResult& result = results.emplace_back();
+        result.info = info;
+        for (std::string_view impl : {"approx", "llvm"}) {
+            for (int width : options.widths) {
+                void* addr = jit.getFunctionAddress(
+                    loopName(*info, std::string(impl), width));
+                if (addr == nullptr) {
+                    throw std::runtime_error(
+                        "Failed to get JIT'd function address.");
+                }
+                result.implementations.push_back(
+                    {.name = std::string(impl),
+                     .width = width,
+                     .loop = reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                         LoopFn>(addr)});
+            }
+        }
+        result.implementations.push_back(
+            {.name = "libm",
+             .width = 1,
+             .loop = LIBM_LOOPS.at(static_cast<size_t>(info - OPS.data()))});
+    }
+    return results;
+}
+
+void printResult(const OpResult& result) {
+    std::cout << std::format("\n{} ({} inputs, {} outside the domain)\n",
+                             result.info->name, result.inputs,
+                             result.outside_domain);
+    std::string header = std::format("  {:<10} {:>12} {:>10} {:>9}  {:<26}",
+                                     "impl", "max ulp", "avg ulp",
+                                     "ns/elem", "worst input");
+    for (std::string_view bucket : BUCKET_NAMES) {
+        header += std::format(" {:>8}", bucket);
+    }
+    std::cout << header << std::format(" {:>10}\n", "non-finite");
+
+    const bool binary = getMathOpInfo(result.info->op).arity == 2;
+    for (const auto& impl : result.implementations) {
+        const ErrorStats& errors = impl.errors;
+        const uint64_t finite = errors.count - errors.non_finite;
+        const std::string worst =
+            binary ? std::format("{:.6g}, {:.6g}", errors.worst_x,
+                                 errors.worst_y)
+                   : std::format("{:.9g}", errors.worst_x);
+        std::string line = std::format(
+            "  {:<10} {:>12.4g} {:>10.4g} {:>9.3f}  {:<26}",
+            std::format("{} v{}", impl.name, impl.width), errors.max_ulp,
+            finite > 0 ? errors.sum_ulp / static_cast<double>(finite) : 0.0,
+            impl.ns_per_element, worst);
+        for (uint64_t count : errors.histogram) {
+            line += std::format(" {:>7.3f}%",
+                                errors.count > 0
+                                    ? 100.0 * static_cast<double>(count) /
+                                          static_cast<double>(errors.count)
+                                    : 0.0);
+        }
+        std::cout << line << std::format(" {:>10}\n", errors.non_finite);
+    }
+}
+
+llvm::json::Value toJson(const std::vector<OpResult>& results,
+                         const Options& options) {
+    llvm::json::Array ops;
+    for (const auto& result : results) {
+        llvm::json::Array impls;
+        for (const auto& impl : result.implementations) {
+            const ErrorStats& errors = impl.errors;
+            const uint64_t finite = errors.count - errors.non_finite;
+            llvm::json::Object histogram;
+            for (size_t b = 0; b < BUCKET_NAMES.size(); ++b) {
+                histogram[std::string(BUCKET_NAMES[b])] =
+                    static_cast<int64_t>(errors.histogram[b]);
+            }
+            histogram["non_finite"] = static_cast<int64_t>(errors.non_finite);
+            impls.push_back(llvm::json::Object{
+                {"impl", impl.name},
+                {"width", impl.width},
+                {"max_ulp", errors.max_ulp},
+                {"avg_ulp", finite > 0 ? errors.sum_ulp /
+                                             static_cast<double>(finite)
+                                       : 0.0},
+                {"worst_x", errors.worst_x},
+                {"worst_y", errors.worst_y},
+                {"histogram", std::move(histogram)},
+                {"ns_per_element", impl.ns_per_element},
+            });
+        }
+        ops.push_back(llvm::json::Object{
+            {"op", std::string(result.info->name)},
+            {"inputs", static_cast<int64_t>(result.inputs)},
+            {"outside_domain", static_cast<int64_t>(result.outside_domain)},
+            {"impls", std::move(impls)},
+        });
+    }
+    return llvm::json::Object{
+        {"cpu", llvm::sys::getHostCPUName()},
+        {"mode", options.exhaustive ? "exhaustive" : "stratified"},
+        {"ops", std::move(ops)},
+    };
+}
+
+void print_usage() {
+    std::cerr << "Usage: math_bench [options]\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  --ops NAME[,NAME..]  Functions to measure (default: "
+                 "all):\n"
+                 "                      ";
+    for (const auto& info : OPS) {
+        std::cerr << ' ' << info.name;
+    }
+    std::cerr << '\n';
+    std::cerr << "  --widths N[,N..]     Vector widths, among 1, 4, 8 and 16 "
+                 "(default: all)\n";
+    std::cerr << "  --exhaustive         Measure errors on every finite "
+                 "float (unary functions)\n";
+    std::cerr << "  --per-binade N       Inputs per sign and binade "
+                 "otherwise (default: 4096)\n";
+    std::cerr << "  --pairs N            Random inputs of binary functions "
+                 "(default: 4194304)\n";
+    std::cerr << "  --min-time S         Seconds to time each "
+                 "implementation (default: 0.2)\n";
+    std::cerr << "  --json FILE          Write the results as JSON\n";
+}
+
+std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> items;
+    std::istringstream stream{std::string(text)};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    auto args = std::span(argv, argc);
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = args[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        }
+        if (arg == "--exhaustive") {
+            options.exhaustive = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << std::format("Error: {} requires an argument\n",
+                                     std::string(arg));
+            print_usage();
+            return 1;
+        }
+        const std::string_view value = args[++i];
+
+        try {
+            if (arg == "--ops") {
+                options.ops = splitList(value);
+            } else if (arg == "--widths") {
+                options.widths.clear();
+                for (const auto& item : splitList(value)) {
+                    options.widths.push_back(std::stoi(item));
+                }
+            } else if (arg == "--per-binade") {
+                options.per_binade = std::stoi(std::string(value));
+            } else if (arg == "--pairs") {
+                options.pairs = std::stoll(std::string(value));
+            } else if (arg == "--min-time") {
+                options.min_time = std::stod(std::string(value));
+            } else if (arg == "--json") {
+                options.json_path = value;
+            } else {
+                std::cerr << std::format("Error: Unknown option '{}'\n",
+                                         std::string(arg));
+                print_usage();
+                return 1;
+            }
+        } catch (const std::logic_error&) {
+            std::cerr << std::format("Error: Invalid value '{}' for {}\n",
+                                     std::string(value), std::string(arg));
+            return 1;
+        }
+    }
+    if (options.per_binade <= 0 || options.pairs <= 0) {
+        std::cerr << "Error: --per-binade and --pairs must be positive\n";
+        return 1;
+    }
+
+    std::vector<const OpInfo*> ops;
+    for (const auto& info : OPS) {
+        if (options.ops.empty() || std::ranges::contains(options.ops,
+                                                         info.name)) {
+            ops.push_back(&info);
+        }
+    }
+    if (ops.size() != (options.ops.empty() ? OPS.size() : options.ops.size())) {
+        std::cerr << "Error: Unknown function in --ops\n";
+        print_usage();
+        return 1;
+    }
+
+    try {
+        std::vector<OpResult> results = buildImplementations(ops, options);
+        std::cout << std::format("CPU: {}, {} inputs\n",
+                                 llvm::sys::getHostCPUName().str(),
+                                 options.exhaustive ? "exhaustive"
+                                                    : "stratified");
+        for (auto& result : results) {
+            std::unique_ptr<InputSource> source;
+            if (getMathOpInfo(result.info->op).arity == 2) {
+                source = std::make_unique<PairSource>(options.pairs);
+            } else if (options.exhaustive) {
+                source = std::make_unique<ExhaustiveSource>();
+            } else {
+                source = std::make_unique<StratifiedSource>(options.per_binade);
+            }
+            measureErrors(result, *source);
+            measureThroughput(result, options.min_time);
+            printResult(result);
+        }
+
+        if (!options.json_path.empty()) {
+            std::error_code ec;
+            llvm::raw_fd_ostream stream(options.json_path, ec);
+            if (ec) {
+                throw std::runtime_error(
+                    std::format("Cannot open '{}': {}", options.json_path,
+                                ec.message()));
+            }
+            stream << llvm::formatv("{0:2}", toJson(results, options))
+                   << '\n';
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("Error: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
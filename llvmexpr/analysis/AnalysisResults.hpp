@@ -24,6 +24,13 @@
 #include "passes/BlockAnalysisPass.hpp"
 #include "passes/BuildCFGPass.hpp"
 #include "passes/CoordinateUsagePass.hpp"
+#include "passes/IntegralUsagePass.hpp"
+#include "passes/OutputUsagePass.hpp"
+#include "passes/PatchDistanceUsagePass.hpp"
+#include "passes/PixelDependencePass.hpp"
+#include "passes/PlaneReadUsagePass.hpp"
+#include "passes/PlaneStatUsagePass.hpp"
+#include "passes/ReductionUsagePass.hpp"
 #include "passes/RelAccessAnalysisPass.hpp"
 #include "passes/StackSafetyPass.hpp"
 #include "passes/VariableUsagePass.hpp"
@@ -64,6 +71,35 @@ class ExpressionAnalysisResults {
         return manager.getResult<VariableUsagePass>();
     }
 
+    [[nodiscard]] const IntegralUsageResult& getIntegralUsageResult() const {
+        return manager.getResult<IntegralUsagePass>();
+    }
+
+    [[nodiscard]] const PatchDistanceUsageResult&
+    getPatchDistanceUsageResult() const {
+        return manager.getResult<PatchDistanceUsagePass>();
+    }
+
+    [[nodiscard]] const PlaneReadUsageResult& getPlaneReadUsageResult() const {
+        return manager.getResult<PlaneReadUsagePass>();
+    }
+
+    [[nodiscard]] const OutputUsageResult& getOutputUsageResult() const {
+        return manager.getResult<OutputUsagePass>();
+    }
+
+    [[nodiscard]] const ReductionUsageResult& getReductionUsageResult() const {
+        return manager.getResult<ReductionUsagePass>();
+    }
+
+    [[nodiscard]] const PlaneStatUsageResult& getPlaneStatUsageResult() const {
+        return manager.getResult<PlaneStatUsagePass>();
+    }
+
+    [[nodiscard]] const PixelDependenceResult& getPixelDependenceResult() const {
+        return manager.getResult<PixelDependencePass>();
+    }
+
     [[nodiscard]] const AnalysisManager& getManager() const { return manager; }
 
   private:
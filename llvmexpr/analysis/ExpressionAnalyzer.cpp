@@ -22,7 +22,14 @@
 #include "llvmexpr/analysis/passes/StackSafetyPass.hpp"
 #include "llvmexpr/analysis/passes/ValidationPass.hpp"
 #include "passes/CoordinateUsagePass.hpp"
+#include "passes/IntegralUsagePass.hpp"
+#include "passes/OutputUsagePass.hpp"
+#include "passes/PatchDistanceUsagePass.hpp"
+#include "passes/PixelDependencePass.hpp"
+#include "passes/PlaneReadUsagePass.hpp"
+#include "passes/PlaneStatUsagePass.hpp"
 #include "passes/PropWriteTypeSafetyPass.hpp"
+#include "passes/ReductionUsagePass.hpp"
 #include "passes/RelAccessAnalysisPass.hpp"
 #include "passes/VariableUsagePass.hpp"
 
@@ -39,6 +46,13 @@ void ExpressionAnalyzer::analyze() {
     manager.getResult<StackSafetyPass>();
     manager.getResult<RelAccessAnalysisPass>();
     manager.getResult<CoordinateUsagePass>();
+    manager.getResult<IntegralUsagePass>();
+    manager.getResult<PatchDistanceUsagePass>();
+    manager.getResult<PlaneReadUsagePass>();
+    manager.getResult<OutputUsagePass>();
+    manager.getResult<ReductionUsagePass>();
+    manager.getResult<PlaneStatUsagePass>();
+    manager.getResult<PixelDependencePass>();
     manager.getResult<VariableUsagePass>();
     manager.getResult<PropWriteTypeSafetyPass>();
 }
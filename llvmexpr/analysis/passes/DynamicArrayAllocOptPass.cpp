@@ -52,6 +52,11 @@ bool isArrayUsedInRange(const std::string& array_name,
             if (payload.name == array_name) {
                 return true;
             }
+        } else if (token.type == TokenType::PLANE_HISTOGRAM) {
+            if (std::get<TokenPayload_PlaneStat>(token.payload).array_name ==
+                array_name) {
+                return true;
+            }
         }
     }
     return false;
@@ -0,0 +1,69 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_INTEGRALUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_INTEGRALUSAGEPASS_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct IntegralUsageResult {
+    // Sorted, unique (clip_idx, plane_idx) pairs. plane_idx is -1 for the
+    // current plane in Expr mode.
+    std::vector<std::pair<int, int>> planes;
+
+    // Index of the integral table for (clip_idx, plane_idx), i.e. its slot
+    // after the regular plane pointers. Returns -1 if it is not used.
+    [[nodiscard]] int slotOf(int clip_idx, int plane_idx) const {
+        for (size_t i = 0; i < planes.size(); ++i) {
+            if (planes[i].first == clip_idx && planes[i].second == plane_idx) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+    Collects the clip planes whose integral image (summed-area table) is read
+    by box sum tokens.
+    Collects:
+    - The sorted list of unique (clip, plane) pairs used by box sum tokens.
+    The host computes one integral table per entry for every frame and passes
+    them to the JIT function after the regular plane pointers, in this order.
+    Depends on: None
+ */
+class IntegralUsagePass
+    : public AnalysisPass<IntegralUsagePass, IntegralUsageResult> {
+  public:
+    IntegralUsageResult run(const std::vector<Token>& tokens,
+                            AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "IntegralUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_INTEGRALUSAGEPASS_HPP
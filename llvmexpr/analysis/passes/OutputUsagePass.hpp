@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_OUTPUTUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_OUTPUTUSAGEPASS_HPP
+
+#include <vector>
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct OutputUsageResult {
+    // Sorted, unique indices (>= 1) of the extra outputs written with @N.
+    std::vector<int> outputs;
+
+    // Index of the destination pointer for output `output_idx`, i.e. its slot
+    // after the plane reads. Returns -1 if it is not written.
+    [[nodiscard]] int slotOf(int output_idx) const {
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (outputs[i] == output_idx) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+    Collects the extra outputs written by an Expr mode expression.
+    Collects:
+    - The sorted list of unique output indices used by STORE_OUTPUT.
+    The host passes one destination pointer per entry to the JIT function
+    after the plane reads, in this order.
+    Depends on: None
+ */
+class OutputUsagePass
+    : public AnalysisPass<OutputUsagePass, OutputUsageResult> {
+  public:
+    OutputUsageResult run(const std::vector<Token>& tokens,
+                          AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "OutputUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_OUTPUTUSAGEPASS_HPP
@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_PATCHDISTANCEUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_PATCHDISTANCEUSAGEPASS_HPP
+
+#include <compare>
+#include <vector>
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct PatchDistanceKey {
+    int clip_idx;
+    int dx;
+    int dy;
+    int radius;
+
+    auto operator<=>(const PatchDistanceKey&) const = default;
+};
+
+struct PatchDistanceUsageResult {
+    // Sorted, unique patch distance planes read by the expression.
+    std::vector<PatchDistanceKey> patches;
+
+    // Index of the distance plane for `key` among the patch distance slots.
+    // Returns -1 if it is not used.
+    [[nodiscard]] int slotOf(const PatchDistanceKey& key) const {
+        for (size_t i = 0; i < patches.size(); ++i) {
+            if (patches[i] == key) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+    Collects the patch distance planes read by patch distance tokens.
+    Collects:
+    - The sorted list of unique (clip, dx, dy, radius) tuples.
+    The host computes one distance plane per entry for every frame and passes
+    them to the JIT function after the integral tables, in this order.
+    Depends on: None
+ */
+class PatchDistanceUsagePass
+    : public AnalysisPass<PatchDistanceUsagePass, PatchDistanceUsageResult> {
+  public:
+    PatchDistanceUsageResult run(const std::vector<Token>& tokens,
+                                 AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "PatchDistanceUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_PATCHDISTANCEUSAGEPASS_HPP
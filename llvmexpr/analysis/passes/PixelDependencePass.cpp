@@ -0,0 +1,186 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelDependencePass.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../frontend/Tokenizer.hpp"
+#include "../framework/AnalysisManager.hpp"
+#include "StackSafetyPass.hpp"
+
+namespace analysis {
+
+namespace {
+
+// Tokens whose value or effect differs from pixel to pixel.
+bool depends_on_pixel(TokenType type) {
+    switch (type) {
+    case TokenType::CONSTANT_X:
+    case TokenType::CONSTANT_Y:
+    case TokenType::CLIP_REL:
+    case TokenType::CLIP_ABS:
+    case TokenType::CLIP_CUR:
+    case TokenType::CLIP_ABS_PLANE:
+    case TokenType::CLIP_REL_PLANE:
+    case TokenType::CLIP_BOX_REL:
+    case TokenType::CLIP_BOX_ABS:
+    case TokenType::CLIP_BOX_ABS_PLANE:
+    case TokenType::CLIP_PATCH_DIST:
+    case TokenType::CLIP_INTERP_REL:
+    case TokenType::CLIP_INTERP_ABS:
+    case TokenType::STORE_ABS_PLANE:
+    case TokenType::PROP_REDUCE:
+    case TokenType::EXIT_NO_WRITE:
+    case TokenType::STORE_ABS:
+    case TokenType::STORE_OUTPUT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// A value on the stack of a straight-line expression: a literal, the
+// current pixel of a clip, or anything else.
+struct SymbolicValue {
+    enum class Kind : std::uint8_t { OTHER, NUMBER, CLIP };
+    Kind kind = Kind::OTHER;
+    double number = 0.0;
+    int clip_idx = -1;
+
+    [[nodiscard]] bool is(double value) const {
+        return kind == Kind::NUMBER && number == value;
+    }
+};
+
+// Follows the expression symbolically and returns the clip its result is an
+// unchanged copy of, or -1. Only stack and variable operations and binary
+// operations with their identity element are followed; anything else, and
+// any control flow, gives up.
+int find_identity_clip(const std::vector<Token>& tokens) {
+    std::vector<SymbolicValue> stack;
+    std::map<std::string, SymbolicValue> vars;
+    auto pop = [&stack] {
+        SymbolicValue value = stack.back();
+        stack.pop_back();
+        return value;
+    };
+
+    for (const auto& token : tokens) {
+        switch (token.type) {
+        case TokenType::NUMBER:
+            stack.push_back(
+                {.kind = SymbolicValue::Kind::NUMBER,
+                 .number =
+                     std::get<TokenPayload_Number>(token.payload).value});
+            break;
+        case TokenType::CLIP_CUR:
+        case TokenType::CLIP_REL: {
+            const auto& payload =
+                std::get<TokenPayload_ClipAccess>(token.payload);
+            if (payload.rel_x != 0 || payload.rel_y != 0 ||
+                payload.rel_t != 0) {
+                return -1;
+            }
+            stack.push_back({.kind = SymbolicValue::Kind::CLIP,
+                             .clip_idx = payload.clip_idx});
+            break;
+        }
+        case TokenType::VAR_STORE:
+            vars[std::get<TokenPayload_Var>(token.payload).name] = pop();
+            break;
+        case TokenType::VAR_LOAD: {
+            auto it = vars.find(std::get<TokenPayload_Var>(token.payload).name);
+            stack.push_back(it != vars.end() ? it->second : SymbolicValue{});
+            break;
+        }
+        case TokenType::DUP: {
+            const int n = std::get<TokenPayload_StackOp>(token.payload).n;
+            stack.push_back(stack[stack.size() - 1 - n]);
+            break;
+        }
+        case TokenType::DROP: {
+            const int n = std::get<TokenPayload_StackOp>(token.payload).n;
+            stack.resize(stack.size() - n);
+            break;
+        }
+        case TokenType::SWAP: {
+            const int n = std::get<TokenPayload_StackOp>(token.payload).n;
+            std::swap(stack.back(), stack[stack.size() - 1 - n]);
+            break;
+        }
+        // x + 0 only differs from x in the sign of a zero, which the kernel
+        // does not keep either (it is compiled with no-signed-zeros).
+        case TokenType::ADD:
+        case TokenType::SUB:
+        case TokenType::MUL:
+        case TokenType::DIV: {
+            const SymbolicValue rhs = pop();
+            const SymbolicValue lhs = pop();
+            const double identity =
+                token.type == TokenType::ADD || token.type == TokenType::SUB
+                    ? 0.0
+                    : 1.0;
+            const bool commutative = token.type == TokenType::ADD ||
+                                     token.type == TokenType::MUL;
+            if (rhs.is(identity)) {
+                stack.push_back(lhs);
+            } else if (commutative && lhs.is(identity)) {
+                stack.push_back(rhs);
+            } else {
+                stack.emplace_back();
+            }
+            break;
+        }
+        default:
+            return -1;
+        }
+    }
+
+    if (stack.size() != 1 || stack.back().kind != SymbolicValue::Kind::CLIP) {
+        return -1;
+    }
+    return stack.back().clip_idx;
+}
+
+} // namespace
+
+PixelDependenceResult
+PixelDependencePass::run(const std::vector<Token>& tokens,
+                         AnalysisManager& am) {
+    // The symbolic stack relies on the depths checked there.
+    am.getResult<StackSafetyPass>();
+
+    PixelDependenceResult result;
+    result.identity_clip = find_identity_clip(tokens);
+    result.frame_constant = !tokens.empty();
+    for (const auto& token : tokens) {
+        if (depends_on_pixel(token.type)) {
+            result.frame_constant = false;
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace analysis
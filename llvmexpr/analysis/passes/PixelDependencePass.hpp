@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_PIXELDEPENDENCEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_PIXELDEPENDENCEPASS_HPP
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct PixelDependenceResult {
+    // Clip whose current pixel is the result, unchanged, if the expression
+    // is only a copy of one input plane (`x`, `y 0 +`, `z a! a@`, ...).
+    // -1 otherwise.
+    int identity_clip = -1;
+    // The result is the same for every pixel of a frame: it depends only on
+    // constants, N and frame properties, and the expression has no effect
+    // besides its value.
+    bool frame_constant = false;
+};
+
+/**
+    Classifies how an Expr mode expression depends on the pixel it computes.
+    Collects:
+    - The clip the expression copies, if it is a plain copy of one.
+    - Whether the expression is constant within a frame.
+    The host uses this to copy or fill such planes instead of running a
+    per-pixel kernel over them.
+    Depends on: StackSafetyPass
+ */
+class PixelDependencePass
+    : public AnalysisPass<PixelDependencePass, PixelDependenceResult> {
+  public:
+    PixelDependenceResult run(const std::vector<Token>& tokens,
+                              AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "PixelDependencePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_PIXELDEPENDENCEPASS_HPP
@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_PLANEREADUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_PLANEREADUSAGEPASS_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct PlaneReadUsageResult {
+    // Sorted, unique (clip_idx, plane_idx) pairs.
+    std::vector<std::pair<int, int>> planes;
+
+    // Index of the plane pointer for (clip_idx, plane_idx), i.e. its slot
+    // after the patch distance planes. Returns -1 if it is not used.
+    [[nodiscard]] int slotOf(int clip_idx, int plane_idx) const {
+        for (size_t i = 0; i < planes.size(); ++i) {
+            if (planes[i].first == clip_idx && planes[i].second == plane_idx) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+    Collects the clip planes read by plane-qualified pixel access tokens in
+    Expr mode.
+    Collects:
+    - The sorted list of unique (clip, plane) pairs used by CLIP_REL_PLANE.
+    The host passes one plane pointer per entry to the JIT function after the
+    patch distance planes, in this order.
+    Depends on: None
+ */
+class PlaneReadUsagePass
+    : public AnalysisPass<PlaneReadUsagePass, PlaneReadUsageResult> {
+  public:
+    PlaneReadUsageResult run(const std::vector<Token>& tokens,
+                             AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "PlaneReadUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_PLANEREADUSAGEPASS_HPP
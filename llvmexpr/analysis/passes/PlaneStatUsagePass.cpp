@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PlaneStatUsagePass.hpp"
+
+#include <set>
+
+#include "../../frontend/Tokenizer.hpp"
+#include "../framework/AnalysisManager.hpp"
+
+namespace analysis {
+
+PlaneStatUsageResult
+PlaneStatUsagePass::run(const std::vector<Token>& tokens,
+                        [[maybe_unused]] AnalysisManager& am) {
+    std::set<std::pair<int, int>> used;
+    for (const auto& token : tokens) {
+        if (token.type != TokenType::PLANE_STAT) {
+            continue;
+        }
+        const auto& payload = std::get<TokenPayload_PlaneStat>(token.payload);
+        if (payload.kind != PlaneStatKind::COUNT) {
+            used.emplace(payload.clip_idx, payload.plane_idx);
+        }
+    }
+
+    PlaneStatUsageResult result;
+    result.planes.assign(used.begin(), used.end());
+    return result;
+}
+
+} // namespace analysis
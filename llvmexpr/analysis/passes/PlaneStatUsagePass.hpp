@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_PLANESTATUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_PLANESTATUSAGEPASS_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct PlaneStatUsageResult {
+    // Sorted, unique (clip_idx, plane_idx) pairs whose sum, mean, minimum or
+    // maximum is read.
+    std::vector<std::pair<int, int>> planes;
+};
+
+/**
+    Collects the clip planes whose statistics are read by SingleExpr
+    plane statistic tokens (src^plane.sum, .mean, .min, .max).
+    Collects:
+    - The sorted list of unique (clip, plane) pairs used by those tokens.
+    The JIT function computes the statistics of every entry in a single loop
+    over the plane at its start, so they are available on every path.
+    .count and .hist take operands and are computed where they are used.
+    Depends on: None
+ */
+class PlaneStatUsagePass
+    : public AnalysisPass<PlaneStatUsagePass, PlaneStatUsageResult> {
+  public:
+    PlaneStatUsageResult run(const std::vector<Token>& tokens,
+                             AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "PlaneStatUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_PLANESTATUSAGEPASS_HPP
@@ -0,0 +1,56 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ReductionUsagePass.hpp"
+
+#include <format>
+
+#include "../../utils/EnumName.hpp"
+#include "../framework/AnalysisError.hpp"
+#include "../framework/AnalysisManager.hpp"
+
+namespace analysis {
+
+ReductionUsageResult
+ReductionUsagePass::run(const std::vector<Token>& tokens,
+                        [[maybe_unused]] AnalysisManager& am) {
+    ReductionUsageResult result;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].type != TokenType::PROP_REDUCE) {
+            continue;
+        }
+        const auto& payload =
+            std::get<TokenPayload_PropReduce>(tokens[i].payload);
+        const int slot = result.slotOf(payload.prop_name);
+        if (slot < 0) {
+            result.reductions.push_back(
+                {.prop_name = payload.prop_name, .kind = payload.kind});
+        } else if (result.reductions[slot].kind != payload.kind) {
+            throw AnalysisError(
+                std::format("Property '{}' is reduced as both {} and {}.",
+                            payload.prop_name,
+                            enum_name(result.reductions[slot].kind),
+                            enum_name(payload.kind)),
+                static_cast<int>(i));
+        }
+    }
+    return result;
+}
+
+} // namespace analysis
@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_ANALYSIS_PASSES_REDUCTIONUSAGEPASS_HPP
+#define LLVMEXPR_ANALYSIS_PASSES_REDUCTIONUSAGEPASS_HPP
+
+#include <string>
+#include <vector>
+
+#include "../../frontend/Tokenizer.hpp"
+#include "../framework/Pass.hpp"
+
+namespace analysis {
+
+struct Reduction {
+    std::string prop_name;
+    ReduceKind kind;
+};
+
+struct ReductionUsageResult {
+    // Reductions accumulated by the expression, in order of first use.
+    std::vector<Reduction> reductions;
+
+    // Index of the reduction writing `prop_name`, i.e. its entry in the
+    // result array. Returns -1 if there is none.
+    [[nodiscard]] int slotOf(const std::string& prop_name) const {
+        for (size_t i = 0; i < reductions.size(); ++i) {
+            if (reductions[i].prop_name == prop_name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+    Collects the reductions (prop$sum, prop$min, prop$max, prop$count)
+    accumulated by an Expr mode expression.
+    Collects:
+    - The list of reductions, one per property, in order of first use.
+    The host passes a pointer to one double per entry to the JIT function
+    after the extra outputs, where the kernel stores the reduced values.
+    Throws if a property is reduced in more than one way.
+    Depends on: None
+ */
+class ReductionUsagePass
+    : public AnalysisPass<ReductionUsagePass, ReductionUsageResult> {
+  public:
+    ReductionUsageResult run(const std::vector<Token>& tokens,
+                             AnalysisManager& am) override;
+
+    [[nodiscard]] const char* getName() const override {
+        return "ReductionUsagePass";
+    }
+};
+
+} // namespace analysis
+
+#endif // LLVMEXPR_ANALYSIS_PASSES_REDUCTIONUSAGEPASS_HPP
@@ -19,6 +19,7 @@
 
 #include "RelAccessAnalysisPass.hpp"
 #include "../../frontend/Tokenizer.hpp"
+#include "../../utils/Interpolation.hpp"
 #include "../framework/AnalysisManager.hpp"
 #include <set>
 
@@ -46,6 +47,27 @@ RelAccessAnalysisPass::run(const std::vector<Token>& tokens,
             }
             result.min_rel_x = std::min(result.min_rel_x, payload.rel_x);
             result.max_rel_x = std::max(result.max_rel_x, payload.rel_x);
+        } else if (token.type == TokenType::CLIP_INTERP_REL) {
+            // Constant sub-pixel offsets are read through their integer taps.
+            const auto& payload =
+                std::get<TokenPayload_ClipInterp>(token.payload);
+            bool use_mirror =
+                payload.has_mode ? payload.use_mirror : result.mirror_boundary;
+            for (const auto& [rel_y, weight_y] :
+                 interpolationTaps(payload.kind, payload.rel_y)) {
+                RelYAccess access{.clip_idx = payload.clip_idx,
+                                  .rel_y = rel_y,
+                                  .use_mirror = use_mirror};
+                if (!seen.contains(access)) {
+                    seen.insert(access);
+                    result.unique_rel_y_accesses.push_back(access);
+                }
+            }
+            for (const auto& [rel_x, weight_x] :
+                 interpolationTaps(payload.kind, payload.rel_x)) {
+                result.min_rel_x = std::min(result.min_rel_x, rel_x);
+                result.max_rel_x = std::max(result.max_rel_x, rel_x);
+            }
         } else if (token.type == TokenType::CLIP_CUR) {
             const auto& payload =
                 std::get<TokenPayload_ClipAccess>(token.payload);
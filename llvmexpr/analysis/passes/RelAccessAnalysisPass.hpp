@@ -33,7 +33,8 @@ struct RelAccessAnalysisResult {
 };
 
 /**
-    Analyzes the expression to identify all relative clip accesses.
+    Analyzes the expression to identify all relative clip accesses, including
+    the integer taps of interpolated accesses at constant offsets.
     Collects:
     - All unique relative y-accesses and their mirroring modes.
     - The minimum and maximum relative x-accesses across the expression.
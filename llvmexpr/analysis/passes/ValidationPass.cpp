@@ -70,6 +70,16 @@ ValidationPass::Result ValidationPass::run(const std::vector<Token>& tokens,
                         std::format("Array is uninitialized: {}", payload.name),
                         j);
                 }
+            } else if (token.type == TokenType::PLANE_HISTOGRAM) {
+                const auto& payload =
+                    std::get<TokenPayload_PlaneStat>(token.payload);
+                if (!defined_in_block.contains(
+                        var_naming::getArrayName(payload.array_name))) {
+                    throw AnalysisError(
+                        std::format("Array is uninitialized: {}",
+                                    payload.array_name),
+                        j);
+                }
             } else if (token.type == TokenType::ARRAY_ALLOC_STATIC ||
                        token.type == TokenType::ARRAY_ALLOC_DYN) {
                 const auto& payload =
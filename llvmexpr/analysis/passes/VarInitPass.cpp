@@ -103,6 +103,10 @@ VarInitPass::Result VarInitPass::run(const std::vector<Token>& tokens,
             const auto& array_name =
                 std::get<TokenPayload_ArrayOp>(token.payload).name;
             all_vars.insert(var_naming::getArrayName(array_name));
+        } else if (token.type == TokenType::PLANE_HISTOGRAM) {
+            const auto& array_name =
+                std::get<TokenPayload_PlaneStat>(token.payload).array_name;
+            all_vars.insert(var_naming::getArrayName(array_name));
         }
     }
 
@@ -0,0 +1,214 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Chains.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <memory>
+
+#include "../utils/CpuInfo.hpp"
+#include "Expr.hpp"
+#include "FilterCommon.hpp"
+#include "FilterData.hpp"
+#include "Stats.hpp"
+
+namespace {
+
+// Per-thread scratch planes of multi-pass Chain bands.
+thread_local std::vector<std::vector<float>>
+    g_scratch_planes; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+constexpr int SCRATCH_ALIGN = 64; // whole cache lines
+
+int scratchStride(int width) {
+    return (width * static_cast<int>(sizeof(float)) + SCRATCH_ALIGN - 1) /
+           SCRATCH_ALIGN * SCRATCH_ALIGN;
+}
+
+// Rows per band of a multi-pass Chain on `plane`: band_rows if given,
+// otherwise as many as keep the plane's scratch rows within half of L2.
+int chainBandRows(const ExprData* d, int plane, int height,
+                  int scratch_stride) {
+    int band = d->band_rows;
+    if (band <= 0) {
+        constexpr int MIN_BAND_ROWS = 16;
+        int num_planes = 0;
+        int halo_rows = 0;
+        for (const auto& pass : d->scratch_passes) {
+            if (pass->plane_op.at(plane) == PlaneOp::PO_PROCESS) {
+                ++num_planes;
+                halo_rows += 2 * pass->halo_rows.at(plane);
+            }
+        }
+        const auto budget_rows =
+            static_cast<int>(getL2CacheSize() / 2 / scratch_stride);
+        band = std::max((budget_rows - halo_rows) / std::max(num_planes, 1),
+                        MIN_BAND_ROWS);
+    }
+    return std::min(band, height);
+}
+
+} // namespace
+
+double runChainPasses(ExprData* d, int n,
+                      const std::vector<const VSFrame*>& src_frames,
+                      VSFrame* dst_frame,
+                      const std::vector<VSFrame*>& extra_frames,
+                      ReductionTotals& reductions, const VSAPI* vsapi) {
+    std::vector<ExprData*> passes;
+    for (const auto& pass : d->scratch_passes) {
+        passes.push_back(pass.get());
+    }
+    passes.push_back(d);
+
+    std::vector<std::vector<float>> props;
+    for (const ExprData* pass : passes) {
+        props.emplace_back(1 + pass->required_props.size());
+        readFrameProperties(props.back(), src_frames, pass->required_props, n,
+                            vsapi);
+    }
+
+    if (g_scratch_planes.size() < d->scratch_passes.size()) {
+        g_scratch_planes.resize(d->scratch_passes.size());
+    }
+
+    std::vector<uint8_t*> rwptrs;
+    std::vector<int> strides;
+    double seconds = 0.0;
+    for (const auto& kernel_planes : d->kernels) {
+        const int plane = kernel_planes.front();
+        const int width = vsapi->getFrameWidth(dst_frame, plane);
+        const int height = vsapi->getFrameHeight(dst_frame, plane);
+        for (ExprData* pass : passes) {
+            if (pass->plane_op.at(plane) == PlaneOp::PO_PROCESS) {
+                compileKernel(pass, {plane}, width, height, vsapi);
+            }
+        }
+        const KernelTimer timer(d);
+
+        const int scratch_stride = scratchStride(width);
+        const int band = chainBandRows(d, plane, height, scratch_stride);
+        // Only the last pass can reduce, and it computes each row once.
+        std::vector<double> reduction_results(d->reductions.at(plane).size());
+
+        // Scratch planes not computed for this plane are never read by it.
+        std::vector<std::pair<uint8_t*, int>> scratch(d->num_scratch,
+                                                      {nullptr, 0});
+        std::vector<uint8_t*> buffers(d->num_scratch, nullptr);
+        // First row of the band held by each scratch buffer.
+        std::vector<int> first_rows(d->num_scratch, 0);
+        for (int q = 0; q < d->num_scratch; ++q) {
+            if (passes[q]->plane_op.at(plane) != PlaneOp::PO_PROCESS) {
+                continue;
+            }
+            const size_t bytes =
+                static_cast<size_t>(std::min(
+                    band + 2 * passes[q]->halo_rows.at(plane), height)) *
+                scratch_stride;
+            auto& buffer = g_scratch_planes[q];
+            buffer.resize((bytes + SCRATCH_ALIGN) / sizeof(float));
+            void* data = buffer.data();
+            size_t space = buffer.size() * sizeof(float);
+            buffers[q] = static_cast<uint8_t*>(
+                std::align(SCRATCH_ALIGN, bytes, data, space));
+        }
+
+        for (int y0 = 0; y0 < height; y0 += band) {
+            const int y1 = std::min(y0 + band, height);
+            for (size_t q = 0; q < passes.size(); ++q) {
+                ExprData* pass = passes[q];
+                if (pass->plane_op.at(plane) != PlaneOp::PO_PROCESS) {
+                    continue;
+                }
+                const int halo = pass->halo_rows.at(plane);
+                std::array<int32_t, 2> rows = {std::max(y0 - halo, 0),
+                                               std::min(y1 + halo, height)};
+
+                // The kernel indexes the scratch planes from rows[0]. A
+                // pass only reads planes whose halo covers its own, so their
+                // bands start at or above rows[0]; others get no pointer.
+                for (size_t s = 0; s < q; ++s) {
+                    scratch[s] = {nullptr, scratch_stride};
+                    if (buffers[s] != nullptr && first_rows[s] <= rows[0]) {
+                        scratch[s].first =
+                            buffers[s] +
+                            static_cast<std::ptrdiff_t>(rows[0] -
+                                                        first_rows[s]) *
+                                scratch_stride;
+                    }
+                }
+
+                uint8_t* dst = nullptr;
+                int dst_stride = 0;
+                if (pass == d) {
+                    dst = vsapi->getWritePtr(dst_frame, plane);
+                    dst_stride =
+                        static_cast<int>(vsapi->getStride(dst_frame, plane));
+                } else {
+                    dst = buffers[q];
+                    dst_stride = scratch_stride;
+                    first_rows[q] = rows[0];
+                }
+
+                rwptrs.clear();
+                strides.clear();
+                appendKernelArgs(pass, plane, dst, dst_stride, src_frames,
+                                 scratch, extra_frames,
+                                 reduction_results.data(), rwptrs, strides,
+                                 vsapi);
+                pass->compiled.at(plane).func_ptr(rows.data(), rwptrs.data(),
+                                                  strides.data(),
+                                                  props[q].data());
+                if (pass == d) {
+                    accumulateReductions(d->reductions.at(plane),
+                                         reduction_results, reductions);
+                }
+            }
+        }
+        seconds += recordKernel(d, kernel_planes, timer);
+    }
+    return seconds;
+}
+
+void computeChainHalos(ExprData* d) {
+    for (int plane = 0; plane < d->vi.format.numPlanes; ++plane) {
+        for (int q = d->num_scratch - 1; q >= 0; --q) {
+            int halo = 0;
+            for (int p = q + 1; p <= d->num_scratch; ++p) {
+                const ExprData* reader =
+                    p < d->num_scratch ? d->scratch_passes[p].get() : d;
+                for (const auto& token : reader->tokens.at(plane)) {
+                    if (token.type != TokenType::CLIP_CUR &&
+                        token.type != TokenType::CLIP_REL) {
+                        continue;
+                    }
+                    const auto& payload =
+                        std::get<TokenPayload_ClipAccess>(token.payload);
+                    if (payload.clip_idx == d->num_inputs + q) {
+                        halo = std::max(halo, reader->halo_rows.at(plane) +
+                                                  std::abs(payload.rel_y));
+                    }
+                }
+            }
+            d->scratch_passes[q]->halo_rows.at(plane) = halo;
+        }
+    }
+}
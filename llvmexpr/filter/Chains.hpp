@@ -0,0 +1,49 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_CHAINS_HPP
+#define LLVMEXPR_FILTER_CHAINS_HPP
+
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "Reductions.hpp"
+
+struct ExprData;
+
+// Runs a multi-pass Chain. Each plane is computed in bands of rows: for every
+// band the scratch passes compute the rows of their plane that later passes
+// read into a buffer only a band (plus halo) high, then the last pass writes
+// the band. Halo rows are computed again for the neighbouring band, which
+// keeps the scratch planes small enough to stay cached between passes.
+// Returns the time spent in kernels, in seconds.
+double runChainPasses(ExprData* d, int n,
+                      const std::vector<const VSFrame*>& src_frames,
+                      VSFrame* dst_frame,
+                      const std::vector<VSFrame*>& extra_frames,
+                      ReductionTotals& reductions, const VSAPI* vsapi);
+
+// Sets the rows each scratch pass of a multi-pass Chain computes above and
+// below a band: enough for the later passes to read it at their offsets over
+// every row they compute themselves. Boundary handling at the plane edges
+// reads rows within the same distance, so one halo serves both sides.
+void computeChainHalos(ExprData* d);
+
+#endif // LLVMEXPR_FILTER_CHAINS_HPP
@@ -0,0 +1,942 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Expr.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "../analysis/AnalysisResults.hpp"
+#include "../analysis/ExpressionAnalyzer.hpp"
+#include "../frontend/InfixConverter.hpp"
+#include "../frontend/StageFusion.hpp"
+#include "../jit/Compiler.hpp"
+#include "../jit/Jit.hpp"
+#include "../utils/KernelReport.hpp"
+#include "../utils/Trace.hpp"
+#include "Chains.hpp"
+#include "FilterCommon.hpp"
+#include "FilterData.hpp"
+#include "Masks.hpp"
+#include "MultiOutput.hpp"
+#include "PatchDistance.hpp"
+#include "Reductions.hpp"
+#include "Stats.hpp"
+#include "TileCache.hpp"
+
+namespace {
+
+// Points every temporal access (clip[x,y,t] with t != 0) at an extra input
+// that follows the clips, adding it to `temporal_inputs` on first use. The
+// kernel then reads frame n + t of the clip through that input like any other.
+void resolveTemporalAccesses(std::vector<Token>& tokens, int num_inputs,
+                             std::vector<std::pair<int, int>>& temporal_inputs) {
+    for (auto& token : tokens) {
+        if (token.type != TokenType::CLIP_REL) {
+            continue;
+        }
+        auto& payload = std::get<TokenPayload_ClipAccess>(token.payload);
+        if (payload.rel_t == 0) {
+            continue;
+        }
+        const std::pair<int, int> key{payload.clip_idx, payload.rel_t};
+        auto it = std::ranges::find(temporal_inputs, key);
+        if (it == temporal_inputs.end()) {
+            temporal_inputs.push_back(key);
+            it = std::prev(temporal_inputs.end());
+        }
+        payload.clip_idx =
+            num_inputs +
+            static_cast<int>(std::distance(temporal_inputs.begin(), it));
+        payload.rel_t = 0;
+    }
+}
+
+// Frame of `node` at n + offset, clamped to the clip.
+int temporalFrameNumber(int n, int offset, VSNode* node, const VSAPI* vsapi) {
+    return std::clamp(n + offset, 0,
+                      vsapi->getVideoInfo(node)->numFrames - 1);
+}
+
+} // namespace
+
+void appendKernelArgs(const ExprData* d, int plane, uint8_t* dst,
+                      int dst_stride,
+                      const std::vector<const VSFrame*>& src_frames,
+                      const std::vector<std::pair<uint8_t*, int>>& scratch,
+                      const std::vector<VSFrame*>& extra_frames,
+                      double* reduction_results, std::vector<uint8_t*>& rwptrs,
+                      std::vector<int>& strides, const VSAPI* vsapi) {
+    const size_t base = rwptrs.size();
+    rwptrs.push_back(dst);
+    strides.push_back(dst_stride);
+
+    auto push_source = [&](const VSFrame* frame) {
+        rwptrs.push_back(
+            const_cast< // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                uint8_t*>(vsapi->getReadPtr(frame, plane)));
+        strides.push_back(static_cast<int>(vsapi->getStride(frame, plane)));
+    };
+    for (int i = 0; i < d->num_inputs; ++i) {
+        push_source(src_frames[i]);
+    }
+    for (const auto& [ptr, stride] : scratch) {
+        rwptrs.push_back(ptr);
+        strides.push_back(stride);
+    }
+    for (auto i = static_cast<size_t>(d->num_inputs); i < src_frames.size();
+         ++i) {
+        push_source(src_frames[i]);
+    }
+    const size_t num_sources = src_frames.size() + scratch.size();
+
+    if (!d->integral_planes.at(plane).empty()) {
+        prepareIntegralTables(rwptrs, strides, base + num_sources + 1,
+                              d->integral_planes.at(plane), plane, src_frames,
+                              d->nodes, vsapi);
+    }
+    if (!d->patch_distances.at(plane).empty()) {
+        preparePatchDistanceTables(
+            rwptrs, strides,
+            base + num_sources + 1 + d->integral_planes.at(plane).size(),
+            d->patch_distances.at(plane), plane, src_frames, d->nodes, vsapi);
+    }
+    for (const auto& [clip_idx, plane_idx] : d->plane_reads.at(plane)) {
+        rwptrs.push_back(
+            const_cast< // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                uint8_t*>(vsapi->getReadPtr(src_frames[clip_idx], plane_idx)));
+        strides.push_back(static_cast<int>(
+            vsapi->getStride(src_frames[clip_idx], plane_idx)));
+    }
+    for (int k : d->extra_outputs.at(plane)) {
+        rwptrs.push_back(vsapi->getWritePtr(extra_frames[k - 1], plane));
+        strides.push_back(
+            static_cast<int>(vsapi->getStride(extra_frames[k - 1], plane)));
+    }
+    if (!d->reductions.at(plane).empty()) {
+        rwptrs.push_back(reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                         uint8_t*>(reduction_results));
+        strides.push_back(0);
+    }
+}
+
+bool compileKernel(ExprData* d, const std::vector<int>& kernel_planes,
+                   int width, int height, const VSAPI* vsapi,
+                   bool mask_zero) {
+    auto& compiled = mask_zero ? d->mask_zero_compiled : d->compiled;
+    const auto& tokens = mask_zero ? d->mask_zero_tokens : d->tokens;
+    const auto& managers =
+        mask_zero ? d->mask_zero_managers : d->analysis_managers;
+    const int plane = kernel_planes.front();
+    if (compiled.at(plane).func_ptr != nullptr) {
+        return false;
+    }
+
+    // A frame-constant plane only computes its first row, a plane reading
+    // patch distances one band of rows and a masked plane one run of tiles
+    // per call.
+    LoopOptions loop_options = d->loop_options;
+    if (d->plane_op.at(plane) == PlaneOp::PO_FILL ||
+        !d->patch_distances.at(plane).empty()) {
+        loop_options.row_range = true;
+    }
+    if (d->plane_op.at(plane) == PlaneOp::PO_MASKED ||
+        d->plane_op.at(plane) == PlaneOp::PO_CACHED) {
+        loop_options.row_range = true;
+        loop_options.column_range = true;
+    }
+
+    std::vector<const VSVideoInfo*> vi(d->num_inputs);
+    for (int i = 0; i < d->num_inputs; ++i) {
+        vi[i] = vsapi->getVideoInfo(d->nodes[i]);
+    }
+    vi.insert(vi.end(), d->num_scratch, &d->scratch_vi);
+    for (const auto& [clip_idx, offset] : d->temporal_inputs) {
+        vi.push_back(vi[clip_idx]);
+    }
+
+    std::string expr_str;
+    for (const auto& [clip_idx, offset] : d->temporal_inputs) {
+        expr_str += std::format("|temporal| {}:{} ", clip_idx, offset);
+    }
+    for (int kernel_plane : kernel_planes) {
+        if (kernel_plane != plane) {
+            expr_str += " |fused| ";
+        }
+        bool first = true;
+        for (const auto& token : tokens.at(kernel_plane)) {
+            if (!first) {
+                expr_str += " ";
+            }
+            expr_str += token.text;
+            first = false;
+        }
+    }
+
+    const std::string key =
+        generate_cache_key(expr_str, &d->vi, vsapi, vi, d->mirror_boundary,
+                           d->prop_map, width, height, d->opt_level,
+                           d->approx_math, loop_options);
+
+    std::unique_lock<std::mutex> lock(cache_mutex);
+    double compile_seconds = 0.0;
+    KernelReport report;
+    const bool miss = !jit_cache.contains(key);
+    if (!miss) {
+        ++jit_cache_counters.hits;
+    } else {
+        ++jit_cache_counters.misses;
+        const auto compile_start = std::chrono::steady_clock::now();
+        size_t key_hash = std::hash<std::string>{}(key);
+        std::string func_name =
+            kernelName(d->stats->filter, plane, tokens.at(plane), key_hash);
+
+        const TraceTarget trace_target(d->trace_file);
+        analysis::ExpressionAnalysisResults results(*managers.at(plane));
+        Compiler compiler(std::vector<Token>(tokens.at(plane)), &d->vi, vi,
+                          width, height, d->mirror_boundary, d->dump_ir_path,
+                          d->prop_map, func_name, d->opt_level,
+                          d->approx_math, loop_options, results);
+        for (size_t k = 1; k < kernel_planes.size(); ++k) {
+            compiler.add_fused_plane(
+                tokens.at(kernel_planes[k]),
+                analysis::ExpressionAnalysisResults(
+                    *managers.at(kernel_planes[k])));
+        }
+        if (jitDebugEnabled() && !d->sources.at(plane).empty()) {
+            std::vector<std::string> source_paths;
+            for (int kernel_plane : kernel_planes) {
+                source_paths.push_back(writeDebugSource(
+                    std::format("{}.{}", func_name, kernel_plane),
+                    d->sources.at(kernel_plane)));
+            }
+            compiler.set_debug_sources(std::move(source_paths));
+        }
+        if (!d->report_path.empty()) {
+            compiler.set_report(&report);
+        }
+        jit_cache[key] = compiler.compile();
+        compile_seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - compile_start)
+                              .count();
+        jit_cache_counters.compile_seconds += compile_seconds;
+    }
+    compiled.at(plane) = jit_cache.at(key);
+    d->stats->planes.at(plane).recordCompile(compile_seconds,
+                                             compiled.at(plane).approx_math);
+    lock.unlock();
+
+    // llvm-mca runs without the lock, so it does not hold up other instances.
+    if (miss && !d->report_path.empty()) {
+        estimateThroughput(report);
+        appendKernelReport(d->report_path, report);
+    }
+    return miss;
+}
+
+namespace {
+
+const VSFrame*
+    VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+    exprGetFrame(int n, int activationReason, void* instanceData,
+                 [[maybe_unused]] void** frameData, VSFrameContext* frameCtx,
+                 VSCore* core, const VSAPI* vsapi) {
+    auto* d = static_cast<ExprData*>(instanceData);
+
+    if (activationReason == arInitial) {
+        for (int i = 0; i < d->num_inputs; ++i) {
+            vsapi->requestFrameFilter(n, d->nodes[i], frameCtx);
+        }
+        for (const auto& [clip_idx, offset] : d->temporal_inputs) {
+            vsapi->requestFrameFilter(
+                temporalFrameNumber(n, offset, d->nodes[clip_idx], vsapi),
+                d->nodes[clip_idx], frameCtx);
+        }
+    } else if (activationReason == arAllFramesReady) {
+        // The clips, then the frames read by temporal accesses.
+        std::vector<const VSFrame*> src_frames(d->num_inputs);
+        for (int i = 0; i < d->num_inputs; ++i) {
+            src_frames[i] = vsapi->getFrameFilter(n, d->nodes[i], frameCtx);
+        }
+        for (const auto& [clip_idx, offset] : d->temporal_inputs) {
+            src_frames.push_back(vsapi->getFrameFilter(
+                temporalFrameNumber(n, offset, d->nodes[clip_idx], vsapi),
+                d->nodes[clip_idx], frameCtx));
+        }
+        std::array<const VSFrame*, 3> plane_src = {};
+        for (int plane = 0; plane < 3; ++plane) {
+            if (d->plane_op.at(plane) == PlaneOp::PO_COPY) {
+                plane_src.at(plane) = src_frames[d->copy_clip.at(plane)];
+            }
+        }
+        std::array<int, 3> planes = {0, 1, 2};
+        VSFrame* dst_frame = vsapi->newVideoFrame2(
+            &d->vi.format, d->vi.width, d->vi.height, plane_src.data(),
+            planes.data(), src_frames[0], core);
+
+        std::vector<VSFrame*> extra_frames =
+            newExtraOutputFrames(d, src_frames, core, vsapi);
+
+        ReductionTotals reductions;
+        int64_t cache_tiles = 0;
+        int64_t cache_hits = 0;
+        double frame_seconds = 0.0;
+        try {
+            if (d->scratch_passes.empty()) {
+                std::vector<uint8_t*> rwptrs;
+                std::vector<int> strides;
+                std::vector<float> props(1 + d->required_props.size());
+                readFrameProperties(props, src_frames, d->required_props, n,
+                                    vsapi);
+                std::array<std::vector<double>, 3> reduction_results;
+
+                for (const auto& kernel_planes : d->kernels) {
+                    // One block of rwptrs/strides per plane computed by the
+                    // kernel.
+                    rwptrs.clear();
+                    strides.clear();
+                    for (int plane : kernel_planes) {
+                        reduction_results.at(plane).resize(
+                            d->reductions.at(plane).size());
+                        appendKernelArgs(
+                            d, plane, vsapi->getWritePtr(dst_frame, plane),
+                            static_cast<int>(
+                                vsapi->getStride(dst_frame, plane)),
+                            src_frames, {}, extra_frames,
+                            reduction_results.at(plane).data(), rwptrs,
+                            strides, vsapi);
+                    }
+
+                    const int plane = kernel_planes.front();
+                    const PlaneOp op = d->plane_op.at(plane);
+                    compileKernel(d, kernel_planes,
+                                  vsapi->getFrameWidth(dst_frame, plane),
+                                  vsapi->getFrameHeight(dst_frame, plane),
+                                  vsapi);
+                    if (op == PlaneOp::PO_MASKED) {
+                        compileKernel(d, kernel_planes,
+                                      vsapi->getFrameWidth(dst_frame, plane),
+                                      vsapi->getFrameHeight(dst_frame, plane),
+                                      vsapi, true);
+                    }
+
+                    const KernelTimer timer(d);
+                    if (op == PlaneOp::PO_CACHED) {
+                        runCachedPlane(d, plane, src_frames, dst_frame,
+                                       rwptrs.data(), strides.data(), props,
+                                       cache_tiles, cache_hits, vsapi);
+                    } else if (!d->patch_distances.at(plane).empty()) {
+                        runPatchDistancePlane(
+                            d, plane, src_frames, dst_frame, rwptrs, strides,
+                            props.data(), reduction_results.at(plane),
+                            reductions, vsapi);
+                    } else if (op == PlaneOp::PO_MASKED) {
+                        runMaskedPlane(d, plane, src_frames[d->mask_clip], 0,
+                                       vsapi->getFrameHeight(dst_frame, plane),
+                                       rwptrs.data(), strides.data(),
+                                       props.data(),
+                                       reduction_results.at(plane),
+                                       reductions, vsapi);
+                    } else {
+                        if (op == PlaneOp::PO_FILL) {
+                            std::array<int32_t, 2> first_row = {0, 1};
+                            d->compiled.at(plane).func_ptr(
+                                first_row.data(), rwptrs.data(),
+                                strides.data(), props.data());
+                            fillFromFirstRow(dst_frame, plane, vsapi);
+                        } else {
+                            d->compiled.at(plane).func_ptr(
+                                nullptr, rwptrs.data(), strides.data(),
+                                props.data());
+                        }
+                        for (int kernel_plane : kernel_planes) {
+                            accumulateReductions(
+                                d->reductions.at(kernel_plane),
+                                reduction_results.at(kernel_plane),
+                                reductions);
+                        }
+                    }
+                    frame_seconds +=
+                        recordKernel(d, kernel_planes, timer);
+                }
+            } else {
+                frame_seconds += runChainPasses(d, n, src_frames, dst_frame,
+                                                extra_frames, reductions,
+                                                vsapi);
+            }
+        } catch (...) {
+            for (const auto& frame : src_frames) {
+                vsapi->freeFrame(frame);
+            }
+            for (auto* frame : extra_frames) {
+                vsapi->freeFrame(frame);
+            }
+            vsapi->freeFrame(dst_frame);
+            throw;
+        }
+
+        for (const auto& frame : src_frames) {
+            vsapi->freeFrame(frame);
+        }
+        writeReductions(reductions, dst_frame, vsapi);
+        ++d->stats->frames;
+        if (cache_tiles > 0) {
+            d->stats->cache_tiles += cache_tiles;
+            d->stats->cache_hits += cache_hits;
+            VSMap* props = vsapi->getFramePropertiesRW(dst_frame);
+            vsapi->mapSetInt(props, CACHE_HITS_PROP, cache_hits, maReplace);
+            vsapi->mapSetInt(props, CACHE_TILES_PROP, cache_tiles, maReplace);
+        }
+        if (d->stats_mode >= 1) {
+            vsapi->mapSetFloat(vsapi->getFramePropertiesRW(dst_frame),
+                               FRAME_TIME_PROP, frame_seconds, maReplace);
+        }
+        attachExtraOutputs(extra_frames, dst_frame, vsapi);
+        return dst_frame;
+    }
+
+    return nullptr;
+}
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+exprFree(void* instanceData, [[maybe_unused]] VSCore* core,
+         const VSAPI* vsapi) {
+    genericFree<ExprData>(instanceData, core, vsapi);
+}
+
+// Tokenizes and analyses the expression of each plane of `d`, which may read
+// the clips and scratch planes. Temporal accesses are added to
+// `temporal_inputs`, shared by all passes of a multi-pass Chain.
+// `source_lines`, if given, holds the infix source line of each token.
+void initExprPlanes(
+    ExprData* d, const std::array<std::string, 3>& expr_strs,
+    std::vector<std::pair<int, int>>& temporal_inputs, const VSAPI* vsapi,
+    const std::array<std::vector<int>, 3>* source_lines = nullptr) {
+    const int num_clips = d->num_inputs + d->num_scratch;
+    for (int i = 0; i < d->vi.format.numPlanes; ++i) {
+        if (expr_strs.at(i).empty()) {
+            d->plane_op.at(i) = PlaneOp::PO_COPY;
+            continue;
+        }
+        d->plane_op.at(i) = PlaneOp::PO_PROCESS;
+        {
+            const TraceScope trace("frontend", "tokenize");
+            d->tokens.at(i) =
+                tokenize(expr_strs.at(i), num_clips, ExprMode::EXPR);
+        }
+        if (source_lines != nullptr) {
+            applySourceLines(d->tokens.at(i), source_lines->at(i));
+        }
+        resolveTemporalAccesses(d->tokens.at(i), num_clips, temporal_inputs);
+
+        for (const auto& token : d->tokens.at(i)) {
+            if (token.type == TokenType::PROP_ACCESS ||
+                token.type == TokenType::PROP_EXISTS) {
+                const auto& payload =
+                    std::get<TokenPayload_PropAccess>(token.payload);
+                auto key = std::make_pair(payload.clip_idx, payload.prop_name);
+                if (!d->prop_map.contains(key)) {
+                    d->prop_map[key] = static_cast<int>(
+                        1 + d->required_props
+                                .size()); // 0 is for frame number N
+                    d->required_props.push_back(key);
+                }
+            }
+        }
+
+        auto analyser = std::make_unique<analysis::AnalysisManager>(
+            d->tokens.at(i), d->mirror_boundary);
+        {
+            const TraceScope trace("frontend", "analyze");
+            analysis::ExpressionAnalyzer expr_analyzer(*analyser);
+            expr_analyzer.analyze();
+        }
+
+        d->integral_planes.at(i) =
+            analyser->getResult<analysis::IntegralUsagePass>().planes;
+        for (const auto& [clip_idx, plane_idx] : d->integral_planes.at(i)) {
+            const VSVideoInfo* input_vi =
+                vsapi->getVideoInfo(d->nodes[clip_idx]);
+            if (input_vi->format.subSamplingW != d->vi.format.subSamplingW ||
+                input_vi->format.subSamplingH != d->vi.format.subSamplingH) {
+                throw std::runtime_error(std::format(
+                    "Box sum access requires clip {} to have the same "
+                    "subsampling as the output.",
+                    clip_idx));
+            }
+        }
+
+        d->patch_distances.at(i) =
+            analyser->getResult<analysis::PatchDistanceUsagePass>().patches;
+        for (const auto& patch : d->patch_distances.at(i)) {
+            const VSVideoInfo* input_vi =
+                vsapi->getVideoInfo(d->nodes[patch.clip_idx]);
+            if (input_vi->format.subSamplingW != d->vi.format.subSamplingW ||
+                input_vi->format.subSamplingH != d->vi.format.subSamplingH) {
+                throw std::runtime_error(std::format(
+                    "Patch distance access requires clip {} to have the "
+                    "same subsampling as the output.",
+                    patch.clip_idx));
+            }
+        }
+
+        if (d->num_scratch > 0 && (!d->integral_planes.at(i).empty() ||
+                                   !d->patch_distances.at(i).empty())) {
+            throw std::runtime_error(
+                "Box sums and patch distances are not supported in a chain "
+                "whose stages are read at an offset.");
+        }
+
+        d->plane_reads.at(i) =
+            analyser->getResult<analysis::PlaneReadUsagePass>().planes;
+        for (const auto& [clip_idx, plane_idx] : d->plane_reads.at(i)) {
+            const VSVideoInfo* input_vi =
+                vsapi->getVideoInfo(d->nodes[clip_idx]);
+            if (plane_idx >= input_vi->format.numPlanes) {
+                throw std::runtime_error(std::format(
+                    "Plane access: clip {} has no plane {}.", clip_idx,
+                    plane_idx));
+            }
+        }
+
+        d->extra_outputs.at(i) =
+            analyser->getResult<analysis::OutputUsagePass>().outputs;
+        if (!d->extra_outputs.at(i).empty()) {
+            d->num_outputs =
+                std::max(d->num_outputs, d->extra_outputs.at(i).back() + 1);
+        }
+
+        d->reductions.at(i) =
+            analyser->getResult<analysis::ReductionUsagePass>().reductions;
+        for (const auto& reduction : d->reductions.at(i)) {
+            for (int j = 0; j < i; ++j) {
+                for (const auto& other : d->reductions.at(j)) {
+                    if (other.prop_name == reduction.prop_name &&
+                        other.kind != reduction.kind) {
+                        throw std::runtime_error(std::format(
+                            "Property '{}' is reduced in different ways on "
+                            "planes {} and {}.",
+                            reduction.prop_name, j, i));
+                    }
+                }
+            }
+        }
+
+        // Planes copying an input plane unchanged, or constant within a
+        // frame, skip the per-pixel kernel. Passes of a multi-pass Chain
+        // always run theirs band by band.
+        const auto& dependence =
+            analyser->getResult<analysis::PixelDependencePass>();
+        const int copy_clip = dependence.identity_clip;
+        if (d->num_scratch == 0 && copy_clip >= 0 &&
+            copy_clip < d->num_inputs) {
+            if (canCopyPlane(vsapi->getVideoInfo(d->nodes[copy_clip])->format,
+                             d->vi.format, i)) {
+                d->plane_op.at(i) = PlaneOp::PO_COPY;
+                d->copy_clip.at(i) = copy_clip;
+            }
+        }
+        if (d->num_scratch == 0 && dependence.frame_constant) {
+            d->plane_op.at(i) = PlaneOp::PO_FILL;
+        }
+
+        d->analysis_managers.at(i) = std::move(analyser);
+    }
+}
+
+} // namespace
+
+int accessedClip(const Token& token) {
+    if (const auto* p = std::get_if<TokenPayload_ClipAccess>(&token.payload)) {
+        return p->clip_idx;
+    }
+    if (const auto* p =
+            std::get_if<TokenPayload_ClipAccessPlane>(&token.payload)) {
+        return p->clip_idx;
+    }
+    if (const auto* p =
+            std::get_if<TokenPayload_ClipRelPlane>(&token.payload)) {
+        return p->clip_idx;
+    }
+    if (const auto* p = std::get_if<TokenPayload_ClipBox>(&token.payload)) {
+        return p->clip_idx;
+    }
+    if (const auto* p = std::get_if<TokenPayload_PatchDist>(&token.payload)) {
+        return p->clip_idx;
+    }
+    if (const auto* p = std::get_if<TokenPayload_ClipInterp>(&token.payload)) {
+        return p->clip_idx;
+    }
+    return -1;
+}
+
+namespace {
+
+// Estimates the bytes each plane of `d` reads and writes per pixel: one
+// sample of every input clip its passes access, and one per output.
+void estimateTraffic(ExprData* d, const VSAPI* vsapi) {
+    const int clip_end = d->num_inputs + d->num_scratch;
+    for (int plane = 0; plane < d->vi.format.numPlanes; ++plane) {
+        std::set<int> clips;
+        auto collect = [&](const ExprData* pass) {
+            for (const auto& token : pass->tokens.at(plane)) {
+                const int clip_idx = accessedClip(token);
+                if (clip_idx < d->num_inputs) {
+                    clips.insert(clip_idx);
+                } else if (clip_idx >= clip_end) {
+                    clips.insert(
+                        d->temporal_inputs.at(clip_idx - clip_end).first);
+                }
+            }
+        };
+        for (const auto& pass : d->scratch_passes) {
+            collect(pass.get());
+        }
+        collect(d);
+        clips.erase(-1);
+
+        int read_bytes = 0;
+        for (int clip_idx : clips) {
+            read_bytes +=
+                vsapi->getVideoInfo(d->nodes[clip_idx])->format.bytesPerSample;
+        }
+        d->read_bytes_per_pixel.at(plane) = read_bytes;
+        d->write_bytes_per_pixel.at(plane) =
+            d->vi.format.bytesPerSample *
+            static_cast<int>(1 + d->extra_outputs.at(plane).size());
+    }
+}
+
+// Assigns the planes of `d` to kernels.
+void groupKernels(ExprData* d) {
+    // Planes of equal size share one kernel when fusion is requested.
+    // Planes using box sums or patch distances keep their own kernel, as
+    // their per-frame tables are prepared one plane at a time, and so do
+    // frame-constant, masked and cached planes, which compute part of the
+    // plane per call.
+    std::map<std::pair<int, int>, size_t> fused_kernel_by_size;
+    for (int i = 0; i < d->vi.format.numPlanes; ++i) {
+        if (d->plane_op.at(i) == PlaneOp::PO_COPY) {
+            continue;
+        }
+        if (d->fuse_planes && d->plane_op.at(i) == PlaneOp::PO_PROCESS &&
+            d->integral_planes.at(i).empty() &&
+            d->patch_distances.at(i).empty()) {
+            // Plane size as a log2 reduction relative to plane 0
+            const std::pair<int, int> size =
+                i == 0 ? std::make_pair(0, 0)
+                       : std::make_pair(d->vi.format.subSamplingW,
+                                        d->vi.format.subSamplingH);
+            auto [it, inserted] =
+                fused_kernel_by_size.try_emplace(size, d->kernels.size());
+            if (!inserted) {
+                d->kernels.at(it->second).push_back(i);
+                continue;
+            }
+        }
+        d->kernels.push_back({i});
+    }
+}
+
+} // namespace
+
+void initExprFilter(ExprData* d, const VSMap* in, VSCore* core,
+                    const VSAPI* vsapi, bool chain) {
+    const char* filter_name = chain ? "Chain" : "Expr";
+    int err = 0;
+
+    validateAndInitClips<true>(d, in, vsapi);
+    parseFormatParam(d, in, vsapi, core);
+    parseTraceParam(d, in, vsapi);
+    const TraceTarget trace_target(d->trace_file);
+    const TraceScope trace("create", filter_name);
+
+    d->mirror_boundary = vsapi->mapGetInt(in, "boundary", 0, &err) != 0;
+
+    const char* expr_key = chain ? "stages" : "expr";
+    const int nexpr = vsapi->mapNumElements(in, expr_key);
+    if (nexpr == 0) {
+        throw std::runtime_error(
+            chain ? "At least one stage must be provided."
+                  : "At least one expression must be provided.");
+    }
+
+    bool use_infix = vsapi->mapGetInt(in, "infix", 0, &err) != 0;
+
+    // Converts an infix expression of `plane` that may read clips
+    // 0..num_clips-1.
+    auto to_postfix = [&](const std::string& input_expr, int plane,
+                          int num_clips,
+                          std::vector<int>* token_lines = nullptr) {
+        std::map<std::string, std::string> macros;
+        macros["__EXPR__"] = "";
+        macros["__WIDTH__"] = std::to_string(d->vi.width);
+        macros["__HEIGHT__"] = std::to_string(d->vi.height);
+        macros["__INPUT_NUM__"] = std::to_string(d->num_inputs);
+        macros["__OUTPUT_BITDEPTH__"] =
+            std::to_string(d->vi.format.bitsPerSample);
+        macros["__OUTPUT_COLORFAMILY__"] =
+            std::to_string(d->vi.format.colorFamily);
+        macros["__SUBSAMPLE_W__"] =
+            std::to_string(d->vi.format.subSamplingW);
+        macros["__SUBSAMPLE_H__"] =
+            std::to_string(d->vi.format.subSamplingH);
+        macros["__PLANE_NO__"] = std::to_string(plane);
+        macros["__OUTPUT_SAMPLETYPE__"] = std::to_string(
+            (d->vi.format.sampleType == stFloat) ? 1 : 0);
+
+        for (int j = 0; j < d->num_inputs; ++j) {
+            const VSVideoInfo* input_vi =
+                vsapi->getVideoInfo(d->nodes[j]);
+            macros[std::format("__INPUT_BITDEPTH_{}__", j)] =
+                std::to_string(input_vi->format.bitsPerSample);
+            macros[std::format("__INPUT_COLORFAMILY_{}__", j)] =
+                std::to_string(input_vi->format.colorFamily);
+            macros[std::format("__INPUT_SAMPLETYPE_{}__", j)] =
+                std::to_string(
+                    (input_vi->format.sampleType == stFloat) ? 1 : 0);
+        }
+
+        return convertInfixToPostfix(input_expr, num_clips,
+                                     infix2postfix::Mode::Expr, &macros,
+                                     token_lines);
+    };
+
+    std::array<std::string, 3> expr_strs;
+    // Infix source line of each token of expr_strs, empty for postfix.
+    std::array<std::vector<int>, 3> source_lines;
+    // Expressions of the scratch passes of a multi-pass Chain, per plane.
+    std::vector<std::array<std::string, 3>> scratch_strs;
+    if (chain) {
+        // Stage k reads earlier stage j as clip num_inputs + j.
+        for (int i = 0; i < d->vi.format.numPlanes; ++i) {
+            std::vector<std::string> stages;
+            for (int k = 0; k < nexpr; ++k) {
+                std::string stage =
+                    vsapi->mapGetData(in, "stages", k, &err);
+                stages.push_back(
+                    use_infix ? to_postfix(stage, i, d->num_inputs + k)
+                              : stage);
+            }
+            std::vector<std::string> passes =
+                fuseStages(stages, d->num_inputs);
+            expr_strs.at(i) = passes.back();
+            passes.pop_back();
+            if (scratch_strs.size() < passes.size()) {
+                scratch_strs.resize(passes.size());
+            }
+            for (size_t q = 0; q < passes.size(); ++q) {
+                scratch_strs[q].at(i) = passes[q];
+            }
+        }
+    } else {
+        for (int i = 0; i < nexpr; ++i) {
+            std::string input_expr =
+                vsapi->mapGetData(in, "expr", i, &err);
+            expr_strs.at(i) = use_infix && !input_expr.empty()
+                                  ? to_postfix(input_expr, i,
+                                               d->num_inputs,
+                                               &source_lines.at(i))
+                                  : input_expr;
+            d->sources.at(i) = input_expr;
+        }
+        for (int i = nexpr; i < d->vi.format.numPlanes; ++i) {
+            expr_strs.at(i) = expr_strs.at(nexpr - 1);
+            source_lines.at(i) = source_lines.at(nexpr - 1);
+            d->sources.at(i) = d->sources.at(nexpr - 1);
+        }
+    }
+
+    if (!scratch_strs.empty()) {
+        d->num_scratch = static_cast<int>(scratch_strs.size());
+        d->scratch_vi = d->vi;
+        if (vsapi->queryVideoFormat(&d->scratch_vi.format,
+                                    d->vi.format.colorFamily, stFloat, 32,
+                                    d->vi.format.subSamplingW,
+                                    d->vi.format.subSamplingH,
+                                    core) == 0) {
+            throw std::runtime_error("Failed to query scratch format.");
+        }
+        for (const auto& pass_strs : scratch_strs) {
+            auto pass = std::make_unique<ExprData>();
+            pass->nodes = d->nodes;
+            pass->num_inputs = d->num_inputs;
+            pass->vi = d->scratch_vi;
+            pass->mirror_boundary = d->mirror_boundary;
+            pass->num_scratch = d->num_scratch;
+            pass->scratch_vi = d->scratch_vi;
+            pass->stats = d->stats;
+            pass->trace_file = d->trace_file;
+            initExprPlanes(pass.get(), pass_strs, d->temporal_inputs,
+                           vsapi);
+            d->scratch_passes.push_back(std::move(pass));
+        }
+    }
+    initExprPlanes(d, expr_strs, d->temporal_inputs, vsapi,
+                   &source_lines);
+
+    parseCommonParams(d, in, vsapi);
+
+    d->loop_options.tile_width =
+        static_cast<int>(vsapi->mapGetInt(in, "tile_width", 0, &err));
+    if (err != 0) {
+        d->loop_options.tile_width = -1; // Default to auto mode
+    }
+    if (d->loop_options.tile_width < -1) {
+        throw std::runtime_error(
+            "tile_width must be -1 (auto), 0 (disabled), or positive.");
+    }
+
+    d->loop_options.row_block =
+        static_cast<int>(vsapi->mapGetInt(in, "row_block", 0, &err));
+    if (err != 0) {
+        d->loop_options.row_block = 1;
+    }
+    if (d->loop_options.row_block != 1 && d->loop_options.row_block != 2 &&
+        d->loop_options.row_block != 4) {
+        throw std::runtime_error("row_block must be 1, 2, or 4.");
+    }
+
+    d->fuse_planes = vsapi->mapGetInt(in, "fuse_planes", 0, &err) != 0;
+
+    if (!chain) {
+        d->mask_clip =
+            static_cast<int>(vsapi->mapGetInt(in, "mask", 0, &err));
+        if (err != 0) {
+            d->mask_clip = -1;
+        }
+        if (d->mask_clip < -1 || d->mask_clip >= d->num_inputs) {
+            throw std::runtime_error(std::format(
+                "mask must be -1 (disabled) or a clip index below {}.",
+                d->num_inputs));
+        }
+        if (d->mask_clip >= 0) {
+            initMaskedPlanes(d, vsapi);
+        }
+        if (vsapi->mapGetInt(in, "tile_cache", 0, &err) != 0) {
+            initCachedPlanes(d);
+        }
+    }
+
+    if (chain) {
+        d->band_rows =
+            static_cast<int>(vsapi->mapGetInt(in, "band_rows", 0, &err));
+        if (err != 0) {
+            d->band_rows = -1; // Default to auto mode
+        }
+        if (d->band_rows == 0 || d->band_rows < -1) {
+            throw std::runtime_error(
+                "band_rows must be -1 (auto) or positive.");
+        }
+    }
+
+    // Passes of a multi-pass Chain run a plane at a time, band by band, and
+    // index the scratch planes from the first row of each call.
+    if (!d->scratch_passes.empty()) {
+        d->fuse_planes = false;
+        d->loop_options.row_range = true;
+        d->loop_options.band_clip_begin = d->num_inputs;
+        d->loop_options.band_clip_end = d->num_inputs + d->num_scratch;
+        for (auto& pass : d->scratch_passes) {
+            pass->dump_ir_path = d->dump_ir_path;
+            pass->report_path = d->report_path;
+            pass->opt_level = d->opt_level;
+            pass->approx_math = d->approx_math;
+            pass->loop_options = d->loop_options;
+            pass->loop_options.band_dst = true;
+            pass->temporal_inputs = d->temporal_inputs;
+            groupKernels(pass.get());
+        }
+        computeChainHalos(d);
+    }
+
+    groupKernels(d);
+    estimateTraffic(d, vsapi);
+}
+
+namespace {
+
+void createExprFilter(const VSMap* in, VSMap* out, VSCore* core,
+                      const VSAPI* vsapi, bool chain) {
+    const char* filter_name = chain ? "Chain" : "Expr";
+    auto d = std::make_unique<ExprData>();
+    try {
+        initExprFilter(d.get(), in, core, vsapi, chain);
+    } catch (const std::exception& e) {
+        for (auto* node : d->nodes) {
+            if (node != nullptr) {
+                vsapi->freeNode(node);
+            }
+        }
+        vsapi->mapSetError(
+            out, std::format("{}: {}", filter_name, e.what()).c_str());
+        return;
+    }
+
+    // Temporal accesses request frames other than n.
+    const VSRequestPattern request_pattern =
+        d->temporal_inputs.empty() ? rpStrictSpatial : rpGeneral;
+    std::vector<VSFilterDependency> deps;
+    deps.reserve(d->nodes.size());
+    for (auto* node : d->nodes) {
+        deps.push_back({node, request_pattern});
+    }
+
+    VSVideoInfo* vi_ptr = &d->vi;
+    registerStats(d.get(), filter_name, d->vi.format.numPlanes);
+
+    if (d->num_outputs == 1) {
+        vsapi->createVideoFilter(out, filter_name, vi_ptr, exprGetFrame,
+                                 exprFree, fmParallel, deps.data(),
+                                 static_cast<int>(deps.size()), d.release(),
+                                 core);
+        return;
+    }
+
+    // One node computes every output per frame.
+    const int num_outputs = d->num_outputs;
+    VSNode* shared = vsapi->createVideoFilter2(
+        filter_name, vi_ptr, exprGetFrame, exprFree, fmParallel, deps.data(),
+        static_cast<int>(deps.size()), d.release(), core);
+    createOutputClips(shared, num_outputs, out, core, vsapi);
+}
+
+} // namespace
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+exprCreate(const VSMap* in, VSMap* out, [[maybe_unused]] void* userData,
+           VSCore* core, const VSAPI* vsapi) {
+    createExprFilter(in, out, core, vsapi, false);
+}
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+chainCreate(const VSMap* in, VSMap* out, [[maybe_unused]] void* userData,
+            VSCore* core, const VSAPI* vsapi) {
+    createExprFilter(in, out, core, vsapi, true);
+}
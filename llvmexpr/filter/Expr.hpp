@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_EXPR_HPP
+#define LLVMEXPR_FILTER_EXPR_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../frontend/Tokenizer.hpp"
+
+struct ExprData;
+
+// Appends the rwptrs/strides block of `plane` for a kernel of `d` writing to
+// `dst`: the destination, the clips, the scratch planes, the frames read by
+// temporal accesses, then the per-frame tables, plane reads, extra outputs
+// and the array receiving the plane's reductions.
+void appendKernelArgs(const ExprData* d, int plane, uint8_t* dst,
+                      int dst_stride,
+                      const std::vector<const VSFrame*>& src_frames,
+                      const std::vector<std::pair<uint8_t*, int>>& scratch,
+                      const std::vector<VSFrame*>& extra_frames,
+                      double* reduction_results, std::vector<uint8_t*>& rwptrs,
+                      std::vector<int>& strides, const VSAPI* vsapi);
+
+// Compiles the kernel of `d` computing `kernel_planes`, unless that was done
+// already, and stores it at the index of the first plane. With `mask_zero`,
+// compiles the variant of a masked plane reading the mask as 0 instead.
+// Returns whether the kernel was missing from jit_cache.
+bool compileKernel(ExprData* d, const std::vector<int>& kernel_planes,
+                   int width, int height, const VSAPI* vsapi,
+                   bool mask_zero = false);
+
+// Clip read by a pixel access token, or -1 for other tokens.
+int accessedClip(const Token& token);
+
+// Creates Expr, or Chain when `chain` is set: Chain takes a list of stages
+// applied to every plane instead of one expression per plane, and fuses them
+// into as few expressions as possible (see frontend/StageFusion.hpp).
+// Parses the arguments of Expr (or Chain) into `d`, which holds references
+// to the input clips from the start so that the caller can release them when
+// this throws.
+void initExprFilter(ExprData* d, const VSMap* in, VSCore* core,
+                    const VSAPI* vsapi, bool chain);
+
+// Expr() and Chain().
+void VS_CC exprCreate(const VSMap* in, VSMap* out, void* userData,
+                      VSCore* core, const VSAPI* vsapi);
+void VS_CC chainCreate(const VSMap* in, VSMap* out, void* userData,
+                       VSCore* core, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_EXPR_HPP
@@ -0,0 +1,322 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FilterCommon.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "VSHelper4.h"
+
+#include "../jit/Jit.hpp"
+#include "../utils/IntegralImage.hpp"
+#include "../utils/Trace.hpp"
+
+namespace {
+
+// Per-thread integral tables, reused across frames to avoid reallocation.
+thread_local std::vector<std::vector<double>>
+    g_integral_tables; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
+template <bool check_dimensions>
+void validateAndInitClips(BaseExprData* d, const VSMap* in,
+                          const VSAPI* vsapi) {
+    int err = 0;
+    d->num_inputs = vsapi->mapNumElements(in, "clips");
+    if (d->num_inputs == 0) {
+        throw std::runtime_error("At least one clip must be provided.");
+    }
+
+    d->nodes.resize(d->num_inputs);
+    for (int i = 0; i < d->num_inputs; ++i) {
+        d->nodes[i] = vsapi->mapGetNode(in, "clips", i, &err);
+    }
+
+    std::vector<const VSVideoInfo*> vi(d->num_inputs);
+    for (int i = 0; i < d->num_inputs; ++i) {
+        vi[i] = vsapi->getVideoInfo(d->nodes[i]);
+        if (!vsh::isConstantVideoFormat(vi[i])) {
+            throw std::runtime_error(
+                "Only constant format clips are supported.");
+        }
+    }
+
+    if constexpr (check_dimensions) {
+        for (int i = 1; i < d->num_inputs; ++i) {
+            if (vi[i]->width != vi[0]->width ||
+                vi[i]->height != vi[0]->height) {
+                throw std::runtime_error(
+                    "All clips must have the same dimensions.");
+            }
+        }
+    }
+
+    d->vi = *vi[0];
+}
+
+template void validateAndInitClips<true>(BaseExprData* d, const VSMap* in,
+                                         const VSAPI* vsapi);
+template void validateAndInitClips<false>(BaseExprData* d, const VSMap* in,
+                                          const VSAPI* vsapi);
+
+void parseFormatParam(BaseExprData* d, const VSMap* in, const VSAPI* vsapi,
+                      VSCore* core) {
+    int err = 0;
+    const int format_id =
+        static_cast<int>(vsapi->mapGetInt(in, "format", 0, &err));
+    if (err == 0) {
+        VSVideoFormat temp_format;
+        if (vsapi->getVideoFormatByID(&temp_format, format_id, core) != 0) {
+            if (d->vi.format.numPlanes != temp_format.numPlanes) {
+                throw std::runtime_error("The number of planes in the "
+                                         "inputs and output must match.");
+            }
+            VSVideoFormat new_format;
+            if (vsapi->queryVideoFormat(&new_format, d->vi.format.colorFamily,
+                                        temp_format.sampleType,
+                                        temp_format.bitsPerSample,
+                                        d->vi.format.subSamplingW,
+                                        d->vi.format.subSamplingH, core) != 0) {
+                d->vi.format = new_format;
+            } else {
+                throw std::runtime_error("Failed to query new format.");
+            }
+        }
+    }
+}
+
+void parseCommonParams(BaseExprData* d, const VSMap* in, const VSAPI* vsapi) {
+    int err = 0;
+
+    const char* dump_path = vsapi->mapGetData(in, "dump_ir", 0, &err);
+    if ((err == 0) && (dump_path != nullptr)) {
+        d->dump_ir_path = dump_path;
+    }
+
+    const char* report_path = vsapi->mapGetData(in, "report", 0, &err);
+    if ((err == 0) && (report_path != nullptr)) {
+        d->report_path = report_path;
+    }
+
+    d->opt_level = static_cast<int>(vsapi->mapGetInt(in, "opt_level", 0, &err));
+    if (err != 0) {
+        d->opt_level = 5; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    }
+    if (d->opt_level <= 0) {
+        throw std::runtime_error("opt_level must be greater than 0.");
+    }
+
+    d->approx_math =
+        static_cast<int>(vsapi->mapGetInt(in, "approx_math", 0, &err));
+    if (err != 0) {
+        d->approx_math = 2; // Default to auto mode
+    }
+    if (d->approx_math < 0 || d->approx_math > 2) {
+        throw std::runtime_error(
+            "approx_math must be 0 (disabled), 1 (enabled), or 2 (auto).");
+    }
+
+    d->stats_mode = static_cast<int>(vsapi->mapGetInt(in, "stats", 0, &err));
+    if (d->stats_mode < 0 || d->stats_mode > 2) {
+        throw std::runtime_error(
+            "stats must be 0 (Stats() only), 1 (frame properties), or 2 "
+            "(hardware counters).");
+    }
+}
+
+void parseTraceParam(BaseExprData* d, const VSMap* in, const VSAPI* vsapi) {
+    int err = 0;
+    const char* trace_path = vsapi->mapGetData(in, "trace", 0, &err);
+    d->trace_file = (err == 0 && trace_path != nullptr)
+                        ? openTraceFile(trace_path)
+                        : defaultTraceFile();
+}
+
+void readFrameProperties(
+    std::vector<float>& props, const std::vector<const VSFrame*>& src_frames,
+    const std::vector<std::pair<int, std::string>>& required_props, int n,
+    const VSAPI* vsapi) {
+
+    props[0] = static_cast<float>(n);
+
+    for (size_t i = 0; i < required_props.size(); ++i) {
+        const auto& prop_info = required_props[i];
+        int clip_idx = prop_info.first;
+        const std::string& prop_name = prop_info.second;
+        int prop_array_idx = static_cast<int>(i) + 1;
+
+        const VSMap* props_map =
+            vsapi->getFramePropertiesRO(src_frames[clip_idx]);
+        int err = 0;
+        int type = vsapi->mapGetType(props_map, prop_name.c_str());
+
+        if (type == ptInt) {
+            props[prop_array_idx] = static_cast<float>(
+                vsapi->mapGetInt(props_map, prop_name.c_str(), 0, &err));
+        } else if (type == ptFloat) {
+            props[prop_array_idx] = static_cast<float>(
+                vsapi->mapGetFloat(props_map, prop_name.c_str(), 0, &err));
+        } else if (type == ptData) {
+            if (vsapi->mapGetDataSize(props_map, prop_name.c_str(), 0, &err) >
+                    0 &&
+                (err == 0)) {
+                props[prop_array_idx] = static_cast<float>(
+                    *vsapi->mapGetData(props_map, prop_name.c_str(), 0, &err));
+            } else {
+                err = 1;
+            }
+        } else {
+            err = 1;
+        }
+
+        if (err != 0) {
+            props[prop_array_idx] = std::bit_cast<float>(PROP_READ_NAN_PAYLOAD);
+        }
+    }
+}
+
+void prepareIntegralTables(std::vector<uint8_t*>& rwptrs,
+                           std::vector<int>& strides, size_t base,
+                           const std::vector<std::pair<int, int>>& planes,
+                           int current_plane,
+                           const std::vector<const VSFrame*>& src_frames,
+                           const std::vector<VSNode*>& nodes,
+                           const VSAPI* vsapi) {
+    rwptrs.resize(base + planes.size());
+    strides.resize(base + planes.size());
+    if (g_integral_tables.size() < planes.size()) {
+        g_integral_tables.resize(planes.size());
+    }
+
+    for (size_t k = 0; k < planes.size(); ++k) {
+        const auto [clip_idx, plane_idx] = planes[k];
+        const int plane = plane_idx < 0 ? current_plane : plane_idx;
+        const VSFrame* frame = src_frames[clip_idx];
+        const int width = vsapi->getFrameWidth(frame, plane);
+        const int height = vsapi->getFrameHeight(frame, plane);
+
+        computeIntegralImage(vsapi->getReadPtr(frame, plane),
+                             vsapi->getStride(frame, plane), width, height,
+                             vsapi->getVideoInfo(nodes[clip_idx])->format,
+                             g_integral_tables[k]);
+
+        rwptrs[base + k] = reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            uint8_t*>(g_integral_tables[k].data());
+        strides[base + k] = integralImageStride(width);
+    }
+}
+
+std::string kernelName(std::string_view filter, int plane,
+                       const std::vector<Token>& tokens, size_t key_hash) {
+    constexpr size_t max_slug = 24;
+    std::string slug;
+    for (const auto& token : tokens) {
+        for (char c : token.text + " ") {
+            if (slug.size() >= max_slug) {
+                break;
+            }
+            if (std::isalnum(static_cast<unsigned char>(c)) != 0) {
+                slug += c;
+            } else if (!slug.empty() && slug.back() != '_') {
+                slug += '_';
+            }
+        }
+    }
+    while (!slug.empty() && slug.back() == '_') {
+        slug.pop_back();
+    }
+    std::string name = std::format("process_{}", filter);
+    if (plane >= 0) {
+        name += std::format("_plane{}", plane);
+    }
+    name = std::format("{}_{}_{:016x}", name, slug, key_hash);
+    if (jit_cache_generation > 0) {
+        name += std::format("_{}", jit_cache_generation);
+    }
+    return name;
+}
+
+std::string generate_cache_key(
+    const std::string& expr, const VSVideoInfo* vo, const VSAPI* vsapi,
+    const std::vector<const VSVideoInfo*>& vi, bool mirror,
+    const std::map<std::pair<int, std::string>, int>& prop_map, int plane_width,
+    int plane_height, int opt_level, int approx_math,
+    const LoopOptions& loop_options,
+    const std::vector<std::string>& output_props) {
+    auto get_vf_name = [&](const VSVideoFormat* vf) {
+        std::array<char, 32> // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            vf_name_buffer{};
+        if (!vsapi->getVideoFormatName(vf, vf_name_buffer.data())) {
+            throw std::runtime_error("Failed to get video format name");
+        }
+        return std::string(vf_name_buffer.data());
+    };
+    std::string result =
+        std::format("expr={}|mirror={}|out={}|w={}|h={}|opt={}|approx={}|"
+                    "tile={}|rows={}|range={}|cols={}|band={},{},{}",
+                    expr, mirror, get_vf_name(&vo->format), plane_width,
+                    plane_height, opt_level, approx_math,
+                    loop_options.tile_width,
+                    loop_options.row_block, loop_options.row_range,
+                    loop_options.column_range, loop_options.band_dst,
+                    loop_options.band_clip_begin, loop_options.band_clip_end);
+
+    for (size_t i = 0; i < vi.size(); ++i) {
+        result += std::format("|in{}={}", i, get_vf_name(&vi[i]->format));
+    }
+
+    for (const auto& [key, val] : prop_map) {
+        result += std::format("|prop{}={}.{}", val, key.first, key.second);
+    }
+
+    for (const auto& prop : output_props) {
+        result += std::format("|out_prop={}", prop);
+    }
+
+    return result;
+}
+
+void applySourceLines(std::vector<Token>& tokens,
+                      const std::vector<int>& lines) {
+    if (lines.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        tokens[i].line = lines.size() == tokens.size() ? lines[i] : 0;
+    }
+}
+
+void fillFromFirstRow(VSFrame* frame, int plane, const VSAPI* vsapi) {
+    uint8_t* ptr = vsapi->getWritePtr(frame, plane);
+    const ptrdiff_t stride = vsapi->getStride(frame, plane);
+    const auto row_bytes =
+        static_cast<size_t>(vsapi->getFrameWidth(frame, plane)) *
+        vsapi->getVideoFrameFormat(frame)->bytesPerSample;
+    const int height = vsapi->getFrameHeight(frame, plane);
+    for (int y = 1; y < height; ++y) {
+        std::memcpy(ptr + y * stride, ptr, row_bytes);
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_FILTERCOMMON_HPP
+#define LLVMEXPR_FILTER_FILTERCOMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../frontend/Tokenizer.hpp"
+#include "../ir/LoopOptions.hpp"
+#include "FilterData.hpp"
+#include "Stats.hpp"
+
+// Takes the clips of `in` into `d`, whose output format starts as the first
+// clip's. With `check_dimensions`, all clips must have the same dimensions.
+template <bool check_dimensions>
+void validateAndInitClips(BaseExprData* d, const VSMap* in,
+                          const VSAPI* vsapi);
+
+// Applies the `format` parameter to the output format of `d`.
+void parseFormatParam(BaseExprData* d, const VSMap* in, const VSAPI* vsapi,
+                      VSCore* core);
+
+// Parses the parameters shared by all filters, besides format and trace.
+void parseCommonParams(BaseExprData* d, const VSMap* in, const VSAPI* vsapi);
+
+// Selects the trace file of the `trace` parameter, falling back to the
+// LLVMEXPR_TRACE environment variable. Parsed before the expressions so
+// that their conversion and analysis are traced too.
+void parseTraceParam(BaseExprData* d, const VSMap* in, const VSAPI* vsapi);
+
+// Fills `props` with the frame number followed by `required_props`, read
+// from `src_frames`. Missing properties read as a NaN.
+void readFrameProperties(
+    std::vector<float>& props, const std::vector<const VSFrame*>& src_frames,
+    const std::vector<std::pair<int, std::string>>& required_props, int n,
+    const VSAPI* vsapi);
+
+// Computes the integral tables for the given (clip, plane) pairs and appends
+// their pointers and strides after the first `base` entries of rwptrs/strides.
+// A plane index of -1 refers to `current_plane`.
+void prepareIntegralTables(std::vector<uint8_t*>& rwptrs,
+                           std::vector<int>& strides, size_t base,
+                           const std::vector<std::pair<int, int>>& planes,
+                           int current_plane,
+                           const std::vector<const VSFrame*>& src_frames,
+                           const std::vector<VSNode*>& nodes,
+                           const VSAPI* vsapi);
+
+template <typename T>
+void genericFree(void* instanceData, [[maybe_unused]] VSCore* core,
+                 const VSAPI* vsapi) {
+    std::unique_ptr<T> d(static_cast<T*>(instanceData));
+    unregisterStats(d.get());
+    for (auto* node : d->nodes) {
+        vsapi->freeNode(node);
+    }
+}
+
+// Name of the JIT function of a kernel, as shown by profilers and debuggers:
+// the filter, the plane (-1 for SingleExpr), the start of the expression and
+// the cache key hash, e.g. process_Expr_plane0_x_2_0123456789abcdef. Kernels
+// compiled after the cache was cleared get the number of clears appended,
+// as the kernel compiled before may still be loaded under the same name.
+std::string kernelName(std::string_view filter, int plane,
+                       const std::vector<Token>& tokens, size_t key_hash);
+
+// Key of a kernel in jit_cache: everything its code depends on.
+std::string generate_cache_key(
+    const std::string& expr, const VSVideoInfo* vo, const VSAPI* vsapi,
+    const std::vector<const VSVideoInfo*>& vi, bool mirror,
+    const std::map<std::pair<int, std::string>, int>& prop_map, int plane_width,
+    int plane_height, int opt_level, int approx_math,
+    const LoopOptions& loop_options,
+    const std::vector<std::string>& output_props = {});
+
+// Replaces the line numbers the tokenizer gave `tokens` with `lines`, the
+// infix source line of each token. Lines that cannot be matched up with the
+// tokens are dropped rather than guessed.
+void applySourceLines(std::vector<Token>& tokens,
+                      const std::vector<int>& lines);
+
+// Copies the first row of a plane to all other rows.
+void fillFromFirstRow(VSFrame* frame, int plane, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_FILTERCOMMON_HPP
@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_FILTERDATA_HPP
+#define LLVMEXPR_FILTER_FILTERDATA_HPP
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../analysis/AnalysisResults.hpp"
+#include "../frontend/Tokenizer.hpp"
+#include "../ir/LoopOptions.hpp"
+#include "../jit/Jit.hpp"
+#include "../utils/Trace.hpp"
+#include "Stats.hpp"
+#include "TileCache.hpp"
+
+constexpr uint32_t PROP_READ_NAN_PAYLOAD =
+    0x7FC0BEEF; // qNaN with payload 0xBEEF
+constexpr uint32_t PROP_WRITE_NAN_PAYLOAD =
+    0x7FC0DEAD; // qNaN with payload 0xDEAD
+constexpr uint32_t PROP_DELETE_NAN_PAYLOAD =
+    0x7FC0DE1E; // qNaN with payload DE1E
+
+// How a plane of the output is produced: by its kernel, as a reference to a
+// plane of an input clip, by computing one row of a frame-constant
+// expression and copying it to the others, by its kernel tile by tile with a
+// cheaper one where the mask clip is zero, or by its kernel on the tiles
+// whose inputs changed since they were last computed.
+enum class PlaneOp : std::uint8_t {
+    PO_PROCESS,
+    PO_COPY,
+    PO_FILL,
+    PO_MASKED,
+    PO_CACHED
+};
+
+struct BaseExprData {
+    std::vector<VSNode*> nodes;
+    VSVideoInfo vi = {};
+    int num_inputs = 0;
+    bool mirror_boundary = false;
+    std::string dump_ir_path;
+    // File the static report of every kernel compiled is appended to.
+    std::string report_path;
+    int opt_level = 5; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    int approx_math = 2;
+    std::vector<std::pair<int, std::string>> required_props;
+    std::map<std::pair<int, std::string>, int> prop_map;
+    // 0 = counters for Stats() only, 1 = also per-frame properties,
+    // 2 = also hardware counters.
+    int stats_mode = 0;
+    // Shared by the passes of a multi-pass Chain.
+    std::shared_ptr<InstanceStats> stats = std::make_shared<InstanceStats>();
+    // Trace receiving compilation phases (and kernel calls with
+    // LLVMEXPR_TRACE_KERNELS=1), or nullptr.
+    TraceFile* trace_file = nullptr;
+};
+
+struct ExprData : BaseExprData {
+    LoopOptions loop_options;
+    std::array<PlaneOp, 3> plane_op = {};
+    // Clip a PO_COPY plane is taken from.
+    std::array<int, 3> copy_clip = {};
+    bool fuse_planes = false;
+    // Planes computed by each kernel, in call order. A kernel's compiled
+    // function is stored at the index of its first plane.
+    std::vector<std::vector<int>> kernels;
+    std::array<CompiledFunction, 3> compiled;
+    std::array<std::vector<Token>, 3> tokens;
+    std::array<std::unique_ptr<analysis::AnalysisManager>, 3> analysis_managers;
+    std::array<std::vector<std::pair<int, int>>, 3> integral_planes;
+    std::array<std::vector<analysis::PatchDistanceKey>, 3> patch_distances;
+    std::array<std::vector<std::pair<int, int>>, 3> plane_reads;
+    // (clip, frame offset) of the extra inputs that follow the clips, one per
+    // distinct temporal access.
+    std::vector<std::pair<int, int>> temporal_inputs;
+    // Outputs written with @N on each plane; output 0 is the value left on
+    // the stack.
+    std::array<std::vector<int>, 3> extra_outputs;
+    int num_outputs = 1;
+    // Reductions accumulated on each plane, written as frame properties.
+    std::array<std::vector<analysis::Reduction>, 3> reductions;
+    // Multi-pass Chain: the passes writing scratch planes, in order, ahead of
+    // this node's own pass. Every pass reads scratch plane q as clip
+    // num_inputs + q in the float format scratch_vi and runs band by band
+    // (see runChainPasses). Scratch passes share this node's clips without
+    // owning them.
+    std::vector<std::unique_ptr<ExprData>> scratch_passes;
+    int num_scratch = 0;
+    VSVideoInfo scratch_vi = {};
+    // Rows computed above and below a band, per plane.
+    std::array<int, 3> halo_rows = {};
+    // Rows per band, -1 = auto (from L2 size).
+    int band_rows = -1;
+    // Masked planes: the mask clip, and each PO_MASKED plane's expression
+    // with the mask read as 0, used on tiles where the mask is all zero.
+    int mask_clip = -1;
+    std::array<std::vector<Token>, 3> mask_zero_tokens;
+    std::array<std::unique_ptr<analysis::AnalysisManager>, 3>
+        mask_zero_managers;
+    std::array<CompiledFunction, 3> mask_zero_compiled;
+    // PO_CACHED planes.
+    std::array<std::unique_ptr<TileCache>, 3> tile_caches;
+    // Expression of each plane as given by the user (infix or postfix),
+    // which the line numbers of its tokens refer to. Empty for Chain.
+    std::array<std::string, 3> sources;
+    // Estimated memory traffic of each plane, for the stats counters.
+    std::array<int, 3> read_bytes_per_pixel = {};
+    std::array<int, 3> write_bytes_per_pixel = {};
+};
+
+#endif // LLVMEXPR_FILTER_FILTERDATA_HPP
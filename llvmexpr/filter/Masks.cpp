@@ -0,0 +1,160 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Masks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <memory>
+#include <stdexcept>
+
+#include "../analysis/ExpressionAnalyzer.hpp"
+#include "Expr.hpp"
+#include "FilterData.hpp"
+
+namespace {
+
+template <typename T>
+bool isZeroTile(const uint8_t* ptr, ptrdiff_t stride, int x0, int x1, int y0,
+                int y1) {
+    for (int y = y0; y < y1; ++y) {
+        const auto* row = reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            const T*>(ptr + y * stride);
+        bool nonzero = false;
+        for (int x = x0; x < x1; ++x) {
+            nonzero |= row[x] != T{};
+        }
+        if (nonzero) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether the mask is zero over a tile. Half floats are compared bitwise, so
+// a -0 counts as nonzero.
+bool isZeroTile(const VSVideoFormat* format, const uint8_t* ptr,
+                ptrdiff_t stride, int x0, int x1, int y0, int y1) {
+    switch (format->bytesPerSample) {
+    case 1:
+        return isZeroTile<uint8_t>(ptr, stride, x0, x1, y0, y1);
+    case 2:
+        return isZeroTile<uint16_t>(ptr, stride, x0, x1, y0, y1);
+    default:
+        return format->sampleType == stFloat
+                   ? isZeroTile<float>(ptr, stride, x0, x1, y0, y1)
+                   : isZeroTile<uint32_t>(ptr, stride, x0, x1, y0, y1);
+    }
+}
+
+} // namespace
+
+void runMaskedPlane(ExprData* d, int plane, const VSFrame* mask_frame,
+                    int row_begin, int row_end, uint8_t** rwptrs,
+                    const int* strides, float* props,
+                    std::vector<double>& reduction_results,
+                    ReductionTotals& reductions, const VSAPI* vsapi) {
+    const VSVideoFormat* format = vsapi->getVideoFrameFormat(mask_frame);
+    const uint8_t* mask = vsapi->getReadPtr(mask_frame, plane);
+    const ptrdiff_t stride = vsapi->getStride(mask_frame, plane);
+    const int width = vsapi->getFrameWidth(mask_frame, plane);
+
+    auto run = [&](bool zero, int x0, int x1, int y0, int y1) {
+        std::array<int32_t, 4> range = {y0, y1, x0, x1};
+        const auto& compiled = zero ? d->mask_zero_compiled : d->compiled;
+        compiled.at(plane).func_ptr(range.data(), rwptrs, strides, props);
+        accumulateReductions(d->reductions.at(plane), reduction_results,
+                             reductions);
+    };
+    for (int y0 = row_begin; y0 < row_end; y0 += MASK_TILE_HEIGHT) {
+        const int y1 = std::min(y0 + MASK_TILE_HEIGHT, row_end);
+        int run_x0 = 0;
+        bool run_zero = false;
+        for (int x0 = 0; x0 < width; x0 += MASK_TILE_WIDTH) {
+            const int x1 = std::min(x0 + MASK_TILE_WIDTH, width);
+            const bool zero = isZeroTile(format, mask, stride, x0, x1, y0, y1);
+            if (x0 > 0 && zero != run_zero) {
+                run(run_zero, run_x0, x0, y0, y1);
+                run_x0 = x0;
+            }
+            run_zero = zero;
+        }
+        run(run_zero, run_x0, width, y0, y1);
+    }
+}
+
+void initMaskedPlanes(ExprData* d, const VSAPI* vsapi) {
+    const VSVideoFormat& mask_format =
+        vsapi->getVideoInfo(d->nodes[d->mask_clip])->format;
+    if (mask_format.subSamplingW != d->vi.format.subSamplingW ||
+        mask_format.subSamplingH != d->vi.format.subSamplingH) {
+        throw std::runtime_error(std::format(
+            "mask clip {} must have the same subsampling as the output.",
+            d->mask_clip));
+    }
+
+    for (int i = 0; i < d->vi.format.numPlanes; ++i) {
+        if (d->plane_op.at(i) != PlaneOp::PO_PROCESS) {
+            continue;
+        }
+        std::vector<Token> tokens = d->tokens.at(i);
+        bool reads_mask = false;
+        for (auto& token : tokens) {
+            if (token.type == TokenType::STORE_ABS ||
+                token.type == TokenType::STORE_ABS_PLANE) {
+                throw std::runtime_error(
+                    "mask cannot be used with expressions writing @[].");
+            }
+            if (accessedClip(token) != d->mask_clip) {
+                continue;
+            }
+            const auto* access =
+                std::get_if<TokenPayload_ClipAccess>(&token.payload);
+            if ((token.type != TokenType::CLIP_CUR &&
+                 token.type != TokenType::CLIP_REL) ||
+                access->rel_x != 0 || access->rel_y != 0) {
+                throw std::runtime_error(std::format(
+                    "mask clip {} may only be read at the current pixel, "
+                    "but plane {} reads '{}'.",
+                    d->mask_clip, i, token.text));
+            }
+            token = Token{.type = TokenType::NUMBER,
+                          .text = "0",
+                          .payload = TokenPayload_Number{.value = 0.0}};
+            reads_mask = true;
+        }
+        if (!reads_mask) {
+            continue;
+        }
+        if (i >= mask_format.numPlanes) {
+            throw std::runtime_error(std::format(
+                "mask clip {} has no plane {}.", d->mask_clip, i));
+        }
+
+        d->mask_zero_tokens.at(i) = std::move(tokens);
+        d->mask_zero_managers.at(i) =
+            std::make_unique<analysis::AnalysisManager>(
+                d->mask_zero_tokens.at(i), d->mirror_boundary);
+        analysis::ExpressionAnalyzer expr_analyzer(
+            *d->mask_zero_managers.at(i));
+        expr_analyzer.analyze();
+        d->plane_op.at(i) = PlaneOp::PO_MASKED;
+    }
+}
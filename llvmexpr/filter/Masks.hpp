@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_MASKS_HPP
+#define LLVMEXPR_FILTER_MASKS_HPP
+
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "Reductions.hpp"
+
+struct ExprData;
+
+// Tile size of masked planes, in samples.
+constexpr int MASK_TILE_WIDTH = 64;
+constexpr int MASK_TILE_HEIGHT = 16;
+
+// Makes the planes of `d` reading the mask clip PO_MASKED, and prepares
+// their expression with the mask read as 0. The mask may only be read at
+// the current pixel, so a tile where it is zero computes the same values
+// with either kernel.
+void initMaskedPlanes(ExprData* d, const VSAPI* vsapi);
+
+// Runs rows [row_begin, row_end) of a masked plane tile by tile: tiles where
+// the mask is zero everywhere use the kernel reading the mask as 0, the
+// others the full kernel. Neighbouring tiles of a row that use the same
+// kernel share one call. row_begin must be a multiple of MASK_TILE_HEIGHT.
+void runMaskedPlane(ExprData* d, int plane, const VSFrame* mask_frame,
+                    int row_begin, int row_end, uint8_t** rwptrs,
+                    const int* strides, float* props,
+                    std::vector<double>& reduction_results,
+                    ReductionTotals& reductions, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_MASKS_HPP
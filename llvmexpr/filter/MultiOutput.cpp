@@ -0,0 +1,174 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MultiOutput.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+#include "FilterCommon.hpp"
+#include "FilterData.hpp"
+
+namespace {
+
+// A clip returned by an Expr with several outputs. It reads its frame from
+// the node computing all outputs, which attaches outputs 1..K-1 to output 0.
+struct ExprOutputData {
+    VSNode* node;
+    int output_idx;
+};
+
+constexpr const char* EXTRA_OUTPUTS_PROP = "_LLVMExprOutputs";
+
+template <typename T> void fillRow(uint8_t* ptr, int width, T value) {
+    auto* row = reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        T*>(ptr);
+    std::fill_n(row, width, value);
+}
+
+// Sets a plane to 0, or to the neutral value for the chroma planes of
+// integer YUV formats.
+void blankPlane(VSFrame* frame, int plane, const VSAPI* vsapi) {
+    const VSVideoFormat* format = vsapi->getVideoFrameFormat(frame);
+    uint8_t* ptr = vsapi->getWritePtr(frame, plane);
+    const int width = vsapi->getFrameWidth(frame, plane);
+    const uint32_t value = plane > 0 && format->colorFamily == cfYUV &&
+                                   format->sampleType == stInteger
+                               ? 1U << (format->bitsPerSample - 1)
+                               : 0U;
+    switch (format->bytesPerSample) {
+    case 1:
+        fillRow(ptr, width, static_cast<uint8_t>(value));
+        break;
+    case 2:
+        fillRow(ptr, width, static_cast<uint16_t>(value));
+        break;
+    default:
+        fillRow(ptr, width, value);
+        break;
+    }
+    fillFromFirstRow(frame, plane, vsapi);
+}
+
+const VSFrame*
+    VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+    exprOutputGetFrame(int n, int activationReason, void* instanceData,
+                       [[maybe_unused]] void** frameData,
+                       VSFrameContext* frameCtx, VSCore* core,
+                       const VSAPI* vsapi) {
+    auto* d = static_cast<ExprOutputData*>(instanceData);
+
+    if (activationReason == arInitial) {
+        vsapi->requestFrameFilter(n, d->node, frameCtx);
+    } else if (activationReason == arAllFramesReady) {
+        const VSFrame* frame = vsapi->getFrameFilter(n, d->node, frameCtx);
+        if (d->output_idx > 0) {
+            const VSFrame* output =
+                vsapi->mapGetFrame(vsapi->getFramePropertiesRO(frame),
+                                   EXTRA_OUTPUTS_PROP, d->output_idx - 1,
+                                   nullptr);
+            vsapi->freeFrame(frame);
+            return output;
+        }
+        VSFrame* output = vsapi->copyFrame(frame, core);
+        vsapi->freeFrame(frame);
+        vsapi->mapDeleteKey(vsapi->getFramePropertiesRW(output),
+                            EXTRA_OUTPUTS_PROP);
+        return output;
+    }
+
+    return nullptr;
+}
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+exprOutputFree(void* instanceData, [[maybe_unused]] VSCore* core,
+               const VSAPI* vsapi) {
+    std::unique_ptr<ExprOutputData> d(
+        static_cast<ExprOutputData*>(instanceData));
+    vsapi->freeNode(d->node);
+}
+
+} // namespace
+
+bool canCopyPlane(const VSVideoFormat& format, const VSVideoFormat& out,
+                  int plane) {
+    return plane < format.numPlanes && format.sampleType == out.sampleType &&
+           format.bitsPerSample == out.bitsPerSample &&
+           format.subSamplingW == out.subSamplingW &&
+           format.subSamplingH == out.subSamplingH;
+}
+
+std::vector<VSFrame*>
+newExtraOutputFrames(const ExprData* d,
+                     const std::vector<const VSFrame*>& src_frames,
+                     VSCore* core, const VSAPI* vsapi) {
+    std::array<int, 3> planes = {0, 1, 2};
+    std::vector<VSFrame*> extra_frames;
+    const VSVideoFormat& first_format =
+        vsapi->getVideoInfo(d->nodes[0])->format;
+    for (int k = 1; k < d->num_outputs; ++k) {
+        std::array<const VSFrame*, 3> extra_src = {};
+        std::vector<int> blank_planes;
+        for (int plane = 0; plane < d->vi.format.numPlanes; ++plane) {
+            if (std::ranges::contains(d->extra_outputs.at(plane), k)) {
+                continue;
+            }
+            if (canCopyPlane(first_format, d->vi.format, plane)) {
+                extra_src.at(plane) = src_frames[0];
+            } else {
+                blank_planes.push_back(plane);
+            }
+        }
+        extra_frames.push_back(vsapi->newVideoFrame2(
+            &d->vi.format, d->vi.width, d->vi.height, extra_src.data(),
+            planes.data(), src_frames[0], core));
+        for (int plane : blank_planes) {
+            blankPlane(extra_frames.back(), plane, vsapi);
+        }
+    }
+    return extra_frames;
+}
+
+void attachExtraOutputs(const std::vector<VSFrame*>& extra_frames,
+                        VSFrame* dst_frame, const VSAPI* vsapi) {
+    if (!extra_frames.empty()) {
+        VSMap* props = vsapi->getFramePropertiesRW(dst_frame);
+        for (auto* frame : extra_frames) {
+            vsapi->mapConsumeFrame(props, EXTRA_OUTPUTS_PROP, frame,
+                                   maAppend);
+        }
+    }
+}
+
+void createOutputClips(VSNode* shared, int num_outputs, VSMap* out,
+                       VSCore* core, const VSAPI* vsapi) {
+    vsapi->setCacheMode(shared, cmForceEnable);
+
+    const VSFilterDependency shared_dep{shared, rpStrictSpatial};
+    for (int k = 0; k < num_outputs; ++k) {
+        auto output = std::make_unique<ExprOutputData>(
+            ExprOutputData{.node = vsapi->addNodeRef(shared), .output_idx = k});
+        vsapi->createVideoFilter(out, "ExprOutput", vsapi->getVideoInfo(shared),
+                                 exprOutputGetFrame, exprOutputFree,
+                                 fmParallel, &shared_dep, 1, output.release(),
+                                 core);
+    }
+    vsapi->freeNode(shared);
+}
@@ -0,0 +1,54 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_MULTIOUTPUT_HPP
+#define LLVMEXPR_FILTER_MULTIOUTPUT_HPP
+
+#include <vector>
+
+#include "VapourSynth4.h"
+
+struct ExprData;
+
+// Whether plane `plane` of a frame in `format` can be passed through by
+// reference to an output in `out`.
+bool canCopyPlane(const VSVideoFormat& format, const VSVideoFormat& out,
+                  int plane);
+
+// Creates the frames of outputs 1..K-1 of `d`. Planes that never write an
+// output are copied from the first clip, like planes with an empty
+// expression, or blanked if the first clip's plane does not fit the output.
+std::vector<VSFrame*>
+newExtraOutputFrames(const ExprData* d,
+                     const std::vector<const VSFrame*>& src_frames,
+                     VSCore* core, const VSAPI* vsapi);
+
+// Attaches the frames of outputs 1..K-1 to the frame of output 0, which
+// takes them over.
+void attachExtraOutputs(const std::vector<VSFrame*>& extra_frames,
+                        VSFrame* dst_frame, const VSAPI* vsapi);
+
+// Adds one clip per output of `shared`, the node computing every output of
+// an Expr per frame, to `out`, and releases `shared`. Each clip takes its
+// frame from the node, whose frame cache keeps sibling clips from
+// evaluating the expression again.
+void createOutputClips(VSNode* shared, int num_outputs, VSMap* out,
+                       VSCore* core, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_MULTIOUTPUT_HPP
@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PatchDistance.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "../utils/IntegralImage.hpp"
+#include "FilterData.hpp"
+#include "Masks.hpp"
+
+namespace {
+
+// Per-thread samples of the clips read by patch distances, reused across
+// frames to avoid reallocation.
+thread_local std::vector<std::vector<double>>
+    g_patch_samples; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// Per-thread band of patch distance rows, one block per distinct patch.
+thread_local std::vector<float>
+    g_patch_band; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local PatchDistanceScratch
+    g_patch_scratch; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
+void preparePatchDistanceTables(
+    std::vector<uint8_t*>& rwptrs, std::vector<int>& strides, size_t base,
+    const std::vector<analysis::PatchDistanceKey>& patches, int plane,
+    const std::vector<const VSFrame*>& src_frames,
+    const std::vector<VSNode*>& nodes, const VSAPI* vsapi) {
+    rwptrs.resize(base + patches.size());
+    strides.resize(base + patches.size());
+    if (g_patch_samples.size() < src_frames.size()) {
+        g_patch_samples.resize(src_frames.size());
+    }
+
+    // Each source plane is converted once and shared by all its offsets.
+    std::vector<bool> loaded(src_frames.size(), false);
+    for (size_t k = 0; k < patches.size(); ++k) {
+        const auto& patch = patches[k];
+        const VSFrame* frame = src_frames[patch.clip_idx];
+        const int width = vsapi->getFrameWidth(frame, plane);
+
+        if (!loaded[patch.clip_idx]) {
+            loadPlaneSamples(vsapi->getReadPtr(frame, plane),
+                             vsapi->getStride(frame, plane), width,
+                             vsapi->getFrameHeight(frame, plane),
+                             vsapi->getVideoInfo(nodes[patch.clip_idx])->format,
+                             g_patch_samples[patch.clip_idx]);
+            loaded[patch.clip_idx] = true;
+        }
+
+        rwptrs[base + k] = nullptr;
+        strides[base + k] = patchDistanceStride(width);
+    }
+}
+
+void runPatchDistancePlane(ExprData* d, int plane,
+                           const std::vector<const VSFrame*>& src_frames,
+                           VSFrame* dst_frame, std::vector<uint8_t*>& rwptrs,
+                           const std::vector<int>& strides, float* props,
+                           std::vector<double>& reduction_results,
+                           ReductionTotals& reductions, const VSAPI* vsapi) {
+    const auto& patches = d->patch_distances.at(plane);
+    const int width = vsapi->getFrameWidth(dst_frame, plane);
+    const int height = vsapi->getFrameHeight(dst_frame, plane);
+    // Bands are whole mask tiles high.
+    const int band =
+        patchDistanceBandRows(patches.size(), width, height, MASK_TILE_HEIGHT);
+    const size_t band_size = static_cast<size_t>(band) * width;
+    // Slots follow the destination, the sources and the integral tables.
+    const size_t slot =
+        1 + src_frames.size() + d->integral_planes.at(plane).size();
+    g_patch_band.resize(patches.size() * band_size);
+
+    for (int y0 = 0; y0 < height; y0 += band) {
+        const int y1 = std::min(y0 + band, height);
+        for (size_t k = 0; k < patches.size(); ++k) {
+            const auto& patch = patches[k];
+            computePatchDistance(g_patch_samples[patch.clip_idx], width,
+                                 height, patch.dx, patch.dy, patch.radius, y0,
+                                 y1, g_patch_band.data() + (k * band_size),
+                                 g_patch_scratch);
+        }
+
+        // The kernel indexes the distance rows from the first row it is
+        // called for, so each call gets the band offset to its first row.
+        auto point_at_row = [&](int y) {
+            for (size_t k = 0; k < patches.size(); ++k) {
+                rwptrs[slot + k] =
+                    reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                        uint8_t*>(g_patch_band.data() + (k * band_size)) +
+                    static_cast<std::ptrdiff_t>(y - y0) * strides[slot + k];
+            }
+        };
+        if (d->plane_op.at(plane) == PlaneOp::PO_MASKED) {
+            for (int ty = y0; ty < y1; ty += MASK_TILE_HEIGHT) {
+                point_at_row(ty);
+                runMaskedPlane(d, plane, src_frames[d->mask_clip], ty,
+                               std::min(ty + MASK_TILE_HEIGHT, y1),
+                               rwptrs.data(), strides.data(), props,
+                               reduction_results, reductions, vsapi);
+            }
+        } else {
+            point_at_row(y0);
+            std::array<int32_t, 2> rows = {y0, y1};
+            d->compiled.at(plane).func_ptr(rows.data(), rwptrs.data(),
+                                           strides.data(), props);
+            accumulateReductions(d->reductions.at(plane), reduction_results,
+                                 reductions);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_PATCHDISTANCE_HPP
+#define LLVMEXPR_FILTER_PATCHDISTANCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../analysis/passes/PatchDistanceUsagePass.hpp"
+#include "Reductions.hpp"
+
+struct ExprData;
+
+// Loads the samples of the clips read by `patches` on `plane` and reserves
+// the rwptrs/strides entries of their distance planes after the first `base`
+// entries. The pointers are set band by band by runPatchDistancePlane.
+void preparePatchDistanceTables(
+    std::vector<uint8_t*>& rwptrs, std::vector<int>& strides, size_t base,
+    const std::vector<analysis::PatchDistanceKey>& patches, int plane,
+    const std::vector<const VSFrame*>& src_frames,
+    const std::vector<VSNode*>& nodes, const VSAPI* vsapi);
+
+// Runs a plane reading patch distances. The distance planes are computed
+// one band of rows at a time into a buffer that is reused by the next band,
+// so memory stays at one band per distinct patch instead of whole planes.
+// rwptrs/strides hold the plane's block alone, as its kernel is never fused.
+void runPatchDistancePlane(ExprData* d, int plane,
+                           const std::vector<const VSFrame*>& src_frames,
+                           VSFrame* dst_frame, std::vector<uint8_t*>& rwptrs,
+                           const std::vector<int>& strides, float* props,
+                           std::vector<double>& reduction_results,
+                           ReductionTotals& reductions, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_PATCHDISTANCE_HPP
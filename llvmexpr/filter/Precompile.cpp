@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Precompile.hpp"
+
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "VSHelper4.h"
+
+#include "Expr.hpp"
+#include "FilterData.hpp"
+
+namespace {
+
+// Appends to the clips of `args` one std.BlankClip per entry of the formats
+// argument of Precompile, of its width and height.
+void appendBlankClips(const VSMap* in, VSMap* args, VSCore* core,
+                      const VSAPI* vsapi) {
+    int err_w = 0;
+    int err_h = 0;
+    const int64_t width = vsapi->mapGetInt(in, "width", 0, &err_w);
+    const int64_t height = vsapi->mapGetInt(in, "height", 0, &err_h);
+    if (err_w != 0 || err_h != 0 || width <= 0 || height <= 0) {
+        throw std::runtime_error(
+            "Positive width and height must be given with formats.");
+    }
+
+    VSPlugin* std_plugin = vsapi->getPluginByID(VSH_STD_PLUGIN_ID, core);
+    const int num_formats = vsapi->mapNumElements(in, "formats");
+    for (int i = 0; i < num_formats; ++i) {
+        VSMap* blank_args = vsapi->createMap();
+        vsapi->mapSetInt(blank_args, "format",
+                         vsapi->mapGetInt(in, "formats", i, nullptr),
+                         maReplace);
+        vsapi->mapSetInt(blank_args, "width", width, maReplace);
+        vsapi->mapSetInt(blank_args, "height", height, maReplace);
+        vsapi->mapSetInt(blank_args, "length", 1, maReplace);
+        VSMap* ret = vsapi->invoke(std_plugin, "BlankClip", blank_args);
+        vsapi->freeMap(blank_args);
+        if (const char* error = vsapi->mapGetError(ret)) {
+            const std::string message = std::format("formats[{}]: {}", i,
+                                                    error);
+            vsapi->freeMap(ret);
+            throw std::runtime_error(message);
+        }
+        vsapi->mapConsumeNode(args, "clips",
+                              vsapi->mapGetNode(ret, "clip", 0, nullptr),
+                              maAppend);
+        vsapi->freeMap(ret);
+    }
+}
+
+} // namespace
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+precompileCreate(const VSMap* in, VSMap* out, [[maybe_unused]] void* userData,
+                 VSCore* core, const VSAPI* vsapi) {
+    auto d = std::make_unique<ExprData>();
+    d->stats->filter = "Expr"; // names the kernels like Expr's
+    VSMap* args = vsapi->createMap();
+    int64_t num_kernels = 0;
+    int64_t num_compiled = 0;
+
+    try {
+        const bool has_clips = vsapi->mapNumElements(in, "clips") > 0;
+        const bool has_formats = vsapi->mapNumElements(in, "formats") > 0;
+        if (has_clips == has_formats) {
+            throw std::runtime_error(
+                "Exactly one of clips and formats must be given.");
+        }
+        vsapi->copyMap(in, args);
+        if (has_formats) {
+            appendBlankClips(in, args, core, vsapi);
+        }
+        initExprFilter(d.get(), args, core, vsapi, false);
+
+        for (const auto& kernel_planes : d->kernels) {
+            const int plane = kernel_planes.front();
+            const int ss_w = plane > 0 ? d->vi.format.subSamplingW : 0;
+            const int ss_h = plane > 0 ? d->vi.format.subSamplingH : 0;
+            const int width = d->vi.width >> ss_w;
+            const int height = d->vi.height >> ss_h;
+            ++num_kernels;
+            if (compileKernel(d.get(), kernel_planes, width, height, vsapi)) {
+                ++num_compiled;
+            }
+            if (d->plane_op.at(plane) == PlaneOp::PO_MASKED) {
+                ++num_kernels;
+                if (compileKernel(d.get(), kernel_planes, width, height,
+                                  vsapi, true)) {
+                    ++num_compiled;
+                }
+            }
+        }
+        vsapi->mapSetInt(out, "kernels", num_kernels, maReplace);
+        vsapi->mapSetInt(out, "compiled", num_compiled, maReplace);
+    } catch (const std::exception& e) {
+        vsapi->mapSetError(
+            out, std::format("Precompile: {}", e.what()).c_str());
+    }
+
+    for (auto* node : d->nodes) {
+        if (node != nullptr) {
+            vsapi->freeNode(node);
+        }
+    }
+    vsapi->freeMap(args);
+}
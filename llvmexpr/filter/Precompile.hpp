@@ -0,0 +1,32 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_PRECOMPILE_HPP
+#define LLVMEXPR_FILTER_PRECOMPILE_HPP
+
+#include "VapourSynth4.h"
+
+// Compiles the kernels an Expr with the same arguments would, for clips or
+// for blank clips of the given formats and dimensions, without creating a
+// filter. Returns the number of kernels and how many of them were compiled
+// rather than found in jit_cache.
+void VS_CC precompileCreate(const VSMap* in, VSMap* out, void* userData,
+                            VSCore* core, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_PRECOMPILE_HPP
@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Reductions.hpp"
+
+#include <algorithm>
+
+void accumulateReductions(const std::vector<analysis::Reduction>& reductions,
+                          const std::vector<double>& results,
+                          ReductionTotals& totals) {
+    for (size_t i = 0; i < reductions.size(); ++i) {
+        const auto [it, inserted] = totals.try_emplace(
+            reductions[i].prop_name, reductions[i].kind, results[i]);
+        if (inserted) {
+            continue;
+        }
+        double& total = it->second.second;
+        switch (reductions[i].kind) {
+        case ReduceKind::SUM:
+        case ReduceKind::COUNT:
+            total += results[i];
+            break;
+        case ReduceKind::MIN:
+            total = std::min(total, results[i]);
+            break;
+        case ReduceKind::MAX:
+            total = std::max(total, results[i]);
+            break;
+        }
+    }
+}
+
+void writeReductions(const ReductionTotals& totals, VSFrame* frame,
+                     const VSAPI* vsapi) {
+    VSMap* props = vsapi->getFramePropertiesRW(frame);
+    for (const auto& [name, reduction] : totals) {
+        const auto [kind, value] = reduction;
+        if (kind == ReduceKind::COUNT) {
+            vsapi->mapSetInt(props, name.c_str(), static_cast<int64_t>(value),
+                             maReplace);
+        } else {
+            vsapi->mapSetFloat(props, name.c_str(), value, maReplace);
+        }
+    }
+}
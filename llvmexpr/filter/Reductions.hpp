@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_REDUCTIONS_HPP
+#define LLVMEXPR_FILTER_REDUCTIONS_HPP
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../analysis/passes/ReductionUsagePass.hpp"
+#include "../frontend/Tokenizer.hpp"
+
+using ReductionTotals = std::map<std::string, std::pair<ReduceKind, double>>;
+
+// Combines the reductions of one kernel call on a plane into `totals`.
+void accumulateReductions(const std::vector<analysis::Reduction>& reductions,
+                          const std::vector<double>& results,
+                          ReductionTotals& totals);
+
+// Writes reduced values as frame properties: counts as integers, the others
+// as floats.
+void writeReductions(const ReductionTotals& totals, VSFrame* frame,
+                     const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_REDUCTIONS_HPP
@@ -0,0 +1,508 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SingleExpr.hpp"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../analysis/AnalysisResults.hpp"
+#include "../analysis/ExpressionAnalyzer.hpp"
+#include "../analysis/passes/DynamicArrayAllocOptPass.hpp"
+#include "../analysis/passes/StaticArrayOptPass.hpp"
+#include "../frontend/InfixConverter.hpp"
+#include "../frontend/Tokenizer.hpp"
+#include "../jit/Compiler.hpp"
+#include "../jit/Jit.hpp"
+#include "../utils/KernelReport.hpp"
+#include "../utils/Trace.hpp"
+#include "FilterCommon.hpp"
+#include "FilterData.hpp"
+#include "Stats.hpp"
+
+namespace {
+
+struct SingleExprData : BaseExprData {
+    CompiledFunction compiled;
+    std::string source; // see ExprData::sources
+    std::vector<std::pair<std::string, PropWriteType>> output_props;
+    std::map<std::string, int> output_prop_map;
+    std::vector<Token> tokens;
+    std::unique_ptr<analysis::AnalysisManager> analysis_manager;
+    std::vector<std::pair<int, int>> integral_planes;
+};
+
+struct SingleExprFrameData {
+    struct DynamicArray {
+        std::vector<float> buffer;
+    };
+    std::map<std::string, DynamicArray> dynamic_arrays;
+};
+
+thread_local SingleExprFrameData
+    g_frame_data; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+singleExprFree(void* instanceData, [[maybe_unused]] VSCore* core,
+               const VSAPI* vsapi) {
+    genericFree<SingleExprData>(instanceData, core, vsapi);
+}
+
+const VSFrame*
+    VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+    singleExprGetFrame(int n, int activationReason, void* instanceData,
+                       [[maybe_unused]] void** frameData,
+                       VSFrameContext* frameCtx, VSCore* core,
+                       const VSAPI* vsapi) {
+    auto* d = static_cast<SingleExprData*>(instanceData);
+
+    if (activationReason == arInitial) {
+        for (int i = 0; i < d->num_inputs; ++i) {
+            vsapi->requestFrameFilter(n, d->nodes[i], frameCtx);
+        }
+    } else if (activationReason == arAllFramesReady) {
+        g_frame_data.dynamic_arrays.clear();
+
+        std::vector<const VSFrame*> src_frames(d->num_inputs);
+        for (int i = 0; i < d->num_inputs; ++i) {
+            src_frames[i] = vsapi->getFrameFilter(n, d->nodes[i], frameCtx);
+        }
+
+        std::array<const VSFrame*, 3> plane_src = {src_frames[0], src_frames[0],
+                                                   src_frames[0]};
+        std::array<int, 3> planes = {0, 1, 2};
+        VSFrame* dst_frame = vsapi->newVideoFrame2(
+            &d->vi.format, d->vi.width, d->vi.height, plane_src.data(),
+            planes.data(), src_frames[0], core);
+
+        int num_planes = d->vi.format.numPlanes;
+        std::vector<uint8_t*> rwptrs((d->num_inputs + 1) * num_planes);
+        std::vector<int> strides((d->num_inputs + 1) * num_planes);
+        std::vector<float> props(1 + d->required_props.size() +
+                                 d->output_props.size());
+
+        readFrameProperties(props, src_frames, d->required_props, n, vsapi);
+
+        for (size_t i = 0; i < d->output_props.size(); ++i) {
+            props[1 + d->required_props.size() + i] =
+                std::bit_cast<float>(PROP_WRITE_NAN_PAYLOAD);
+        }
+
+        for (int i = 0; i <= d->num_inputs; ++i) {
+            for (int p = 0; p < num_planes; ++p) {
+                rwptrs[(i * num_planes) + p] =
+                    (i == 0)
+                        ? vsapi->getWritePtr(dst_frame, p)
+                        : const_cast< // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                              uint8_t*>(
+                              vsapi->getReadPtr(src_frames[i - 1], p));
+                strides[(i * num_planes) + p] = static_cast<int>(
+                    (i == 0) ? vsapi->getStride(dst_frame, p)
+                             : vsapi->getStride(src_frames[i - 1], p));
+            }
+        }
+
+        if (!d->integral_planes.empty()) {
+            prepareIntegralTables(
+                rwptrs, strides,
+                static_cast<size_t>((d->num_inputs + 1) * num_planes),
+                d->integral_planes, 0, src_frames, d->nodes, vsapi);
+        }
+
+        if (d->compiled.func_ptr == nullptr) {
+            std::vector<const VSVideoInfo*> vi(d->num_inputs);
+            for (int i = 0; i < d->num_inputs; ++i) {
+                vi[i] = vsapi->getVideoInfo(d->nodes[i]);
+            }
+
+            std::string expr_str;
+            for (const auto& token : d->tokens) {
+                if (!expr_str.empty()) {
+                    expr_str += " ";
+                }
+                expr_str += token.text;
+            }
+
+            std::vector<std::string> output_prop_names;
+            output_prop_names.reserve(d->output_props.size());
+            for (const auto& p : d->output_props) {
+                output_prop_names.push_back(p.first);
+            }
+
+            const std::string key = generate_cache_key(
+                expr_str, &d->vi, vsapi, vi, d->mirror_boundary, d->prop_map,
+                d->vi.width, d->vi.height, d->opt_level, d->approx_math, {},
+                output_prop_names);
+
+            std::unique_lock<std::mutex> lock(cache_mutex);
+            double compile_seconds = 0.0;
+            KernelReport report;
+            const bool miss = !jit_cache.contains(key);
+            if (!miss) {
+                ++jit_cache_counters.hits;
+            } else {
+                ++jit_cache_counters.misses;
+                const auto compile_start = std::chrono::steady_clock::now();
+                size_t key_hash = std::hash<std::string>{}(key);
+                std::string func_name =
+                    kernelName("SingleExpr", -1, d->tokens, key_hash);
+
+                try {
+                    const TraceTarget trace_target(d->trace_file);
+                    analysis::ExpressionAnalysisResults results(
+                        *d->analysis_manager);
+                    Compiler compiler(
+                        std::vector<Token>(d->tokens), &d->vi, vi, d->vi.width,
+                        d->vi.height, d->mirror_boundary, d->dump_ir_path,
+                        d->prop_map, func_name, d->opt_level, d->approx_math,
+                        {}, results, ExprMode::SINGLE_EXPR, output_prop_names);
+                    if (jitDebugEnabled()) {
+                        compiler.set_debug_sources(
+                            {writeDebugSource(func_name, d->source)});
+                    }
+                    if (!d->report_path.empty()) {
+                        compiler.set_report(&report);
+                    }
+                    jit_cache[key] = compiler.compile();
+                } catch (const std::exception& e) {
+                    for (const auto& frame : src_frames) {
+                        vsapi->freeFrame(frame);
+                    }
+                    vsapi->freeFrame(dst_frame);
+                    throw;
+                }
+                compile_seconds =
+                    std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - compile_start)
+                        .count();
+                jit_cache_counters.compile_seconds += compile_seconds;
+            }
+            d->compiled = jit_cache.at(key);
+            d->stats->planes[0].recordCompile(compile_seconds,
+                                              d->compiled.approx_math);
+            lock.unlock();
+
+            if (miss && !d->report_path.empty()) {
+                try {
+                    estimateThroughput(report);
+                    appendKernelReport(d->report_path, report);
+                } catch (const std::exception& e) {
+                    for (const auto& frame : src_frames) {
+                        vsapi->freeFrame(frame);
+                    }
+                    vsapi->freeFrame(dst_frame);
+                    throw;
+                }
+            }
+        }
+
+        const KernelTimer timer(d);
+        d->compiled.func_ptr(d, rwptrs.data(), strides.data(), props.data());
+        const double seconds = timer.record(0, 0, 0, 0);
+        ++d->stats->frames;
+
+        // Resolve prop types and write to output frame
+        enum class ResolvedPropWriteType : std::uint8_t { INT, FLOAT };
+        std::vector<ResolvedPropWriteType> resolved_types;
+        resolved_types.reserve(d->output_props.size());
+        const VSMap* src_props = vsapi->getFramePropertiesRO(src_frames[0]);
+
+        for (const auto& prop_info : d->output_props) {
+            const auto& prop_name = prop_info.first;
+            const auto prop_write_type = prop_info.second;
+
+            switch (prop_write_type) {
+            case PropWriteType::INT:
+                resolved_types.push_back(ResolvedPropWriteType::INT);
+                break;
+            case PropWriteType::FLOAT:
+                resolved_types.push_back(ResolvedPropWriteType::FLOAT);
+                break;
+            case PropWriteType::DELETE:
+                // The prop will be deleted so anything is fine.
+                resolved_types.push_back(ResolvedPropWriteType::FLOAT);
+                break;
+            case PropWriteType::AUTO_INT:
+            case PropWriteType::AUTO_FLOAT:
+                int existing_type =
+                    vsapi->mapGetType(src_props, prop_name.c_str());
+                if (existing_type == ptInt) {
+                    resolved_types.push_back(ResolvedPropWriteType::INT);
+                } else if (existing_type == ptFloat) {
+                    resolved_types.push_back(ResolvedPropWriteType::FLOAT);
+                } else {
+                    if (prop_write_type == PropWriteType::AUTO_INT) {
+                        resolved_types.push_back(ResolvedPropWriteType::INT);
+                    } else {
+                        resolved_types.push_back(ResolvedPropWriteType::FLOAT);
+                    }
+                }
+                break;
+            }
+        }
+
+        VSMap* dst_props = vsapi->getFramePropertiesRW(dst_frame);
+        for (size_t i = 0; i < d->output_props.size(); ++i) {
+            const auto& prop_name = d->output_props[i].first;
+            float value = props[1 + d->required_props.size() + i];
+
+            if (std::bit_cast<uint32_t>(value) == PROP_WRITE_NAN_PAYLOAD) {
+                continue;
+            }
+
+            if (std::bit_cast<uint32_t>(value) == PROP_DELETE_NAN_PAYLOAD) {
+                vsapi->mapDeleteKey(dst_props, prop_name.c_str());
+                continue;
+            }
+
+            if (resolved_types[i] == ResolvedPropWriteType::INT) {
+                auto int_value = static_cast<int64_t>(lroundf(value));
+                vsapi->mapSetInt(dst_props, prop_name.c_str(), int_value,
+                                 maReplace);
+            } else { // FLOAT
+                vsapi->mapSetFloat(dst_props, prop_name.c_str(), value,
+                                   maReplace);
+            }
+        }
+        if (d->stats_mode >= 1) {
+            vsapi->mapSetFloat(dst_props, FRAME_TIME_PROP, seconds, maReplace);
+        }
+
+        for (const auto& frame : src_frames) {
+            vsapi->freeFrame(frame);
+        }
+        return dst_frame;
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+singleExprCreate(const VSMap* in, VSMap* out, [[maybe_unused]] void* userData,
+                 VSCore* core, const VSAPI* vsapi) {
+    auto d = std::make_unique<SingleExprData>();
+    int err = 0;
+
+    try {
+        validateAndInitClips<false>(d.get(), in, vsapi);
+        parseFormatParam(d.get(), in, vsapi, core);
+        parseTraceParam(d.get(), in, vsapi);
+        const TraceTarget trace_target(d->trace_file);
+        const TraceScope trace("create", "SingleExpr");
+
+        d->mirror_boundary = vsapi->mapGetInt(in, "boundary", 0, &err) != 0;
+
+        const char* expr_str = vsapi->mapGetData(in, "expr", 0, &err);
+        if (err != 0) {
+            throw std::runtime_error("An expression must be provided.");
+        }
+
+        bool use_infix = vsapi->mapGetInt(in, "infix", 0, &err) != 0;
+
+        d->source = expr_str;
+        std::string processed_expr;
+        std::vector<int> source_lines;
+        if (use_infix) {
+            std::map<std::string, std::string> macros;
+            macros["__SINGLEEXPR__"] = "";
+            macros["__WIDTH__"] = std::to_string(d->vi.width);
+            macros["__HEIGHT__"] = std::to_string(d->vi.height);
+            macros["__INPUT_NUM__"] = std::to_string(d->num_inputs);
+            macros["__OUTPUT_BITDEPTH__"] =
+                std::to_string(d->vi.format.bitsPerSample);
+            macros["__OUTPUT_COLORFAMILY__"] =
+                std::to_string(d->vi.format.colorFamily);
+            macros["__SUBSAMPLE_W__"] =
+                std::to_string(d->vi.format.subSamplingW);
+            macros["__SUBSAMPLE_H__"] =
+                std::to_string(d->vi.format.subSamplingH);
+            macros["__OUTPUT_SAMPLETYPE__"] =
+                std::to_string((d->vi.format.sampleType == stFloat) ? 1 : 0);
+
+            for (int i = 0; i < d->num_inputs; ++i) {
+                const VSVideoInfo* input_vi = vsapi->getVideoInfo(d->nodes[i]);
+                macros[std::format("__INPUT_BITDEPTH_{}__", i)] =
+                    std::to_string(input_vi->format.bitsPerSample);
+                macros[std::format("__INPUT_COLORFAMILY_{}__", i)] =
+                    std::to_string(input_vi->format.colorFamily);
+                macros[std::format("__INPUT_SAMPLETYPE_{}__", i)] =
+                    std::to_string(
+                        (input_vi->format.sampleType == stFloat) ? 1 : 0);
+                macros[std::format("__INPUT_WIDTH_{}__", i)] =
+                    std::to_string(input_vi->width);
+                macros[std::format("__INPUT_HEIGHT_{}__", i)] =
+                    std::to_string(input_vi->height);
+                macros[std::format("__INPUT_SUBSAMPLE_W_{}__", i)] =
+                    std::to_string(input_vi->format.subSamplingW);
+                macros[std::format("__INPUT_SUBSAMPLE_H_{}__", i)] =
+                    std::to_string(input_vi->format.subSamplingH);
+            }
+
+            processed_expr =
+                convertInfixToPostfix(expr_str, d->num_inputs,
+                                      infix2postfix::Mode::Single, &macros,
+                                      &source_lines);
+        } else {
+            processed_expr = expr_str;
+        }
+
+        {
+            const TraceScope trace("frontend", "tokenize");
+            d->tokens = tokenize(processed_expr, d->num_inputs,
+                                 ExprMode::SINGLE_EXPR);
+        }
+        applySourceLines(d->tokens, source_lines);
+
+        // Array optimization passes
+        {
+            analysis::AnalysisManager temp_am(d->tokens, d->mirror_boundary, 0);
+            analysis::StaticArrayOptPass static_opt_pass;
+            static_opt_pass.run(d->tokens, temp_am);
+            analysis::DynamicArrayAllocOptPass dyn_opt_pass;
+            dyn_opt_pass.run(d->tokens, temp_am);
+        }
+
+        for (const auto& token : d->tokens) {
+            if (token.type == TokenType::CONSTANT_PLANE_WIDTH ||
+                token.type == TokenType::CONSTANT_PLANE_HEIGHT) {
+                const auto& payload =
+                    std::get<TokenPayload_PlaneDim>(token.payload);
+                if (payload.plane_idx < 0 ||
+                    payload.plane_idx >= d->vi.format.numPlanes) {
+                    throw std::runtime_error(
+                        std::format("Invalid plane index {} in token '{}'",
+                                    payload.plane_idx, token.text));
+                }
+            } else if (token.type == TokenType::CLIP_BOX_ABS_PLANE) {
+                const auto& payload =
+                    std::get<TokenPayload_ClipBox>(token.payload);
+                const VSVideoInfo* input_vi =
+                    vsapi->getVideoInfo(d->nodes[payload.clip_idx]);
+                if (payload.plane_idx < 0 ||
+                    payload.plane_idx >= input_vi->format.numPlanes) {
+                    throw std::runtime_error(
+                        std::format("Invalid plane index {} in token '{}'",
+                                    payload.plane_idx, token.text));
+                }
+            } else if (token.type == TokenType::PLANE_STAT ||
+                       token.type == TokenType::PLANE_HISTOGRAM) {
+                const auto& payload =
+                    std::get<TokenPayload_PlaneStat>(token.payload);
+                const VSVideoInfo* input_vi =
+                    vsapi->getVideoInfo(d->nodes[payload.clip_idx]);
+                if (payload.plane_idx < 0 ||
+                    payload.plane_idx >= input_vi->format.numPlanes) {
+                    throw std::runtime_error(
+                        std::format("Invalid plane index {} in token '{}'",
+                                    payload.plane_idx, token.text));
+                }
+            } else if (token.type == TokenType::PROP_ACCESS ||
+                       token.type == TokenType::PROP_EXISTS) {
+                const auto& payload =
+                    std::get<TokenPayload_PropAccess>(token.payload);
+                auto key = std::make_pair(payload.clip_idx, payload.prop_name);
+                if (!d->prop_map.contains(key)) {
+                    d->prop_map[key] = static_cast<int>(
+                        1 +
+                        d->required_props.size()); // 0 is for frame number N
+                    d->required_props.push_back(key);
+                }
+            } else if (token.type == TokenType::PROP_STORE) {
+                const auto& payload =
+                    std::get<TokenPayload_PropStore>(token.payload);
+                if (!d->output_prop_map.contains(payload.prop_name)) {
+                    d->output_prop_map[payload.prop_name] =
+                        static_cast<int>(d->output_props.size());
+                    d->output_props.emplace_back(payload.prop_name,
+                                                 payload.type);
+                }
+            }
+        }
+
+        auto analyser = std::make_unique<analysis::AnalysisManager>(
+            d->tokens, d->mirror_boundary, 0);
+        {
+            const TraceScope trace("frontend", "analyze");
+            analysis::ExpressionAnalyzer expr_analyzer(*analyser);
+            expr_analyzer.analyze();
+        }
+        d->integral_planes =
+            analyser->getResult<analysis::IntegralUsagePass>().planes;
+        d->analysis_manager = std::move(analyser);
+
+        parseCommonParams(d.get(), in, vsapi);
+
+    } catch (const std::exception& e) {
+        for (auto* node : d->nodes) {
+            if (node != nullptr) {
+                vsapi->freeNode(node);
+            }
+        }
+        vsapi->mapSetError(out,
+                           std::format("SingleExpr: {}", e.what()).c_str());
+        return;
+    }
+
+    std::vector<VSFilterDependency> deps;
+    deps.reserve(d->nodes.size());
+    for (auto* node : d->nodes) {
+        deps.push_back({node, rpStrictSpatial});
+    }
+
+    VSVideoInfo* vi_ptr = &d->vi;
+    registerStats(d.get(), "SingleExpr", 1);
+
+    vsapi->createVideoFilter(out, "SingleExpr", vi_ptr, singleExprGetFrame,
+                             singleExprFree, fmParallel, deps.data(),
+                             static_cast<int>(deps.size()), d.release(), core);
+}
+
+// Host API for JIT code to manage dynamic arrays
+// TODO: Optimize this.
+extern "C" {
+
+float* llvmexpr_ensure_buffer(const char* name, int64_t requested_size) {
+    auto& array = g_frame_data.dynamic_arrays[std::string(name)];
+    if (static_cast<size_t>(requested_size) > array.buffer.size()) {
+        array.buffer.resize(requested_size);
+    }
+    return array.buffer.data();
+}
+
+int64_t llvmexpr_get_buffer_size(const char* name) {
+    auto it = g_frame_data.dynamic_arrays.find(std::string(name));
+    return (it != g_frame_data.dynamic_arrays.end())
+               ? static_cast<int64_t>(it->second.buffer.size())
+               : 0;
+}
+
+} // extern "C"
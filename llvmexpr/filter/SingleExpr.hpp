@@ -0,0 +1,29 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_SINGLEEXPR_HPP
+#define LLVMEXPR_FILTER_SINGLEEXPR_HPP
+
+#include "VapourSynth4.h"
+
+// SingleExpr(): runs its expression once per frame rather than per pixel.
+void VS_CC singleExprCreate(const VSMap* in, VSMap* out, void* userData,
+                            VSCore* core, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_SINGLEEXPR_HPP
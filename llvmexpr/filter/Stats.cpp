@@ -0,0 +1,142 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Stats.hpp"
+
+#include <format>
+#include <map>
+#include <mutex>
+
+#include "../utils/Trace.hpp"
+#include "FilterData.hpp"
+
+namespace {
+
+// Live instances, by id.
+std::mutex
+    stats_mutex; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::map<int, InstanceStats*>
+    live_stats; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+int next_stats_id =
+    0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
+void registerStats(BaseExprData* d, const char* filter_name, int num_planes) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    d->stats->id = next_stats_id++;
+    d->stats->filter = filter_name;
+    d->stats->num_planes = num_planes;
+    live_stats[d->stats->id] = d->stats.get();
+}
+
+void unregisterStats(BaseExprData* d) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    live_stats.erase(d->stats->id);
+}
+
+KernelTimer::KernelTimer(const BaseExprData* d_in)
+    : d(d_in), start(std::chrono::steady_clock::now()) {
+    if (d->stats_mode >= 2) {
+        hardware_start = readHardwareCounters();
+    }
+}
+
+double KernelTimer::record(int plane, int64_t pixels, int64_t bytes_read,
+                           int64_t bytes_written) const {
+    std::optional<HardwareCounts> hardware;
+    if (hardware_start) {
+        hardware = readHardwareCounters();
+        if (hardware) {
+            *hardware = *hardware - *hardware_start;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds =
+        std::chrono::duration<double>(end - start).count();
+    d->stats->planes.at(plane).record(seconds, pixels, bytes_read,
+                                      bytes_written, hardware);
+    if (d->trace_file != nullptr && traceKernels()) {
+        d->trace_file->addEvent(
+            "kernel",
+            std::format("{} #{} plane {}", d->stats->filter, d->stats->id,
+                        plane),
+            start, end);
+    }
+    return seconds;
+}
+
+double recordKernel(const ExprData* d, const std::vector<int>& kernel_planes,
+                    const KernelTimer& timer) {
+    int64_t pixels = 0;
+    int64_t bytes_read = 0;
+    int64_t bytes_written = 0;
+    for (int plane : kernel_planes) {
+        const int ss_w = plane > 0 ? d->vi.format.subSamplingW : 0;
+        const int ss_h = plane > 0 ? d->vi.format.subSamplingH : 0;
+        const int64_t plane_pixels = static_cast<int64_t>(d->vi.width >> ss_w) *
+                                     (d->vi.height >> ss_h);
+        pixels += plane_pixels;
+        bytes_read += plane_pixels * d->read_bytes_per_pixel.at(plane);
+        bytes_written += plane_pixels * d->write_bytes_per_pixel.at(plane);
+    }
+    return timer.record(kernel_planes.front(), pixels, bytes_read,
+                        bytes_written);
+}
+
+void VS_CC // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+statsCreate(const VSMap* in, VSMap* out, [[maybe_unused]] void* userData,
+            [[maybe_unused]] VSCore* core, const VSAPI* vsapi) {
+    int err = 0;
+    const bool reset = vsapi->mapGetInt(in, "reset", 0, &err) != 0;
+
+    std::string json = R"({"instances": [)";
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    bool first = true;
+    for (const auto& [id, stats] : live_stats) {
+        if (!first) {
+            json += ", ";
+        }
+        first = false;
+        json += std::format(R"({{"id": {}, "filter": "{}", "frames": {}, )"
+                            R"("cache_hits": {}, "cache_tiles": {}, )"
+                            R"("planes": [)",
+                            id, stats->filter, stats->frames.load(),
+                            stats->cache_hits.load(),
+                            stats->cache_tiles.load());
+        for (int plane = 0; plane < stats->num_planes; ++plane) {
+            if (plane > 0) {
+                json += ", ";
+            }
+            json += stats->planes.at(plane).toJson();
+        }
+        json += "]}";
+        if (reset) {
+            stats->frames = 0;
+            stats->cache_hits = 0;
+            stats->cache_tiles = 0;
+            for (auto& plane_stats : stats->planes) {
+                plane_stats.reset();
+            }
+        }
+    }
+    json += "]}";
+    vsapi->mapSetData(out, "stats", json.data(), static_cast<int>(json.size()),
+                      dtUtf8, maReplace);
+}
@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_STATS_HPP
+#define LLVMEXPR_FILTER_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../utils/PerfCounters.hpp"
+#include "../utils/RuntimeStats.hpp"
+
+struct BaseExprData;
+struct ExprData;
+
+constexpr const char* FRAME_TIME_PROP = "_LLVMExprTime";
+
+// Counters of one filter instance, listed by Stats(). An Expr kernel
+// computing several planes is counted under the first; SingleExpr uses
+// plane 0.
+struct InstanceStats {
+    int id = -1; // -1 until registered
+    std::string filter;
+    int num_planes = 0;
+    std::atomic<int64_t> frames{0};
+    std::array<KernelStats, 3> planes;
+    std::atomic<int64_t> cache_tiles{0};
+    std::atomic<int64_t> cache_hits{0};
+};
+
+// Adds the counters of `d` to the instances listed by Stats(), or removes
+// them.
+void registerStats(BaseExprData* d, const char* filter_name, int num_planes);
+void unregisterStats(BaseExprData* d);
+
+// Measures kernel calls for KernelStats: wall time, and hardware counts with
+// stats=2.
+class KernelTimer {
+  public:
+    explicit KernelTimer(const BaseExprData* d_in);
+
+    // Records the time since construction as a call of the kernel of
+    // `plane` and returns it in seconds.
+    double record(int plane, int64_t pixels, int64_t bytes_read,
+                  int64_t bytes_written) const;
+
+  private:
+    const BaseExprData* d;
+    std::chrono::steady_clock::time_point start;
+    std::optional<HardwareCounts> hardware_start;
+};
+
+// Records a call of the kernel computing `kernel_planes` in the instance's
+// stats and returns its time in seconds.
+double recordKernel(const ExprData* d, const std::vector<int>& kernel_planes,
+                    const KernelTimer& timer);
+
+// Stats(): the counters of every live instance as JSON.
+void VS_CC statsCreate(const VSMap* in, VSMap* out, void* userData,
+                       VSCore* core, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_STATS_HPP
@@ -0,0 +1,207 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TileCache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "../analysis/AnalysisResults.hpp"
+#include "../utils/ContentHash.hpp"
+#include "Expr.hpp"
+#include "FilterData.hpp"
+
+namespace {
+
+// Tile size of cached planes, in samples.
+constexpr int CACHE_TILE_WIDTH = 128;
+constexpr int CACHE_TILE_HEIGHT = 32;
+
+} // namespace
+
+void runCachedPlane(ExprData* d, int plane,
+                    const std::vector<const VSFrame*>& src_frames,
+                    VSFrame* dst_frame, uint8_t** rwptrs, const int* strides,
+                    std::vector<float>& props, int64_t& tiles,
+                    int64_t& hits, const VSAPI* vsapi) {
+    TileCache& cache = *d->tile_caches.at(plane);
+    const int width = vsapi->getFrameWidth(dst_frame, plane);
+    const int height = vsapi->getFrameHeight(dst_frame, plane);
+    const int bytes_per_sample = d->vi.format.bytesPerSample;
+    const auto row_bytes = static_cast<size_t>(width) * bytes_per_sample;
+    uint8_t* dst = vsapi->getWritePtr(dst_frame, plane);
+    const ptrdiff_t dst_stride = vsapi->getStride(dst_frame, plane);
+    const int tiles_x = (width + CACHE_TILE_WIDTH - 1) / CACHE_TILE_WIDTH;
+    const int tiles_y = (height + CACHE_TILE_HEIGHT - 1) / CACHE_TILE_HEIGHT;
+
+    // Frame properties are the same for every tile; N is never read.
+    const uint64_t props_hash = hashBytes(
+        reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            const uint8_t*>(props.data() + 1),
+        (props.size() - 1) * sizeof(float), 0);
+    std::vector<uint64_t> hashes(static_cast<size_t>(tiles_x) * tiles_y);
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        const int y0 = std::max(ty * CACHE_TILE_HEIGHT - cache.halo_y, 0);
+        const int y1 =
+            std::min((ty + 1) * CACHE_TILE_HEIGHT + cache.halo_y, height);
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            const int x0 = std::max(tx * CACHE_TILE_WIDTH - cache.halo_x, 0);
+            const int x1 =
+                std::min((tx + 1) * CACHE_TILE_WIDTH + cache.halo_x, width);
+            uint64_t h = props_hash;
+            for (int clip_idx : cache.clips) {
+                const VSFrame* frame = src_frames[clip_idx];
+                const uint8_t* src = vsapi->getReadPtr(frame, plane);
+                const ptrdiff_t stride = vsapi->getStride(frame, plane);
+                const int bps =
+                    vsapi->getVideoFrameFormat(frame)->bytesPerSample;
+                for (int y = y0; y < y1; ++y) {
+                    h = hashBytes(src + y * stride + x0 * bps,
+                                  static_cast<size_t>(x1 - x0) * bps, h);
+                }
+            }
+            hashes[(ty * tiles_x) + tx] = h;
+        }
+    }
+
+    auto copy_tile = [&](int tx, int ty, bool to_cache) {
+        const int x0 = tx * CACHE_TILE_WIDTH;
+        const size_t bytes =
+            static_cast<size_t>(std::min(CACHE_TILE_WIDTH, width - x0)) *
+            bytes_per_sample;
+        const int y1 = std::min((ty + 1) * CACHE_TILE_HEIGHT, height);
+        for (int y = ty * CACHE_TILE_HEIGHT; y < y1; ++y) {
+            uint8_t* frame_row = dst + y * dst_stride + x0 * bytes_per_sample;
+            uint8_t* cache_row =
+                cache.samples.data() + y * row_bytes + x0 * bytes_per_sample;
+            if (to_cache) {
+                std::memcpy(cache_row, frame_row, bytes);
+            } else {
+                std::memcpy(frame_row, cache_row, bytes);
+            }
+        }
+    };
+
+    std::vector<bool> hit(hashes.size());
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.hashes.empty()) {
+            cache.hashes.resize(hashes.size());
+            cache.samples.resize(row_bytes * height);
+        }
+        for (size_t t = 0; t < hashes.size(); ++t) {
+            if (cache.hashes[t] == hashes[t]) {
+                hit[t] = true;
+                copy_tile(static_cast<int>(t) % tiles_x,
+                          static_cast<int>(t) / tiles_x, false);
+                ++hits;
+            }
+        }
+    }
+    tiles += static_cast<int64_t>(hashes.size());
+
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        const int y0 = ty * CACHE_TILE_HEIGHT;
+        const int y1 = std::min(y0 + CACHE_TILE_HEIGHT, height);
+        for (int tx = 0; tx < tiles_x;) {
+            if (hit[(ty * tiles_x) + tx]) {
+                ++tx;
+                continue;
+            }
+            const int run_x0 = tx * CACHE_TILE_WIDTH;
+            while (tx < tiles_x && !hit[(ty * tiles_x) + tx]) {
+                ++tx;
+            }
+            std::array<int32_t, 4> range = {
+                y0, y1, run_x0, std::min(tx * CACHE_TILE_WIDTH, width)};
+            d->compiled.at(plane).func_ptr(range.data(), rwptrs, strides,
+                                           props.data());
+        }
+    }
+
+    // The kernel runs unlocked so that frames fill the cache concurrently;
+    // tiles another frame stored meanwhile for the same inputs are kept.
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (size_t t = 0; t < hashes.size(); ++t) {
+        if (!hit[t] && cache.hashes[t] != hashes[t]) {
+            copy_tile(static_cast<int>(t) % tiles_x,
+                      static_cast<int>(t) / tiles_x, true);
+            cache.hashes[t] = hashes[t];
+        }
+    }
+}
+
+void initCachedPlanes(ExprData* d) {
+    for (int i = 0; i < d->vi.format.numPlanes; ++i) {
+        if (d->plane_op.at(i) != PlaneOp::PO_PROCESS) {
+            continue;
+        }
+        auto cache = std::make_unique<TileCache>();
+        bool cacheable = true;
+        for (const auto& token : d->tokens.at(i)) {
+            switch (token.type) {
+            case TokenType::CLIP_CUR:
+            case TokenType::CLIP_REL:
+            case TokenType::CLIP_INTERP_REL: {
+                const int clip_idx = accessedClip(token);
+                if (!std::ranges::contains(cache->clips, clip_idx)) {
+                    cache->clips.push_back(clip_idx);
+                }
+                break;
+            }
+            case TokenType::CONSTANT_N:
+            case TokenType::CLIP_ABS:
+            case TokenType::CLIP_ABS_PLANE:
+            case TokenType::CLIP_REL_PLANE:
+            case TokenType::CLIP_BOX_REL:
+            case TokenType::CLIP_BOX_ABS:
+            case TokenType::CLIP_BOX_ABS_PLANE:
+            case TokenType::CLIP_PATCH_DIST:
+            case TokenType::CLIP_INTERP_ABS:
+            case TokenType::STORE_ABS:
+            case TokenType::STORE_ABS_PLANE:
+            case TokenType::STORE_OUTPUT:
+            case TokenType::PROP_REDUCE:
+                cacheable = false;
+                break;
+            default:
+                break;
+            }
+        }
+        if (!cacheable) {
+            continue;
+        }
+
+        // Mirrored reads near an edge stay within the same distance of it,
+        // so a symmetric halo also covers them.
+        const auto& rel_access =
+            analysis::ExpressionAnalysisResults(*d->analysis_managers.at(i))
+                .getRelAccessAnalysisResult();
+        cache->halo_x =
+            std::max(std::abs(rel_access.min_rel_x), rel_access.max_rel_x);
+        for (const auto& access : rel_access.unique_rel_y_accesses) {
+            cache->halo_y = std::max(cache->halo_y, std::abs(access.rel_y));
+        }
+        d->tile_caches.at(i) = std::move(cache);
+        d->plane_op.at(i) = PlaneOp::PO_CACHED;
+    }
+}
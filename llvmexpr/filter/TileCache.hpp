@@ -0,0 +1,65 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_FILTER_TILECACHE_HPP
+#define LLVMEXPR_FILTER_TILECACHE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+struct ExprData;
+
+// Output tiles of a PO_CACHED plane from the last frame computing each one,
+// with the hash of the inputs they were computed from (none until a frame
+// computed the tile).
+struct TileCache {
+    std::mutex mutex;
+    std::vector<std::optional<uint64_t>> hashes;
+    std::vector<uint8_t> samples; // dense plane
+    // Clips read by the expression, and how far around a tile it reads.
+    std::vector<int> clips;
+    int halo_x = 0;
+    int halo_y = 0;
+};
+
+constexpr const char* CACHE_HITS_PROP = "_LLVMExprCacheHits";
+constexpr const char* CACHE_TILES_PROP = "_LLVMExprCacheTiles";
+
+// Makes the planes of `d` whose output depends only on a bounded
+// neighbourhood of the inputs and on frame properties PO_CACHED. Planes
+// reading N, absolute or cross-plane positions, box sums or patch distances,
+// or writing anything besides their value are computed as usual.
+void initCachedPlanes(ExprData* d);
+
+// Runs a cached plane: tiles whose inputs (with the halo the expression
+// reads around them) and frame properties hash to the value stored with the
+// cached tile are copied from the cache, the others are computed and stored.
+// Neighbouring tiles of a row that are computed share one call. Adds the
+// number of tiles, and of those taken from the cache, to `tiles` and `hits`.
+void runCachedPlane(ExprData* d, int plane,
+                    const std::vector<const VSFrame*>& src_frames,
+                    VSFrame* dst_frame, uint8_t** rwptrs, const int* strides,
+                    std::vector<float>& props, int64_t& tiles,
+                    int64_t& hits, const VSAPI* vsapi);
+
+#endif // LLVMEXPR_FILTER_TILECACHE_HPP
@@ -25,15 +25,19 @@
 #include "infix2postfix/Preprocessor.hpp"
 #include "infix2postfix/Tokenizer.hpp"
 
+#include "../utils/Trace.hpp"
+
 std::string convertInfixToPostfix(
     const std::string& infix_expr, int num_inputs, infix2postfix::Mode mode,
-    const std::map<std::string, std::string>* predefined_macros) {
+    const std::map<std::string, std::string>* predefined_macros,
+    std::vector<int>* token_lines) {
     try {
         std::string preprocessed_source = infix_expr;
         std::vector<infix2postfix::LineMapping> line_map;
         int library_line_count = 0;
 
         if (predefined_macros != nullptr) {
+            const TraceScope trace("infix", "preprocess");
             infix2postfix::Preprocessor preprocessor(infix_expr);
 
             for (const auto& [name, value] : *predefined_macros) {
@@ -55,19 +59,28 @@ std::string convertInfixToPostfix(
             library_line_count = preprocess_result.library_line_count;
         }
 
-        infix2postfix::Tokenizer tokenizer(preprocessed_source);
-        auto tokens = tokenizer.tokenize();
+        std::vector<infix2postfix::Token> tokens;
+        {
+            const TraceScope trace("infix", "tokenize");
+            infix2postfix::Tokenizer tokenizer(preprocessed_source);
+            tokens = tokenizer.tokenize();
+        }
 
         infix2postfix::AnalysisEngine engine(tokens, mode, num_inputs, line_map,
                                              library_line_count);
-        bool success = engine.runAnalysis();
+        bool success = false;
+        {
+            const TraceScope trace("infix", "analyze");
+            success = engine.runAnalysis();
+        }
 
         if (!success) {
             std::string diagnostics = engine.formatDiagnostics();
             throw std::runtime_error(diagnostics);
         }
 
-        return engine.generateCode();
+        const TraceScope trace("infix", "codegen");
+        return engine.generateCode(token_lines);
     } catch (const std::exception& e) {
         throw std::runtime_error(
             std::format("Infix to postfix conversion error: {}", e.what()));
@@ -23,9 +23,13 @@
 #include "infix2postfix/types.hpp"
 #include <map>
 #include <string>
+#include <vector>
 
+// With `token_lines`, also returns the line of `infix_expr` each postfix
+// token comes from, 0 where unknown.
 std::string convertInfixToPostfix(
     const std::string& infix_expr, int num_inputs, infix2postfix::Mode mode,
-    const std::map<std::string, std::string>* predefined_macros = nullptr);
+    const std::map<std::string, std::string>* predefined_macros = nullptr,
+    std::vector<int>* token_lines = nullptr);
 
 #endif
@@ -0,0 +1,182 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StageFusion.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <variant>
+
+#include "../analysis/ExpressionAnalyzer.hpp"
+#include "../analysis/framework/AnalysisManager.hpp"
+#include "Tokenizer.hpp"
+
+namespace {
+
+// Clip read by a token, or -1 if it does not read a clip.
+int readClip(const Token& token) {
+    return std::visit(
+        [](const auto& payload) -> int {
+            if constexpr (requires { payload.clip_idx; }) {
+                return payload.clip_idx;
+            } else {
+                return -1;
+            }
+        },
+        token.payload);
+}
+
+// Whether the token reads the current pixel of its clip.
+bool readsCurrentPixel(const Token& token) {
+    if (token.type == TokenType::CLIP_CUR) {
+        return true;
+    }
+    if (token.type == TokenType::CLIP_REL) {
+        const auto& payload = std::get<TokenPayload_ClipAccess>(token.payload);
+        return payload.rel_x == 0 && payload.rel_y == 0 && payload.rel_t == 0;
+    }
+    return false;
+}
+
+// Prefixes the variable, label or array name of a token with `prefix`.
+std::string renamed(const Token& token, const std::string& prefix) {
+    return std::visit(
+        [&](const auto& payload) -> std::string {
+            if constexpr (requires { payload.name; }) {
+                std::string text = token.text;
+                text.insert(text.find(payload.name), prefix);
+                return text;
+            } else {
+                return token.text;
+            }
+        },
+        token.payload);
+}
+
+std::string stageValue(int stage) { return std::format("__stage{}", stage); }
+
+} // namespace
+
+std::vector<std::string> fuseStages(const std::vector<std::string>& stages,
+                                    int num_inputs) {
+    const int num_stages = static_cast<int>(stages.size());
+    const auto is_output_control = [](const Token& token) {
+        return token.type == TokenType::EXIT_NO_WRITE ||
+               token.type == TokenType::STORE_ABS ||
+               token.type == TokenType::STORE_OUTPUT ||
+               token.type == TokenType::PROP_REDUCE;
+    };
+
+    // Stages whose value is written to a scratch plane.
+    std::vector<bool> scratch(num_stages, false);
+    std::vector<std::vector<Token>> tokens(num_stages);
+    for (int stage = 0; stage < num_stages; ++stage) {
+        try {
+            tokens[stage] =
+                tokenize(stages[stage], num_inputs + stage, ExprMode::EXPR);
+            analysis::AnalysisManager manager(tokens[stage], false);
+            analysis::ExpressionAnalyzer expr_analyzer(manager);
+            expr_analyzer.analyze();
+        } catch (const std::exception& e) {
+            throw std::runtime_error(
+                std::format("stage {}: {}", stage, e.what()));
+        }
+
+        for (const auto& token : tokens[stage]) {
+            const int clip = readClip(token);
+            if (clip < num_inputs) {
+                if (stage + 1 < num_stages && is_output_control(token)) {
+                    throw std::runtime_error(std::format(
+                        "stage {}: '{}' affects the output and is only "
+                        "allowed in the last stage.",
+                        stage, token.text));
+                }
+                continue;
+            }
+            if (readsCurrentPixel(token)) {
+                continue;
+            }
+            if (token.type != TokenType::CLIP_REL) {
+                throw std::runtime_error(std::format(
+                    "stage {}: '{}' reads stage {} with an unsupported "
+                    "access; an earlier stage can only be read at the "
+                    "current pixel or at a src[x,y] offset.",
+                    stage, token.text, clip - num_inputs));
+            }
+            if (std::get<TokenPayload_ClipAccess>(token.payload).rel_t != 0) {
+                throw std::runtime_error(std::format(
+                    "stage {}: '{}' reads stage {} at another frame; stages "
+                    "only exist for the current frame.",
+                    stage, token.text, clip - num_inputs));
+            }
+            scratch[clip - num_inputs] = true;
+        }
+    }
+
+    // A stage ending a pass splits the chain, so a stage read at the current
+    // pixel may now be read from a later pass and need a scratch plane too.
+    std::vector<int> pass_of(num_stages);
+    for (bool changed = true; changed;) {
+        changed = false;
+        int pass = 0;
+        for (int stage = 0; stage < num_stages; ++stage) {
+            pass_of[stage] = pass;
+            pass += scratch[stage] ? 1 : 0;
+        }
+        for (int stage = 0; stage < num_stages; ++stage) {
+            for (const auto& token : tokens[stage]) {
+                const int source = readClip(token) - num_inputs;
+                if (source >= 0 && !scratch[source] &&
+                    pass_of[source] != pass_of[stage]) {
+                    scratch[source] = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> passes(pass_of.back() + 1);
+    for (int stage = 0; stage < num_stages; ++stage) {
+        std::string& fused = passes[pass_of[stage]];
+        const std::string prefix = std::format("__stage{}_", stage);
+        for (const auto& token : tokens[stage]) {
+            std::string text;
+            if (const int source = readClip(token) - num_inputs; source < 0) {
+                text = renamed(token, prefix);
+            } else if (pass_of[source] == pass_of[stage]) {
+                text = stageValue(source) + "@";
+            } else {
+                // The scratch plane keeps the offset and boundary mode.
+                text = std::format("src{}", num_inputs + pass_of[source]);
+                if (token.type == TokenType::CLIP_REL) {
+                    text += token.text.substr(token.text.find('['));
+                }
+            }
+
+            if (!fused.empty()) {
+                fused += ' ';
+            }
+            fused += text;
+        }
+        if (!scratch[stage] && stage + 1 < num_stages) {
+            fused += std::format(" {}!", stageValue(stage));
+        }
+    }
+    return passes;
+}
@@ -0,0 +1,40 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_STAGEFUSION_HPP
+#define LLVMEXPR_STAGEFUSION_HPP
+
+#include <string>
+#include <vector>
+
+// Fuses a chain of Expr stages (postfix) into as few expressions, or passes,
+// as possible. Stage k reads stage j < k as clip num_inputs + j, either at the
+// current pixel or at a src[x,y] offset.
+//
+// A stage read at an offset, or read by a stage of a later pass, ends its
+// pass: the pass writes that stage's value to a scratch plane, which later
+// passes read as clip num_inputs + q, q being the index of the pass. Within a
+// pass the value of each stage is kept in a variable, and the variables,
+// labels and arrays of every stage are renamed so stages do not share state.
+// The last pass computes the last stage. Throws std::runtime_error naming the
+// stage on invalid input.
+std::vector<std::string> fuseStages(const std::vector<std::string>& stages,
+                                    int num_inputs);
+
+#endif
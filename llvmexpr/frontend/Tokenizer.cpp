@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <charconv>
 #include <cmath>
 #include <cstdlib>
@@ -368,6 +369,16 @@ inline std::optional<Token> parse_store_abs(std::string_view input) {
     return std::nullopt;
 }
 
+inline std::optional<Token> parse_store_output(std::string_view input) {
+    if (auto m = ctre::match<R"(^@([1-9]\d*)$)">(input)) {
+        return Token{.type = TokenType::STORE_OUTPUT,
+                     .text = std::string(input),
+                     .payload = TokenPayload_StoreOutput{
+                         .output_idx = svtoi(m.template get<1>().to_view())}};
+    }
+    return std::nullopt;
+}
+
 inline std::optional<Token> parse_clip_fn(std::string_view input) {
     if (input == "clip") {
         return Token{.type = TokenType::CLIP,
@@ -752,6 +763,31 @@ inline std::optional<Token> parse_sortn(std::string_view input) {
     return std::nullopt;
 }
 
+inline std::optional<Token> parse_block_transform(std::string_view input) {
+    if (auto m = ctre::match<R"(^(dct|idct|wht|hadamard)(\d+)$)">(input)) {
+        int n = svtoi(m.template get<2>().to_view());
+        if (n < 2 || n > 32 || !std::has_single_bit(static_cast<unsigned>(n))) {
+            throw std::runtime_error(std::format(
+                "Invalid transform size in '{}': expected a power of two "
+                "between 2 and 32",
+                input));
+        }
+        const auto name = m.template get<1>().to_view();
+        TransformKind kind = TransformKind::HADAMARD;
+        if (name == "dct") {
+            kind = TransformKind::DCT;
+        } else if (name == "idct") {
+            kind = TransformKind::IDCT;
+        } else if (name == "wht") {
+            kind = TransformKind::WHT;
+        }
+        return Token{.type = TokenType::BLOCK_TRANSFORM,
+                     .text = std::string(input),
+                     .payload = TokenPayload_Transform{.kind = kind, .n = n}};
+    }
+    return std::nullopt;
+}
+
 inline std::optional<Token> parse_label_def(std::string_view input) {
     if (auto m = ctre::match<R"(^#(.+)$)">(input)) {
         return Token{.type = TokenType::LABEL_DEF,
@@ -837,7 +873,7 @@ inline std::optional<Token> parse_array_load(std::string_view input) {
 
 inline std::optional<Token> parse_clip_rel(std::string_view input) {
     if (auto m = ctre::match<
-            R"(^(?:src(\d+)|([x-za-w]))\[\s*(-?\d+)\s*,\s*(-?\d+)\s*\](?::([cm]))?$)">(
+            R"(^(?:src(\d+)|([x-za-w]))\[\s*(-?\d+)\s*,\s*(-?\d+)\s*(?:,\s*(-?\d+)\s*)?\](?::([cm]))?$)">(
             input)) {
         TokenPayload_ClipAccess data;
         if (m.template get<1>()) {
@@ -851,8 +887,11 @@ inline std::optional<Token> parse_clip_rel(std::string_view input) {
 
         // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
         if (m.template get<5>()) {
+            data.rel_t = svtoi(m.template get<5>().to_view());
+        }
+        if (m.template get<6>()) {
             data.has_mode = true;
-            data.use_mirror = (m.template get<5>().to_view() == "m");
+            data.use_mirror = (m.template get<6>().to_view() == "m");
         }
         // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
         return Token{.type = TokenType::CLIP_REL,
@@ -965,6 +1004,242 @@ inline std::optional<Token> parse_clip_abs_plane(std::string_view input) {
     return std::nullopt;
 }
 
+inline std::optional<Token> parse_clip_rel_plane(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\^(\d+)(?:\[\s*(-?\d+)\s*,\s*(-?\d+)\s*\])?(?::([nas]))?$)">(
+            input)) {
+        TokenPayload_ClipRelPlane data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.plane_idx = svtoi(m.template get<3>().to_view());
+
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+        if (m.template get<4>()) {
+            data.rel_x = svtoi(m.template get<4>().to_view());
+            data.rel_y = svtoi(m.template get<5>().to_view());
+        }
+        if (m.template get<6>()) {
+            char siting_char = m.template get<6>().to_view()[0];
+            if (siting_char == 'a') {
+                data.siting = PlaneSiting::AVERAGE;
+            } else if (siting_char == 's') {
+                data.siting = PlaneSiting::COSITED;
+            }
+        }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+        return Token{.type = TokenType::CLIP_REL_PLANE,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_clip_box_rel(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\.box\[\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*\]$)">(
+            input)) {
+        TokenPayload_ClipBox data;
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.x0 = svtoi(m.template get<3>().to_view());
+        data.y0 = svtoi(m.template get<4>().to_view());
+        data.x1 = svtoi(m.template get<5>().to_view());
+        data.y1 = svtoi(m.template get<6>().to_view());
+        if (data.x0 > data.x1 || data.y0 > data.y1) {
+            throw std::runtime_error(std::format(
+                "Invalid box bounds in '{}': expected x0 <= x1 and y0 <= y1",
+                input));
+        }
+        return Token{.type = TokenType::CLIP_BOX_REL,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_clip_box_abs(std::string_view input) {
+    if (auto m =
+            ctre::match<R"(^(?:src(\d+)|([x-za-w]))\.box\[\]$)">(input)) {
+        TokenPayload_ClipBox data;
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        return Token{.type = TokenType::CLIP_BOX_ABS,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_clip_box_abs_plane(std::string_view input) {
+    if (auto m = ctre::match<R"(^(?:src(\d+)|([x-za-w]))\^(\d+)\.box\[\]$)">(
+            input)) {
+        TokenPayload_ClipBox data;
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.plane_idx = svtoi(m.template get<3>().to_view());
+        return Token{.type = TokenType::CLIP_BOX_ABS_PLANE,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_plane_stat(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\^(\d+)\.(sum|mean|min|max|count)$)">(
+            input)) {
+        TokenPayload_PlaneStat data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.plane_idx = svtoi(m.template get<3>().to_view());
+        const auto kind = m.template get<4>().to_view();
+        if (kind == "mean") {
+            data.kind = PlaneStatKind::MEAN;
+        } else if (kind == "min") {
+            data.kind = PlaneStatKind::MIN;
+        } else if (kind == "max") {
+            data.kind = PlaneStatKind::MAX;
+        } else if (kind == "count") {
+            data.kind = PlaneStatKind::COUNT;
+        }
+        return Token{.type = TokenType::PLANE_STAT,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_plane_histogram(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\^(\d+)\.hist\{([a-zA-Z_][a-zA-Z0-9_]*)\}$)">(
+            input)) {
+        TokenPayload_PlaneStat data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.plane_idx = svtoi(m.template get<3>().to_view());
+        data.array_name = std::string(m.template get<4>().to_view());
+        return Token{.type = TokenType::PLANE_HISTOGRAM,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_clip_patch_dist(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\.pdist\[\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(\d+)\s*\]$)">(
+            input)) {
+        TokenPayload_PatchDist data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.dx = svtoi(m.template get<3>().to_view());
+        data.dy = svtoi(m.template get<4>().to_view());
+        data.radius = svtoi(m.template get<5>().to_view());
+        return Token{.type = TokenType::CLIP_PATCH_DIST,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline InterpKind parse_interp_kind(std::string_view name) {
+    if (name == "bilinear") {
+        return InterpKind::BILINEAR;
+    }
+    if (name == "bicubic") {
+        return InterpKind::BICUBIC;
+    }
+    return InterpKind::LANCZOS2;
+}
+
+inline std::optional<Token> parse_clip_interp_rel(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\.(bilinear|bicubic|lanczos2)\[\s*(-?\d+(?:\.\d+)?)\s*,\s*(-?\d+(?:\.\d+)?)\s*\](?::([cm]))?$)">(
+            input)) {
+        TokenPayload_ClipInterp data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.kind = parse_interp_kind(m.template get<3>().to_view());
+
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+        data.rel_x =
+            locale_independent_stod(std::string(m.template get<4>().to_view()));
+        data.rel_y =
+            locale_independent_stod(std::string(m.template get<5>().to_view()));
+        if (m.template get<6>()) {
+            data.has_mode = true;
+            data.use_mirror = (m.template get<6>().to_view() == "m");
+        }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+        return Token{.type = TokenType::CLIP_INTERP_REL,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
+inline std::optional<Token> parse_clip_interp_abs(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^(?:src(\d+)|([x-za-w]))\.(bilinear|bicubic|lanczos2)\[\](?::([mcb]))?$)">(
+            input)) {
+        TokenPayload_ClipInterp data{};
+        if (m.template get<1>()) {
+            data.clip_idx = svtoi(m.template get<1>().to_view());
+        } else if (m.template get<2>()) {
+            data.clip_idx =
+                parse_std_clip_idx(m.template get<2>().to_view()[0]);
+        }
+        data.kind = parse_interp_kind(m.template get<3>().to_view());
+
+        // Same boundary rules as CLIP_ABS: clamped unless told otherwise.
+        data.has_mode = true;
+        if (m.template get<4>()) {
+            char mode_char = m.template get<4>().to_view()[0];
+            if (mode_char == 'm') {
+                data.use_mirror = true;
+            } else if (mode_char == 'b') {
+                data.has_mode = false;
+            }
+        }
+        return Token{.type = TokenType::CLIP_INTERP_ABS,
+                     .text = std::string(input),
+                     .payload = data};
+    }
+    return std::nullopt;
+}
+
 inline std::optional<Token> parse_store_abs_plane(std::string_view input) {
     if (auto m = ctre::match<R"(^@\[\]\^(\d+)$)">(input)) {
         int plane_idx = svtoi(m.template get<1>().to_view());
@@ -1005,6 +1280,29 @@ inline std::optional<Token> parse_prop_store(std::string_view input) {
     return std::nullopt;
 }
 
+inline std::optional<Token> parse_prop_reduce(std::string_view input) {
+    if (auto m = ctre::match<
+            R"(^([a-zA-Z_][a-zA-Z0-9_]*)\$(sum|min|max|count)$)">(input)) {
+        const auto suffix = m.template get<2>().to_view();
+        ReduceKind kind = ReduceKind::SUM;
+        if (suffix == "min") {
+            kind = ReduceKind::MIN;
+        } else if (suffix == "max") {
+            kind = ReduceKind::MAX;
+        } else if (suffix == "count") {
+            kind = ReduceKind::COUNT;
+        }
+
+        return Token{
+            .type = TokenType::PROP_REDUCE,
+            .text = std::string(input),
+            .payload = TokenPayload_PropReduce{
+                .prop_name = std::string(m.template get<1>().to_view()),
+                .kind = kind}};
+    }
+    return std::nullopt;
+}
+
 inline std::optional<Token> parse_number(std::string_view input) {
     if (auto m = ctre::match<
             R"(^(?:(0x[0-9a-fA-F]+(?:\.[0-9a-fA-F]+(?:p[+\-]?\d+)?)?)|(0[0-7]+)|([+\-]?\d+(?:\.\d+)?(?:[eE][+\-]?\d+)?))$)">(
@@ -1057,6 +1355,11 @@ inline TokenBehavior sortn_behavior(const Token& t) {
     return {.arity = payload.n, .stack_effect = 0};
 }
 
+inline TokenBehavior block_transform_behavior(const Token& t) {
+    const auto& payload = std::get<TokenPayload_Transform>(t.payload);
+    return {.arity = payload.n, .stack_effect = 0};
+}
+
 inline TokenBehavior prop_store_behavior(const Token& t) {
     const auto& payload = std::get<TokenPayload_PropStore>(t.payload);
     if (payload.type == PropWriteType::DELETE) {
@@ -1065,6 +1368,14 @@ inline TokenBehavior prop_store_behavior(const Token& t) {
     return {.arity = 1, .stack_effect = -1};
 }
 
+inline TokenBehavior plane_stat_behavior(const Token& t) {
+    const auto& payload = std::get<TokenPayload_PlaneStat>(t.payload);
+    if (payload.kind == PlaneStatKind::COUNT) {
+        return {.arity = 2, .stack_effect = -1};
+    }
+    return {.arity = 0, .stack_effect = 1};
+}
+
 // Compile-time token definitions table
 constexpr auto get_token_definitions() {
     return std::array{
@@ -1299,6 +1610,13 @@ constexpr auto get_token_definitions() {
                         .parser = parse_store_abs,
                         .available_in_expr = true,
                         .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::STORE_OUTPUT,
+                        .name = "@N",
+                        .behavior =
+                            TokenBehavior{.arity = 1, .stack_effect = -1},
+                        .parser = parse_store_output,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
         TokenDefinition{.type = TokenType::CLIP,
                         .name = "clip",
                         .behavior =
@@ -1540,6 +1858,12 @@ constexpr auto get_token_definitions() {
                         .parser = parse_sortn,
                         .available_in_expr = true,
                         .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::BLOCK_TRANSFORM,
+                        .name = "block_transform",
+                        .behavior = DynamicBehaviorFn(block_transform_behavior),
+                        .parser = parse_block_transform,
+                        .available_in_expr = true,
+                        .available_in_single_expr = true},
         TokenDefinition{.type = TokenType::LABEL_DEF,
                         .name = "label_def",
                         .behavior =
@@ -1638,6 +1962,68 @@ constexpr auto get_token_definitions() {
                         .parser = parse_clip_abs_plane,
                         .available_in_expr = false,
                         .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::CLIP_REL_PLANE,
+                        .name = "clip_rel_plane",
+                        .behavior =
+                            TokenBehavior{.arity = 0, .stack_effect = 1},
+                        .parser = parse_clip_rel_plane,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::CLIP_BOX_REL,
+                        .name = "clip_box_rel",
+                        .behavior =
+                            TokenBehavior{.arity = 0, .stack_effect = 1},
+                        .parser = parse_clip_box_rel,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::CLIP_BOX_ABS,
+                        .name = "clip_box_abs",
+                        .behavior =
+                            TokenBehavior{.arity = 4, .stack_effect = -3},
+                        .parser = parse_clip_box_abs,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::CLIP_BOX_ABS_PLANE,
+                        .name = "clip_box_abs_plane",
+                        .behavior =
+                            TokenBehavior{.arity = 4, .stack_effect = -3},
+                        .parser = parse_clip_box_abs_plane,
+                        .available_in_expr = false,
+                        .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::PLANE_STAT,
+                        .name = "plane_stat",
+                        .behavior = DynamicBehaviorFn(plane_stat_behavior),
+                        .parser = parse_plane_stat,
+                        .available_in_expr = false,
+                        .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::PLANE_HISTOGRAM,
+                        .name = "plane_histogram",
+                        .behavior =
+                            TokenBehavior{.arity = 2, .stack_effect = -2},
+                        .parser = parse_plane_histogram,
+                        .available_in_expr = false,
+                        .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::CLIP_PATCH_DIST,
+                        .name = "clip_patch_dist",
+                        .behavior =
+                            TokenBehavior{.arity = 0, .stack_effect = 1},
+                        .parser = parse_clip_patch_dist,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::CLIP_INTERP_REL,
+                        .name = "clip_interp_rel",
+                        .behavior =
+                            TokenBehavior{.arity = 0, .stack_effect = 1},
+                        .parser = parse_clip_interp_rel,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
+        TokenDefinition{.type = TokenType::CLIP_INTERP_ABS,
+                        .name = "clip_interp_abs",
+                        .behavior =
+                            TokenBehavior{.arity = 2, .stack_effect = -1},
+                        .parser = parse_clip_interp_abs,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
         TokenDefinition{.type = TokenType::STORE_ABS_PLANE,
                         .name = "store_abs_plane",
                         .behavior =
@@ -1651,6 +2037,13 @@ constexpr auto get_token_definitions() {
                         .parser = parse_prop_store,
                         .available_in_expr = false,
                         .available_in_single_expr = true},
+        TokenDefinition{.type = TokenType::PROP_REDUCE,
+                        .name = "prop_reduce",
+                        .behavior =
+                            TokenBehavior{.arity = 1, .stack_effect = -1},
+                        .parser = parse_prop_reduce,
+                        .available_in_expr = true,
+                        .available_in_single_expr = false},
         TokenDefinition{.type = TokenType::NUMBER,
                         .name = "number",
                         .behavior =
@@ -1667,6 +2060,8 @@ std::vector<Token> tokenize(const std::string& expr, int num_inputs,
                             ExprMode mode) {
     std::vector<Token> tokens;
     int idx = 0;
+    int line = 1;
+    const char* line_scan = expr.data();
 
     auto is_space = [](char c) { return std::isspace(c); };
     auto to_string_view = [](auto r) {
@@ -1708,36 +2103,23 @@ std::vector<Token> tokenize(const std::string& expr, int num_inputs,
         }
 
         // Post-parse validation for clip indices
-        if (parsed_token->type == TokenType::CLIP_REL ||
-            parsed_token->type == TokenType::CLIP_ABS ||
-            parsed_token->type == TokenType::CLIP_CUR) {
-            if (std::get<TokenPayload_ClipAccess>(parsed_token->payload)
-                        .clip_idx < 0 ||
-                std::get<TokenPayload_ClipAccess>(parsed_token->payload)
-                        .clip_idx >= num_inputs) {
-                throw std::runtime_error(
-                    std::format("Invalid clip index in token: {} (idx {})",
-                                std::string(str_token_view), idx));
-            }
-        } else if (parsed_token->type == TokenType::PROP_ACCESS) {
-            if (std::get<TokenPayload_PropAccess>(parsed_token->payload)
-                        .clip_idx < 0 ||
-                std::get<TokenPayload_PropAccess>(parsed_token->payload)
-                        .clip_idx >= num_inputs) {
-                throw std::runtime_error(
-                    std::format("Invalid clip index in token: {} (idx {})",
-                                std::string(str_token_view), idx));
-            }
-        } else if (parsed_token->type == TokenType::CLIP_ABS_PLANE) {
-            if (std::get<TokenPayload_ClipAccessPlane>(parsed_token->payload)
-                        .clip_idx < 0 ||
-                std::get<TokenPayload_ClipAccessPlane>(parsed_token->payload)
-                        .clip_idx >= num_inputs) {
-                throw std::runtime_error(
-                    std::format("Invalid clip index in token: {} (idx {})",
-                                std::string(str_token_view), idx));
-            }
-        }
+        std::visit(
+            [&](const auto& payload) {
+                if constexpr (requires { payload.clip_idx; }) {
+                    if (payload.clip_idx < 0 ||
+                        payload.clip_idx >= num_inputs) {
+                        throw std::runtime_error(std::format(
+                            "Invalid clip index in token: {} (idx {})",
+                            std::string(str_token_view), idx));
+                    }
+                }
+            },
+            parsed_token->payload);
+
+        line += static_cast<int>(
+            std::count(line_scan, str_token_view.data(), '\n'));
+        line_scan = str_token_view.data();
+        parsed_token->line = line;
 
         tokens.push_back(*parsed_token);
         idx++;
@@ -1762,3 +2144,26 @@ TokenBehavior get_token_behavior(const Token& token) {
         },
         it->behavior);
 }
+
+int countClips(const std::string& expr) {
+    // Enough for any expression to tokenize before its clips are counted.
+    constexpr int MAX_CLIPS = 1 << 16;
+    int num_clips = 1;
+    for (const auto& token : tokenize(expr, MAX_CLIPS, ExprMode::EXPR)) {
+        std::visit(
+            [&](const auto& payload) {
+                if constexpr (requires { payload.clip_idx; }) {
+                    num_clips = std::max(num_clips, payload.clip_idx + 1);
+                }
+            },
+            token.payload);
+    }
+    return num_clips;
+}
+
+bool hasTemporalAccess(const std::vector<Token>& tokens) {
+    return std::ranges::any_of(tokens, [](const Token& token) {
+        return token.type == TokenType::CLIP_REL &&
+               std::get<TokenPayload_ClipAccess>(token.payload).rel_t != 0;
+    });
+}
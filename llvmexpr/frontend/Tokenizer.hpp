@@ -54,14 +54,30 @@ enum class TokenType : std::uint8_t {
     ARRAY_LOAD,         // arr{}@
 
     // Data Access
-    CLIP_REL,        // src[x,y]
+    CLIP_REL,        // src[x,y] or src[x,y,t]
     CLIP_ABS,        // src[]
     CLIP_CUR,        // src
     PROP_ACCESS,     // src.prop
     PROP_EXISTS,     // src.prop?
     CLIP_ABS_PLANE,  // src^plane[]
+    CLIP_REL_PLANE,  // src^plane[x,y]:siting
     STORE_ABS_PLANE, // @[]^plane
     PROP_STORE,      // prop$
+    PROP_REDUCE,     // prop$sum, prop$min, prop$max, prop$count
+
+    // Integral Image (box sum) Access
+    CLIP_BOX_REL,       // src.box[x0,y0,x1,y1]
+    CLIP_BOX_ABS,       // src.box[]
+    CLIP_BOX_ABS_PLANE, // src^plane.box[]
+    CLIP_PATCH_DIST,    // src.pdist[dx,dy,r]
+
+    // Whole-plane statistics (SingleExpr)
+    PLANE_STAT,      // src^plane.sum, .mean, .min, .max, .count
+    PLANE_HISTOGRAM, // src^plane.hist{arr}
+
+    // Interpolated (sub-pixel) Access
+    CLIP_INTERP_REL, // src.bilinear[x,y], src.bicubic[x,y], src.lanczos2[x,y]
+    CLIP_INTERP_ABS, // src.bilinear[], src.bicubic[], src.lanczos2[]
 
     // Binary Operators
     ADD,
@@ -118,6 +134,9 @@ enum class TokenType : std::uint8_t {
     CLAMP, // same op, 3 args
     FMA,   // 3 args
 
+    // Block transforms
+    BLOCK_TRANSFORM, // dctN, idctN, whtN, hadamardN
+
     // Stack manipulation
     DUP,
     DROP,
@@ -131,6 +150,7 @@ enum class TokenType : std::uint8_t {
     // Custom output control
     EXIT_NO_WRITE, // ^exit^
     STORE_ABS,     // @[]
+    STORE_OUTPUT,  // @N
 };
 
 struct TokenPayload_Number {
@@ -153,6 +173,34 @@ struct TokenPayload_ClipAccess {
     int clip_idx;
     int rel_x = 0;
     int rel_y = 0;
+    int rel_t = 0; // frame offset, CLIP_REL only
+    bool use_mirror = false;
+    bool has_mode = false;
+};
+
+enum class TransformKind : std::uint8_t {
+    DCT,      // orthonormal DCT-II
+    IDCT,     // orthonormal DCT-III (inverse of DCT)
+    WHT,      // orthonormal Walsh-Hadamard, sequency order
+    HADAMARD, // unnormalized Walsh-Hadamard, natural order
+};
+
+struct TokenPayload_Transform {
+    TransformKind kind;
+    int n;
+};
+
+enum class InterpKind : std::uint8_t {
+    BILINEAR, // 2 taps
+    BICUBIC,  // Catmull-Rom, 4 taps
+    LANCZOS2, // 4 taps
+};
+
+struct TokenPayload_ClipInterp {
+    int clip_idx;
+    InterpKind kind;
+    double rel_x = 0.0; // CLIP_INTERP_REL only
+    double rel_y = 0.0;
     bool use_mirror = false;
     bool has_mode = false;
 };
@@ -167,6 +215,52 @@ struct TokenPayload_ClipAccessPlane {
     int plane_idx;
 };
 
+// How a plane with different subsampling is sampled by CLIP_REL_PLANE.
+enum class PlaneSiting : std::uint8_t {
+    NEAREST, // n: a single covering sample
+    AVERAGE, // a: centre siting, box average or linear interpolation
+    COSITED, // s: left siting horizontally, centre siting vertically
+};
+
+struct TokenPayload_ClipRelPlane {
+    int clip_idx;
+    int plane_idx;
+    int rel_x = 0; // in samples of the referenced plane
+    int rel_y = 0;
+    PlaneSiting siting = PlaneSiting::NEAREST;
+};
+
+struct TokenPayload_ClipBox {
+    int clip_idx;
+    int plane_idx = -1; // -1 = current plane (Expr)
+    int x0 = 0;         // CLIP_BOX_REL only, inclusive
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+};
+
+struct TokenPayload_PatchDist {
+    int clip_idx;
+    int dx;     // search offset
+    int dy;
+    int radius; // patch radius
+};
+
+enum class PlaneStatKind : std::uint8_t {
+    SUM,
+    MEAN,
+    MIN,
+    MAX,
+    COUNT, // samples in [lo, hi)
+};
+
+struct TokenPayload_PlaneStat {
+    int clip_idx;
+    int plane_idx;
+    PlaneStatKind kind = PlaneStatKind::SUM; // PLANE_STAT only
+    std::string array_name;                  // PLANE_HISTOGRAM only
+};
+
 struct TokenPayload_StoreAbsPlane {
     int plane_idx;
 };
@@ -179,11 +273,28 @@ enum class PropWriteType : std::uint8_t {
     DELETE,     // $d
 };
 
+struct TokenPayload_StoreOutput {
+    int output_idx; // >= 1, output 0 is the value left on the stack
+};
+
 struct TokenPayload_PropStore {
     std::string prop_name;
     PropWriteType type;
 };
 
+// How an Expr reduction combines the values of the pixels it sees.
+enum class ReduceKind : std::uint8_t {
+    SUM,   // $sum
+    MIN,   // $min
+    MAX,   // $max
+    COUNT, // $count, values > 0
+};
+
+struct TokenPayload_PropReduce {
+    std::string prop_name;
+    ReduceKind kind;
+};
+
 struct TokenPayload_PlaneDim {
     int plane_idx;
 };
@@ -210,11 +321,16 @@ struct Token {
                      TokenPayload_ClipAccessPlane, TokenPayload_StoreAbsPlane,
                      TokenPayload_PropStore, TokenPayload_PlaneDim,
                      TokenPayload_ClipDim, TokenPayload_ClipPlaneDim,
-                     TokenPayload_ArrayOp>;
+                     TokenPayload_ArrayOp, TokenPayload_ClipBox,
+                     TokenPayload_PatchDist, TokenPayload_Transform,
+                     TokenPayload_ClipRelPlane, TokenPayload_ClipInterp,
+                     TokenPayload_StoreOutput, TokenPayload_PropReduce,
+                     TokenPayload_PlaneStat>;
 
     TokenType type;
     std::string text;
     PayloadVariant payload;
+    int line = 0; // source line for debug info, 0 = unknown
 };
 
 struct TokenBehavior {
@@ -254,4 +370,11 @@ std::vector<Token> tokenize(const std::string& expr, int num_inputs,
                             ExprMode mode = ExprMode::EXPR);
 TokenBehavior get_token_behavior(const Token& token);
 
+// Number of clips the Expr expression `expr` reads: one more than the
+// largest clip index it uses, and at least 1. For tools that compile an
+// expression without a list of clips.
+int countClips(const std::string& expr);
+// Whether `tokens` read a clip at a frame offset.
+bool hasTemporalAccess(const std::vector<Token>& tokens);
+
 #endif // LLVMEXPR_TOKENIZER_HPP
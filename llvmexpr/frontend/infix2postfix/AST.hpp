@@ -23,6 +23,7 @@
 #include "Symbol.hpp"
 #include "types.hpp"
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <variant>
@@ -106,12 +107,15 @@ struct StaticRelPixelAccessExpr {
     Token clip;
     Token offsetX;
     Token offsetY;
+    std::optional<Token> offsetT; // frame offset, clip[x,y,t]
     std::string boundary_suffix;
     Range range;
 
-    StaticRelPixelAccessExpr(Token c, Token x, Token y, std::string suffix)
+    StaticRelPixelAccessExpr(Token c, Token x, Token y, std::optional<Token> t,
+                             std::string suffix)
         : clip(std::move(c)), offsetX(std::move(x)), offsetY(std::move(y)),
-          boundary_suffix(std::move(suffix)), range(clip.range) {}
+          offsetT(std::move(t)), boundary_suffix(std::move(suffix)),
+          range(clip.range) {}
 };
 
 struct FrameDimensionExpr {
@@ -301,8 +301,10 @@ void ASTPrinter::visit(const PropAccessExpr& expr) {
 }
 
 void ASTPrinter::visit(const StaticRelPixelAccessExpr& expr) {
-    line("StaticRelPixelAccessExpr: {}[{},{}]{}", expr.clip.value,
-         expr.offsetX.value, expr.offsetY.value, expr.boundary_suffix);
+    line("StaticRelPixelAccessExpr: {}[{},{}{}]{}", expr.clip.value,
+         expr.offsetX.value, expr.offsetY.value,
+         expr.offsetT ? "," + expr.offsetT->value : "",
+         expr.boundary_suffix);
 }
 
 void ASTPrinter::visit(const FrameDimensionExpr& expr) {
@@ -24,6 +24,7 @@
 #include "llvmexpr/utils/EnumName.hpp"
 #include <algorithm>
 #include <format>
+#include <map>
 
 namespace infix2postfix {
 
@@ -64,7 +65,7 @@ bool AnalysisEngine::runAnalysis() {
     return !hasErrors();
 }
 
-std::string AnalysisEngine::generateCode() {
+std::string AnalysisEngine::generateCode(std::vector<int>* token_lines) {
     if (!ast || !semantic_analyzer) {
         throw std::runtime_error(
             "Cannot generate code: analysis not run or failed");
@@ -77,7 +78,22 @@ std::string AnalysisEngine::generateCode() {
 
     CodeGenerator code_generator(mode, num_inputs);
 
-    return code_generator.generate(ast.get());
+    std::string code = code_generator.generate(ast.get());
+    if (token_lines != nullptr) {
+        std::map<int, int> original_lines;
+        for (const auto& mapping : line_map) {
+            original_lines[mapping.preprocessed_line] =
+                std::max(mapping.original_line, 0);
+        }
+        *token_lines = code_generator.get_token_lines();
+        if (!line_map.empty()) {
+            for (int& line : *token_lines) {
+                auto it = original_lines.find(line);
+                line = it != original_lines.end() ? it->second : 0;
+            }
+        }
+    }
+    return code;
 }
 
 bool AnalysisEngine::hasErrors() const {
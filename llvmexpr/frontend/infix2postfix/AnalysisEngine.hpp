@@ -60,7 +60,10 @@ class AnalysisEngine {
 
     bool runAnalysis();
 
-    std::string generateCode();
+    // With `token_lines`, also returns the line of the original source each
+    // postfix token was generated from (0 for the standard library and
+    // generated code).
+    std::string generateCode(std::vector<int>* token_lines = nullptr);
 
     [[nodiscard]] const Program* getAST() const { return ast.get(); }
     Program* getAST() { return ast.get(); }
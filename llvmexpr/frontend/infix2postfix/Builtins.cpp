@@ -21,6 +21,7 @@
 #include "AST.hpp"
 #include "CodeGenerator.hpp"
 #include "PostfixBuilder.hpp"
+#include <array>
 #include <format>
 #include <string>
 
@@ -90,6 +91,243 @@ PostfixBuilder handle_dyn_single(CodeGenerator* codegen, const CallExpr& expr) {
     return b;
 }
 
+PostfixBuilder handle_box_sum_expr(CodeGenerator* codegen,
+                                   const CallExpr& expr) {
+    // Signature: box_sum($clip, x0, y0, x1, y1)
+    PostfixBuilder b;
+    for (size_t i = 1; i <= 4; ++i) {
+        b.append(codegen->generate_expr(expr.args[i].get()).postfix);
+    }
+
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    b.add_box_sum_expr(clip_name);
+    return b;
+}
+
+PostfixBuilder handle_box_sum_single(CodeGenerator* codegen,
+                                     const CallExpr& expr) {
+    // Signature: box_sum($clip, x0, y0, x1, y1, plane)
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    auto* plane_expr = get_if<NumberExpr>(expr.args[5].get());
+    std::string plane_idx = plane_expr->value.value;
+
+    PostfixBuilder b;
+    for (size_t i = 1; i <= 4; ++i) {
+        b.append(codegen->generate_expr(expr.args[i].get()).postfix);
+    }
+    b.add_box_sum_single(clip_name, plane_idx);
+    return b;
+}
+
+PostfixBuilder handle_plane_stat(CodeGenerator* codegen, const CallExpr& expr,
+                                 const std::string& kind) {
+    // Signature: plane_<kind>($clip, plane), plane_count_if($clip, plane, lo,
+    // hi)
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    auto* plane_expr = get_if<NumberExpr>(expr.args[1].get());
+    std::string plane_idx = plane_expr->value.value;
+
+    PostfixBuilder b;
+    for (size_t i = 2; i < expr.args.size(); ++i) {
+        b.append(codegen->generate_expr(expr.args[i].get()).postfix);
+    }
+    b.add_plane_stat(clip_name, plane_idx, kind);
+    return b;
+}
+
+const auto handle_plane_sum = [](CodeGenerator* codegen, const CallExpr& expr) {
+    return handle_plane_stat(codegen, expr, "sum");
+};
+
+const auto handle_plane_mean = [](CodeGenerator* codegen,
+                                const CallExpr& expr) {
+    return handle_plane_stat(codegen, expr, "mean");
+};
+
+const auto handle_plane_min = [](CodeGenerator* codegen, const CallExpr& expr) {
+    return handle_plane_stat(codegen, expr, "min");
+};
+
+const auto handle_plane_max = [](CodeGenerator* codegen, const CallExpr& expr) {
+    return handle_plane_stat(codegen, expr, "max");
+};
+
+const auto handle_plane_count_if = [](CodeGenerator* codegen,
+                                    const CallExpr& expr) {
+    return handle_plane_stat(codegen, expr, "count");
+};
+
+PostfixBuilder handle_plane_histogram(CodeGenerator* codegen,
+                                      const CallExpr& expr) {
+    // Signature: plane_histogram(array, $clip, plane, lo, hi)
+    auto* array_expr = get_if<VariableExpr>(expr.args[0].get());
+    std::string array_name = codegen->get_array_name(*array_expr);
+
+    auto clip_res = codegen->generate_expr(expr.args[1].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    auto* plane_expr = get_if<NumberExpr>(expr.args[2].get());
+    std::string plane_idx = plane_expr->value.value;
+
+    PostfixBuilder b;
+    b.append(codegen->generate_expr(expr.args[3].get()).postfix);
+    b.append(codegen->generate_expr(expr.args[4].get()).postfix);
+    b.add_plane_histogram(clip_name, plane_idx, array_name);
+    return b;
+}
+
+std::string get_integer_literal(CodeGenerator* codegen, const CallExpr& expr,
+                                size_t arg_idx) {
+    std::string value =
+        codegen->generate_expr(expr.args[arg_idx].get()).postfix.get_expression();
+    if (value.find_first_of(".eE") != std::string::npos) {
+        throw CodeGenError(
+            std::format("{}() expects integer literals, got '{}'",
+                        expr.callee, value),
+            expr.range);
+    }
+    return value;
+}
+
+PostfixBuilder handle_box_sum_rel(CodeGenerator* codegen,
+                                  const CallExpr& expr) {
+    // Signature: box_sum_rel($clip, x0, y0, x1, y1), offsets are literals
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    std::array<std::string, 4> bounds;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        bounds.at(i) = get_integer_literal(codegen, expr, i + 1);
+    }
+
+    PostfixBuilder b;
+    b.add_box_sum_rel(clip_name, bounds[0], bounds[1], bounds[2], bounds[3]);
+    return b;
+}
+
+PostfixBuilder handle_patch_distance(CodeGenerator* codegen,
+                                     const CallExpr& expr) {
+    // Signature: patch_distance($clip, dx, dy, radius), all literals
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    std::string dx = get_integer_literal(codegen, expr, 1);
+    std::string dy = get_integer_literal(codegen, expr, 2);
+    std::string radius = get_integer_literal(codegen, expr, 3);
+    if (radius.starts_with("-")) {
+        throw CodeGenError(
+            std::format("patch_distance() radius must be non-negative, got {}",
+                        radius),
+            expr.range);
+    }
+
+    PostfixBuilder b;
+    b.add_patch_distance(clip_name, dx, dy, radius);
+    return b;
+}
+
+// Boundary suffix for absolute access: 0 = global, 1 = mirrored, 2 = clamped.
+std::string get_abs_boundary_suffix(const CallExpr& expr, size_t arg_idx) {
+    auto* boundary_expr = get_if<NumberExpr>(expr.args[arg_idx].get());
+    int boundary_mode = std::stoi(boundary_expr->value.value);
+    switch (boundary_mode) {
+    case 0:
+        return ":b";
+    case 1:
+        return ":m";
+    case 2:
+        return ":c";
+    default:
+        throw CodeGenError(std::format("Invalid boundary mode '{}' for {}()",
+                                       boundary_mode, expr.callee),
+                           expr.range);
+    }
+}
+
+PostfixBuilder handle_interp_expr(CodeGenerator* codegen,
+                                  const CallExpr& expr) {
+    // Signature: bilinear($clip, x, y[, boundary_mode]), likewise for
+    // bicubic() and lanczos2(). Default boundary mode is clamped.
+    PostfixBuilder b;
+    b.append(codegen->generate_expr(expr.args[1].get()).postfix);
+    b.append(codegen->generate_expr(expr.args[2].get()).postfix);
+
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    std::string suffix;
+    if (expr.args.size() == 4) {
+        suffix = get_abs_boundary_suffix(expr, 3);
+    }
+    b.add_interp_access_expr(clip_name, expr.callee, suffix);
+    return b;
+}
+
+PostfixBuilder handle_interp_rel(CodeGenerator* codegen,
+                                 const CallExpr& expr) {
+    // Signature: bilinear_rel($clip, dx, dy), offsets are decimal literals
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    std::array<std::string, 2> offsets;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        std::string value =
+            codegen->generate_expr(expr.args[i + 1].get()).postfix.get_expression();
+        if (value.find_first_not_of("-.0123456789") != std::string::npos) {
+            throw CodeGenError(
+                std::format("{}() expects decimal literals, got '{}'",
+                            expr.callee, value),
+                expr.range);
+        }
+        offsets.at(i) = value;
+    }
+
+    std::string kind = expr.callee.substr(0, expr.callee.size() - 4);
+    PostfixBuilder b;
+    b.add_interp_access_rel(clip_name, kind, offsets[0], offsets[1]);
+    return b;
+}
+
+PostfixBuilder handle_plane_at(CodeGenerator* codegen, const CallExpr& expr) {
+    // Signature: plane_at($clip, plane[, dx, dy[, siting]]), all literals
+    auto clip_res = codegen->generate_expr(expr.args[0].get());
+    std::string clip_name = clip_res.postfix.get_expression();
+
+    std::string plane_idx = get_integer_literal(codegen, expr, 1);
+    std::string dx = "0";
+    std::string dy = "0";
+    if (expr.args.size() >= 4) {
+        dx = get_integer_literal(codegen, expr, 2);
+        dy = get_integer_literal(codegen, expr, 3);
+    }
+
+    std::string suffix;
+    if (expr.args.size() == 5) {
+        std::string siting = get_integer_literal(codegen, expr, 4);
+        if (siting == "0") {
+            suffix = "";
+        } else if (siting == "1") {
+            suffix = ":a";
+        } else if (siting == "2") {
+            suffix = ":s";
+        } else {
+            throw CodeGenError(
+                std::format("Invalid siting '{}' for plane_at()", siting),
+                expr.range);
+        }
+    }
+
+    PostfixBuilder b;
+    b.add_plane_access(clip_name, plane_idx, dx, dy, suffix);
+    return b;
+}
+
 PostfixBuilder handle_store_expr(CodeGenerator* codegen, const CallExpr& expr) {
     // store(x, y, val)
     PostfixBuilder b;
@@ -154,6 +392,37 @@ PostfixBuilder handle_remove_prop([[maybe_unused]] CodeGenerator* codegen,
     return b;
 }
 
+PostfixBuilder handle_reduce(CodeGenerator* codegen, const CallExpr& expr,
+                             const std::string& kind) {
+    // reduce_*(prop_name, value)
+    auto* prop_name_expr = get_if<VariableExpr>(expr.args[0].get());
+
+    PostfixBuilder b;
+    b.append(codegen->generate_expr(expr.args[1].get()).postfix);
+    b.add_reduce(prop_name_expr->name.value, kind);
+    return b;
+}
+
+const auto handle_reduce_sum = [](CodeGenerator* codegen,
+                                  const CallExpr& expr) {
+    return handle_reduce(codegen, expr, "sum");
+};
+
+const auto handle_reduce_min = [](CodeGenerator* codegen,
+                                  const CallExpr& expr) {
+    return handle_reduce(codegen, expr, "min");
+};
+
+const auto handle_reduce_max = [](CodeGenerator* codegen,
+                                  const CallExpr& expr) {
+    return handle_reduce(codegen, expr, "max");
+};
+
+const auto handle_reduce_count = [](CodeGenerator* codegen,
+                                    const CallExpr& expr) {
+    return handle_reduce(codegen, expr, "count");
+};
+
 PostfixBuilder handle_exit([[maybe_unused]] CodeGenerator* codegen,
                            [[maybe_unused]] const CallExpr& expr) {
     PostfixBuilder b;
@@ -174,6 +443,61 @@ PostfixBuilder handle_is_prop_exist(CodeGenerator* codegen,
     return b;
 }
 
+PostfixBuilder handle_block_transform(CodeGenerator* codegen,
+                                      const CallExpr& expr, int n) {
+    // Signature: <transform>N(array, [start, step])
+    // Transforms array[start + i * step] for i in [0, N) in place.
+    auto* array_expr = get_if<VariableExpr>(expr.args[0].get());
+    std::string array_name = codegen->get_array_name(*array_expr);
+
+    int start = 0;
+    int step = 1;
+    if (expr.args.size() == 3) {
+        start = std::stoi(get_integer_literal(codegen, expr, 1));
+        step = std::stoi(get_integer_literal(codegen, expr, 2));
+    }
+
+    PostfixBuilder b;
+    for (int i = 0; i < n; ++i) {
+        b.add_number(std::to_string(start + (i * step)));
+        b.add_array_load(array_name);
+    }
+    b.add_block_transform(expr.callee);
+    for (int i = n - 1; i >= 0; --i) {
+        b.add_number(std::to_string(start + (i * step)));
+        b.add_array_store(array_name);
+    }
+    return b;
+}
+
+// Registers dctN, idctN, whtN and hadamardN for every supported size.
+void add_block_transform_builtins(
+    std::map<std::string, std::vector<BuiltinFunction>>& functions) {
+    for (const char* kind : {"dct", "idct", "wht", "hadamard"}) {
+        for (int n = 2; n <= 32; n *= 2) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            std::string name = std::format("{}{}", kind, n);
+            auto handler = [n](CodeGenerator* codegen, const CallExpr& expr) {
+                return handle_block_transform(codegen, expr, n);
+            };
+            functions[name] = {
+                BuiltinFunction{.name = name,
+                                .arity = 1,
+                                .mode_restriction = std::nullopt,
+                                .param_types = {Type::Array},
+                                .special_handler = handler,
+                                .returns_value = false},
+                BuiltinFunction{.name = name,
+                                .arity = 3,
+                                .mode_restriction = std::nullopt,
+                                .param_types = {Type::Array, Type::Literal,
+                                                Type::Literal},
+                                .special_handler = handler,
+                                .returns_value = false},
+            };
+        }
+    }
+}
+
 // nth_N functions are not handled here
 const std::map<std::string, std::vector<BuiltinFunction>> builtin_functions = {
     // Standard math
@@ -342,6 +666,34 @@ const std::map<std::string, std::vector<BuiltinFunction>> builtin_functions = {
                       .param_types = {Type::Literal_string},
                       .special_handler = handle_remove_prop,
                       .returns_value = false}}},
+    {"reduce_sum",
+     {BuiltinFunction{.name = "reduce_sum",
+                      .arity = 2,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Literal_string, Type::Value},
+                      .special_handler = handle_reduce_sum,
+                      .returns_value = false}}},
+    {"reduce_min",
+     {BuiltinFunction{.name = "reduce_min",
+                      .arity = 2,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Literal_string, Type::Value},
+                      .special_handler = handle_reduce_min,
+                      .returns_value = false}}},
+    {"reduce_max",
+     {BuiltinFunction{.name = "reduce_max",
+                      .arity = 2,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Literal_string, Type::Value},
+                      .special_handler = handle_reduce_max,
+                      .returns_value = false}}},
+    {"reduce_count",
+     {BuiltinFunction{.name = "reduce_count",
+                      .arity = 2,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Literal_string, Type::Value},
+                      .special_handler = handle_reduce_count,
+                      .returns_value = false}}},
     {"is_prop_exist",
      {BuiltinFunction{.name = "is_prop_exist",
                       .arity = 2,
@@ -368,6 +720,159 @@ const std::map<std::string, std::vector<BuiltinFunction>> builtin_functions = {
                                          Type::Literal},
                          .special_handler = &handle_dyn_single},
      }},
+    {"box_sum",
+     {
+         BuiltinFunction{.name = "box_sum",
+                         .arity = 5,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value,
+                                         Type::Value, Type::Value},
+                         .special_handler = &handle_box_sum_expr},
+         BuiltinFunction{.name = "box_sum",
+                         .arity = 6,
+                         .mode_restriction = Mode::Single,
+                         .param_types = {Type::Clip, Type::Value, Type::Value,
+                                         Type::Value, Type::Value,
+                                         Type::Literal},
+                         .special_handler = &handle_box_sum_single},
+     }},
+    {"plane_sum",
+     {BuiltinFunction{.name = "plane_sum",
+                      .arity = 2,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Clip, Type::Literal},
+                      .special_handler = handle_plane_sum}}},
+    {"plane_mean",
+     {BuiltinFunction{.name = "plane_mean",
+                      .arity = 2,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Clip, Type::Literal},
+                      .special_handler = handle_plane_mean}}},
+    {"plane_min",
+     {BuiltinFunction{.name = "plane_min",
+                      .arity = 2,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Clip, Type::Literal},
+                      .special_handler = handle_plane_min}}},
+    {"plane_max",
+     {BuiltinFunction{.name = "plane_max",
+                      .arity = 2,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Clip, Type::Literal},
+                      .special_handler = handle_plane_max}}},
+    {"plane_count_if",
+     {BuiltinFunction{.name = "plane_count_if",
+                      .arity = 4,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Clip, Type::Literal, Type::Value,
+                                      Type::Value},
+                      .special_handler = handle_plane_count_if}}},
+    {"plane_histogram",
+     {BuiltinFunction{.name = "plane_histogram",
+                      .arity = 5,
+                      .mode_restriction = Mode::Single,
+                      .param_types = {Type::Array, Type::Clip, Type::Literal,
+                                      Type::Value, Type::Value},
+                      .special_handler = &handle_plane_histogram,
+                      .returns_value = false}}},
+    {"box_sum_rel",
+     {BuiltinFunction{.name = "box_sum_rel",
+                      .arity = 5,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Clip, Type::Literal, Type::Literal,
+                                      Type::Literal, Type::Literal},
+                      .special_handler = &handle_box_sum_rel}}},
+    {"patch_distance",
+     {BuiltinFunction{.name = "patch_distance",
+                      .arity = 4,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Clip, Type::Literal, Type::Literal,
+                                      Type::Literal},
+                      .special_handler = &handle_patch_distance}}},
+    {"bilinear",
+     {
+         BuiltinFunction{.name = "bilinear",
+                         .arity = 3,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value},
+                         .special_handler = &handle_interp_expr},
+         BuiltinFunction{.name = "bilinear",
+                         .arity = 4,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value,
+                                         Type::Literal},
+                         .special_handler = &handle_interp_expr},
+     }},
+    {"bilinear_rel",
+     {BuiltinFunction{.name = "bilinear_rel",
+                      .arity = 3,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Clip, Type::Literal,
+                                      Type::Literal},
+                      .special_handler = &handle_interp_rel}}},
+    {"bicubic",
+     {
+         BuiltinFunction{.name = "bicubic",
+                         .arity = 3,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value},
+                         .special_handler = &handle_interp_expr},
+         BuiltinFunction{.name = "bicubic",
+                         .arity = 4,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value,
+                                         Type::Literal},
+                         .special_handler = &handle_interp_expr},
+     }},
+    {"bicubic_rel",
+     {BuiltinFunction{.name = "bicubic_rel",
+                      .arity = 3,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Clip, Type::Literal,
+                                      Type::Literal},
+                      .special_handler = &handle_interp_rel}}},
+    {"lanczos2",
+     {
+         BuiltinFunction{.name = "lanczos2",
+                         .arity = 3,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value},
+                         .special_handler = &handle_interp_expr},
+         BuiltinFunction{.name = "lanczos2",
+                         .arity = 4,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Value, Type::Value,
+                                         Type::Literal},
+                         .special_handler = &handle_interp_expr},
+     }},
+    {"lanczos2_rel",
+     {BuiltinFunction{.name = "lanczos2_rel",
+                      .arity = 3,
+                      .mode_restriction = Mode::Expr,
+                      .param_types = {Type::Clip, Type::Literal,
+                                      Type::Literal},
+                      .special_handler = &handle_interp_rel}}},
+    {"plane_at",
+     {
+         BuiltinFunction{.name = "plane_at",
+                         .arity = 2,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Literal},
+                         .special_handler = &handle_plane_at},
+         BuiltinFunction{.name = "plane_at",
+                         .arity = 4,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Literal,
+                                         Type::Literal, Type::Literal},
+                         .special_handler = &handle_plane_at},
+         BuiltinFunction{.name = "plane_at",
+                         .arity = 5,
+                         .mode_restriction = Mode::Expr,
+                         .param_types = {Type::Clip, Type::Literal,
+                                         Type::Literal, Type::Literal,
+                                         Type::Literal},
+                         .special_handler = &handle_plane_at},
+     }},
     {"store",
      {
          BuiltinFunction{.name = "store",
@@ -397,7 +902,12 @@ const std::map<std::string, std::vector<BuiltinFunction>> builtin_functions = {
 
 const std::map<std::string, std::vector<BuiltinFunction>>&
 get_builtin_functions() {
-    return builtin_functions;
+    static const auto functions = [] {
+        auto result = builtin_functions;
+        add_block_transform_builtins(result);
+        return result;
+    }();
+    return functions;
 }
 
 } // namespace infix2postfix
\ No newline at end of file
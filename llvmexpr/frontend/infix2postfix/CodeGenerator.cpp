@@ -38,9 +38,28 @@ std::string CodeGenerator::generate(const Program* program) {
     }
 
     if (mode == Mode::Expr) {
-        main_builder.add_variable_load("RESULT");
+        // RESULTn (n >= 1) are written to the extra outputs, RESULT or
+        // RESULT0 is left on the stack as output 0.
+        std::string main_result = "RESULT";
+        std::map<int, std::string> extra_results;
+        for (const auto& stmt : program->statements) {
+            if (auto* assign = get_if<AssignStmt>(stmt.get())) {
+                const int idx = get_result_index(assign->name.value);
+                if (idx == 0) {
+                    main_result = assign->name.value;
+                } else if (idx > 0) {
+                    extra_results.emplace(idx, assign->name.value);
+                }
+            }
+        }
+        for (const auto& [idx, name] : extra_results) {
+            main_builder.add_variable_load(name);
+            main_builder.add_store_output(idx);
+        }
+        main_builder.add_variable_load(main_result);
     }
 
+    token_lines = main_builder.get_token_lines();
     return main_builder.get_expression();
 }
 
@@ -72,8 +91,11 @@ void CodeGenerator::generate(Stmt* stmt, PostfixBuilder& builder) {
     if (stmt == nullptr) {
         return;
     }
+    const size_t first_token = builder.size();
     std::visit([this, &builder](auto& s) { this->handle(s, builder); },
                stmt->value);
+    // Nested statements have marked their own tokens already.
+    builder.mark_lines(first_token, stmt->range().start.line);
 }
 
 Type CodeGenerator::handle(const NumberExpr& expr, PostfixBuilder& builder) {
@@ -251,8 +273,9 @@ Type CodeGenerator::handle(const StaticRelPixelAccessExpr& expr,
         clip_name = clip_name.substr(1);
     }
 
-    builder.add_static_pixel_access(clip_name, expr.offsetX.value,
-                                    expr.offsetY.value, expr.boundary_suffix);
+    builder.add_static_pixel_access(
+        clip_name, expr.offsetX.value, expr.offsetY.value,
+        expr.offsetT ? expr.offsetT->value : "", expr.boundary_suffix);
     return Type::Value;
 }
 
@@ -264,6 +287,17 @@ Type CodeGenerator::handle(const FrameDimensionExpr& expr,
     return Type::Value;
 }
 
+std::string CodeGenerator::get_array_name(const VariableExpr& expr) const {
+    const std::string& name = expr.name.value;
+    if (var_rename_map.contains(name)) {
+        return var_rename_map.at(name);
+    }
+    if (expr.symbol) {
+        return expr.symbol->name;
+    }
+    return name;
+}
+
 Type CodeGenerator::handle(const ArrayAccessExpr& expr,
                            PostfixBuilder& builder) {
     // Get the array variable name
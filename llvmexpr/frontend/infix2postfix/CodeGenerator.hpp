@@ -53,9 +53,17 @@ class CodeGenerator {
     CodeGenerator(Mode mode, int num_inputs);
 
     std::string generate(const Program* program);
+    // Source line (of the parsed text) of each token of the last program
+    // generated, 0 where unknown.
+    [[nodiscard]] const std::vector<int>& get_token_lines() const {
+        return token_lines;
+    }
 
     [[nodiscard]] Mode get_mode() const { return mode; }
     ExprResult generate_expr(Expr* expr);
+    // Postfix name of the array referenced by `expr`, accounting for
+    // renaming inside inlined functions.
+    [[nodiscard]] std::string get_array_name(const VariableExpr& expr) const;
 
   private:
     Type generate(Expr* expr, PostfixBuilder& builder);
@@ -107,6 +115,8 @@ class CodeGenerator {
     std::vector<int> call_site_id_stack;
 
     std::set<std::string> current_function_labels;
+
+    std::vector<int> token_lines;
 };
 
 } // namespace infix2postfix
@@ -512,8 +512,13 @@ std::unique_ptr<Expr> Parser::parsePostfix() {
             auto index1 = parseTernary();
 
             if (match({TokenType::Comma})) {
-                // Pixel access: array[offsetX, offsetY]
+                // Pixel access: array[offsetX, offsetY] or
+                // array[offsetX, offsetY, offsetT]
                 auto index2 = parseTernary();
+                std::unique_ptr<Expr> index3;
+                if (match({TokenType::Comma})) {
+                    index3 = parseTernary();
+                }
                 consume(TokenType::RBracket, "Expect ']' after indices");
                 std::string suffix;
                 if (match({TokenType::Colon})) {
@@ -522,31 +527,40 @@ std::unique_ptr<Expr> Parser::parsePostfix() {
                     suffix = std::format(":{}", s.value);
                 }
                 if (auto* var = get_if<VariableExpr>(expr.get())) {
-                    auto get_constant_token = [](Expr* e) -> Token* {
+                    auto get_constant_token =
+                        [](Expr* e) -> std::optional<Token> {
                         if (auto* num = get_if<NumberExpr>(e)) {
-                            return &num->value;
+                            return num->value;
                         }
                         if (auto* unary = get_if<UnaryExpr>(e)) {
                             if (unary->op.type == TokenType::Minus) {
                                 if (auto* num = get_if<NumberExpr>(
                                         unary->right.get())) {
-                                    static Token neg_token;
-                                    neg_token = num->value;
+                                    Token neg_token = num->value;
                                     neg_token.value =
                                         std::format("-{}", neg_token.value);
-                                    return &neg_token;
+                                    return neg_token;
                                 }
                             }
                         }
-                        return nullptr;
+                        return std::nullopt;
                     };
 
-                    Token* x_tok = get_constant_token(index1.get());
-                    Token* y_tok = get_constant_token(index2.get());
+                    auto x_tok = get_constant_token(index1.get());
+                    auto y_tok = get_constant_token(index2.get());
+                    std::optional<Token> t_tok;
+                    if (index3) {
+                        t_tok = get_constant_token(index3.get());
+                        if (!t_tok) {
+                            error(peek(),
+                                  "Frame offset of a pixel access must be "
+                                  "a constant.");
+                        }
+                    }
 
-                    if ((x_tok != nullptr) && (y_tok != nullptr)) {
+                    if (x_tok && y_tok) {
                         return make_node<StaticRelPixelAccessExpr>(
-                            var->name, *x_tok, *y_tok, suffix);
+                            var->name, *x_tok, *y_tok, t_tok, suffix);
                     }
                 }
                 error(peek(), "Dynamic pixel access should use dyn().");
@@ -27,6 +27,7 @@ namespace infix2postfix {
 void PostfixBuilder::push_token(const std::string& token) {
     if (!token.empty()) {
         tokens.push_back(token);
+        lines.push_back(0);
     }
 }
 
@@ -159,11 +160,25 @@ void PostfixBuilder::add_delete_prop(const std::string& prop_name) {
     push_token(std::format("{}$d", prop_name));
 }
 
+void PostfixBuilder::add_reduce(const std::string& prop_name,
+                                const std::string& kind) {
+    push_token(std::format("{}${}", prop_name, kind));
+}
+
+void PostfixBuilder::add_store_output(int output_idx) {
+    push_token(std::format("@{}", output_idx));
+}
+
 void PostfixBuilder::add_static_pixel_access(const std::string& clip_name,
                                              const std::string& x,
                                              const std::string& y,
+                                             const std::string& t,
                                              const std::string& suffix) {
-    push_token(std::format("{}[{},{}]{}", clip_name, x, y, suffix));
+    if (t.empty() || t == "0") {
+        push_token(std::format("{}[{},{}]{}", clip_name, x, y, suffix));
+    } else {
+        push_token(std::format("{}[{},{},{}]{}", clip_name, x, y, t, suffix));
+    }
 }
 
 void PostfixBuilder::add_dyn_pixel_access_expr(const std::string& clip_name,
@@ -176,6 +191,63 @@ void PostfixBuilder::add_dyn_pixel_access_single(const std::string& clip_name,
     push_token(std::format("{}^{}[]", clip_name, plane));
 }
 
+void PostfixBuilder::add_box_sum_rel(const std::string& clip_name,
+                                     const std::string& x0,
+                                     const std::string& y0,
+                                     const std::string& x1,
+                                     const std::string& y1) {
+    push_token(std::format("{}.box[{},{},{},{}]", clip_name, x0, y0, x1, y1));
+}
+
+void PostfixBuilder::add_box_sum_expr(const std::string& clip_name) {
+    push_token(std::format("{}.box[]", clip_name));
+}
+
+void PostfixBuilder::add_box_sum_single(const std::string& clip_name,
+                                        const std::string& plane) {
+    push_token(std::format("{}^{}.box[]", clip_name, plane));
+}
+
+void PostfixBuilder::add_plane_stat(const std::string& clip_name,
+                                    const std::string& plane,
+                                    const std::string& kind) {
+    push_token(std::format("{}^{}.{}", clip_name, plane, kind));
+}
+
+void PostfixBuilder::add_plane_histogram(const std::string& clip_name,
+                                         const std::string& plane,
+                                         const std::string& array_name) {
+    push_token(std::format("{}^{}.hist{{{}}}", clip_name, plane, array_name));
+}
+
+void PostfixBuilder::add_patch_distance(const std::string& clip_name,
+                                        const std::string& dx,
+                                        const std::string& dy,
+                                        const std::string& radius) {
+    push_token(std::format("{}.pdist[{},{},{}]", clip_name, dx, dy, radius));
+}
+
+void PostfixBuilder::add_interp_access_expr(const std::string& clip_name,
+                                            const std::string& kind,
+                                            const std::string& suffix) {
+    push_token(std::format("{}.{}[]{}", clip_name, kind, suffix));
+}
+
+void PostfixBuilder::add_interp_access_rel(const std::string& clip_name,
+                                           const std::string& kind,
+                                           const std::string& x,
+                                           const std::string& y) {
+    push_token(std::format("{}.{}[{},{}]", clip_name, kind, x, y));
+}
+
+void PostfixBuilder::add_plane_access(const std::string& clip_name,
+                                      const std::string& plane,
+                                      const std::string& x,
+                                      const std::string& y,
+                                      const std::string& suffix) {
+    push_token(std::format("{}^{}[{},{}]{}", clip_name, plane, x, y, suffix));
+}
+
 void PostfixBuilder::add_store_expr() { push_token("@[]"); }
 
 void PostfixBuilder::add_store_single(const std::string& plane) {
@@ -205,6 +277,10 @@ void PostfixBuilder::add_sortN(int count) {
     push_token(std::format("sort{}", count));
 }
 
+void PostfixBuilder::add_block_transform(const std::string& transform_name) {
+    push_token(transform_name);
+}
+
 void PostfixBuilder::add_array_alloc_static(const std::string& array_name,
                                             const std::string& size) {
     push_token(std::format("{}{{}}^{}", array_name, size));
@@ -253,12 +329,40 @@ std::string PostfixBuilder::get_expression() const {
     return result;
 }
 
-void PostfixBuilder::clear() { tokens.clear(); }
+void PostfixBuilder::clear() {
+    tokens.clear();
+    lines.clear();
+}
 
 bool PostfixBuilder::empty() const { return tokens.empty(); }
 
+size_t PostfixBuilder::size() const { return tokens.size(); }
+
+void PostfixBuilder::mark_lines(size_t from, int line) {
+    for (size_t i = from; i < lines.size(); ++i) {
+        if (lines[i] == 0) {
+            lines[i] = line;
+        }
+    }
+}
+
+std::vector<int> PostfixBuilder::get_token_lines() const {
+    std::vector<int> result;
+    result.reserve(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        // An entry may hold several whitespace-separated tokens.
+        std::stringstream ss(tokens[i]);
+        std::string token;
+        while (ss >> token) {
+            result.push_back(lines[i]);
+        }
+    }
+    return result;
+}
+
 void PostfixBuilder::append(const PostfixBuilder& other) {
     tokens.insert(tokens.end(), other.tokens.begin(), other.tokens.end());
+    lines.insert(lines.end(), other.lines.begin(), other.lines.end());
 }
 
 void PostfixBuilder::prefix_labels(const std::string& prefix) {
@@ -39,6 +39,13 @@ class PostfixBuilder {
     [[nodiscard]] std::string get_expression() const;
     void clear();
     [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+
+    // Source lines: tokens from index `from` on that have no line yet are
+    // attributed to `line`. get_token_lines() returns the line of every
+    // token of get_expression(), 0 where unknown.
+    void mark_lines(size_t from, int line);
+    [[nodiscard]] std::vector<int> get_token_lines() const;
 
     // Literals & Variables
     void add_number(const std::string& num_literal);
@@ -59,13 +66,39 @@ class PostfixBuilder {
                         const std::string& prop_name);
     void add_set_prop(const std::string& prop_name, const std::string& suffix);
     void add_delete_prop(const std::string& prop_name);
+    void add_reduce(const std::string& prop_name, const std::string& kind);
+    void add_store_output(int output_idx);
     void add_static_pixel_access(const std::string& clip_name,
                                  const std::string& x, const std::string& y,
+                                 const std::string& t,
                                  const std::string& suffix);
     void add_dyn_pixel_access_expr(const std::string& clip_name,
                                    const std::string& suffix);
     void add_dyn_pixel_access_single(const std::string& clip_name,
                                      const std::string& plane);
+    void add_box_sum_rel(const std::string& clip_name, const std::string& x0,
+                         const std::string& y0, const std::string& x1,
+                         const std::string& y1);
+    void add_box_sum_expr(const std::string& clip_name);
+    void add_box_sum_single(const std::string& clip_name,
+                            const std::string& plane);
+    void add_plane_stat(const std::string& clip_name, const std::string& plane,
+                        const std::string& kind);
+    void add_plane_histogram(const std::string& clip_name,
+                             const std::string& plane,
+                             const std::string& array_name);
+    void add_patch_distance(const std::string& clip_name,
+                            const std::string& dx, const std::string& dy,
+                            const std::string& radius);
+    void add_interp_access_expr(const std::string& clip_name,
+                                const std::string& kind,
+                                const std::string& suffix);
+    void add_interp_access_rel(const std::string& clip_name,
+                               const std::string& kind, const std::string& x,
+                               const std::string& y);
+    void add_plane_access(const std::string& clip_name,
+                          const std::string& plane, const std::string& x,
+                          const std::string& y, const std::string& suffix);
     void add_store_expr();
     void add_store_single(const std::string& plane);
     void add_frame_dimension(const std::string& dim, const std::string& plane);
@@ -76,6 +109,7 @@ class PostfixBuilder {
     void add_dupN(int count = 0);
     void add_swapN(int count = 1);
     void add_sortN(int count);
+    void add_block_transform(const std::string& transform_name);
 
     // Array operations
     void add_array_alloc_static(const std::string& array_name,
@@ -90,6 +124,8 @@ class PostfixBuilder {
   private:
     void push_token(const std::string& token);
     std::vector<std::string> tokens;
+    std::vector<int> lines; // parallel to tokens
+
 };
 
 } // namespace infix2postfix
@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Report.hpp"
+
+#include <climits>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+#include "../../analysis/AnalysisResults.hpp"
+#include "../../analysis/ExpressionAnalyzer.hpp"
+#include "../../jit/Compiler.hpp"
+#include "../../utils/KernelReport.hpp"
+#include "../Tokenizer.hpp"
+
+namespace infix2postfix {
+
+namespace {
+
+// The defaults of the plugin.
+constexpr int OPT_LEVEL = 5;
+constexpr int APPROX_MATH = 2;
+
+} // namespace
+
+void writeKernelReport(const std::string& postfix, int width, int height,
+                       const std::string& path) {
+    const int num_clips = countClips(postfix);
+    std::vector<::Token> tokens =
+        tokenize(postfix, num_clips, ExprMode::EXPR);
+    if (hasTemporalAccess(tokens)) {
+        throw std::runtime_error(
+            "Reports of expressions with temporal accesses are not "
+            "supported.");
+    }
+
+    VSVideoInfo vi = {};
+    vi.format.colorFamily = cfGray;
+    vi.format.sampleType = stFloat;
+    vi.format.bytesPerSample = sizeof(float);
+    vi.format.bitsPerSample = vi.format.bytesPerSample * CHAR_BIT;
+    vi.format.numPlanes = 1;
+    vi.width = width;
+    vi.height = height;
+    vi.numFrames = 1;
+    const std::vector<const VSVideoInfo*> in_vi(num_clips, &vi);
+
+    std::map<std::pair<int, std::string>, int> prop_map;
+    for (const auto& token : tokens) {
+        if (token.type == ::TokenType::PROP_ACCESS ||
+            token.type == ::TokenType::PROP_EXISTS) {
+            const auto& payload =
+                std::get<TokenPayload_PropAccess>(token.payload);
+            // 0 is for frame number N
+            prop_map.try_emplace({payload.clip_idx, payload.prop_name},
+                                 static_cast<int>(prop_map.size()) + 1);
+        }
+    }
+
+    analysis::AnalysisManager manager(tokens, false);
+    analysis::ExpressionAnalyzer analyzer(manager);
+    analyzer.analyze();
+    const analysis::ExpressionAnalysisResults results(manager);
+
+    Compiler compiler(std::vector<::Token>(tokens), &vi, in_vi, width, height,
+                      false, "", prop_map, "process_infix2postfix", OPT_LEVEL,
+                      APPROX_MATH, LoopOptions{}, results);
+    KernelReport report;
+    compiler.set_report(&report);
+    compiler.compile();
+    estimateThroughput(report);
+
+    if (path == "-") {
+        std::cout << report.format();
+        return;
+    }
+    std::ofstream stream(path);
+    if (!stream) {
+        throw std::runtime_error(
+            std::format("Cannot open report file '{}'.", path));
+    }
+    stream << report.format();
+}
+
+} // namespace infix2postfix
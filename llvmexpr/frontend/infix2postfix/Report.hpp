@@ -0,0 +1,34 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_INFIX2POSTFIX_REPORT_HPP
+#define LLVMEXPR_INFIX2POSTFIX_REPORT_HPP
+
+#include <string>
+
+namespace infix2postfix {
+
+// Compiles the Expr `postfix` for GRAYS clips of `width` x `height` and
+// writes the static report of its kernel to `path`, or to stdout for "-".
+void writeKernelReport(const std::string& postfix, int width, int height,
+                       const std::string& path);
+
+} // namespace infix2postfix
+
+#endif // LLVMEXPR_INFIX2POSTFIX_REPORT_HPP
@@ -238,7 +238,7 @@ bool SemanticAnalyzer::analyze(const Program* program) {
     // Check for unused global variables and functions
     for (const auto& [name, symbol] : global_scope->get_symbols()) {
         if (!symbol->is_used) {
-            if (symbol->name == "RESULT" || symbol->name == "_") {
+            if (get_result_index(symbol->name) >= 0 || symbol->name == "_") {
                 continue;
             }
 
@@ -264,6 +264,12 @@ bool SemanticAnalyzer::analyze(const Program* program) {
             Range{});
     }
 
+    if (mode == Mode::Expr && main_result_names.size() > 1) {
+        reportError("'RESULT' and 'RESULT0' both name output 0; assign only "
+                    "one of them.",
+                    Range{});
+    }
+
     return !hasErrors();
 }
 
@@ -926,13 +932,21 @@ void SemanticAnalyzer::analyze(const ExprStmt& stmt) {
 }
 
 void SemanticAnalyzer::analyze(AssignStmt& stmt) {
-    if (stmt.name.value == "RESULT") {
+    const int result_idx = get_result_index(stmt.name.value);
+    if (stmt.name.value == "RESULT" ||
+        (mode == Mode::Expr && result_idx == 0)) {
         has_result = true;
         if (mode == Mode::Expr) {
+            main_result_names.insert(stmt.name.value);
             if (current_function == nullptr && scope_stack.empty()) {
                 result_defined_in_global_scope = true;
             }
         }
+    } else if (mode == Mode::Expr && result_idx > 0 &&
+               (current_function != nullptr || !scope_stack.empty())) {
+        reportError(std::format("'{}' must be assigned in the global scope.",
+                                stmt.name.value),
+                    stmt.range);
     }
 
     // Check if this is a new() or resize() call for array allocation
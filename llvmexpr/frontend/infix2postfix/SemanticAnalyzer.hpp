@@ -148,6 +148,8 @@ class SemanticAnalyzer {
     int library_line_count;
     bool has_result = false;
     bool result_defined_in_global_scope = false;
+    // Names assigned for output 0 ("RESULT" and/or "RESULT0").
+    std::set<std::string> main_result_names;
 
     std::unique_ptr<SymbolTable> global_scope;
     SymbolTable* current_scope;
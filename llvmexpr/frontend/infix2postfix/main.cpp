@@ -28,13 +28,15 @@
 #include "ASTPrinter.hpp"
 #include "AnalysisEngine.hpp"
 #include "Preprocessor.hpp"
+#include "Report.hpp"
 #include "Tokenizer.hpp"
 
 using namespace infix2postfix;
 
 void print_usage() {
     std::cerr << "Usage: infix2postfix <in.expr> -m [expr/single] -o "
-                 "<out.expr> [-D MACRO[=value]] [--dump-ast] [-E]"
+                 "<out.expr> [-D MACRO[=value]] [--dump-ast] [-E] "
+                 "[--report FILE [--size WxH]]"
               << '\n';
     std::cerr << "Options:\n";
     std::cerr << "  -m MODE         Set mode (expr or single)\n";
@@ -43,6 +45,12 @@ void print_usage() {
     std::cerr << "  --dump-ast      Dump the AST\n";
     std::cerr << "  -E              Output preprocessed code and macro "
                  "expansion trace\n";
+    std::cerr << "  --report FILE   Compile the result (expr mode) and write "
+                 "a static\n"
+                 "                  performance report of the kernel to FILE "
+                 "(- for stdout)\n";
+    std::cerr << "  --size WxH      Frame size of the report (default: "
+                 "1920x1080)\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -51,6 +59,9 @@ int main(int argc, char* argv[]) {
     Mode mode = Mode::Expr;
     bool dump_ast = false;
     bool preprocess_only = false;
+    std::string report_file;
+    int report_width = 1920;  // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    int report_height = 1080; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
     std::vector<std::pair<std::string, std::string>> predefined_macros;
 
     auto args = std::span(argv, argc);
@@ -111,6 +122,24 @@ int main(int argc, char* argv[]) {
             dump_ast = true;
         } else if (arg == "-E") {
             preprocess_only = true;
+        } else if (arg == "--report") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --report requires an argument\n";
+                return 1;
+            }
+            report_file = args[++i];
+        } else if (arg == "--size") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --size requires an argument\n";
+                return 1;
+            }
+            std::istringstream size_stream{std::string(args[++i])};
+            char separator = 0;
+            if (!(size_stream >> report_width >> separator >> report_height) ||
+                separator != 'x' || report_width <= 0 || report_height <= 0) {
+                std::cerr << "Error: --size must be WxH, e.g. 1920x1080\n";
+                return 1;
+            }
         } else {
             std::cerr << std::format("Error: Unknown option '{}'\n",
                                      std::string(arg));
@@ -135,11 +164,15 @@ int main(int argc, char* argv[]) {
             return 1;
         }
     } else {
-        if (output_file.empty()) {
+        if (output_file.empty() && report_file.empty()) {
             std::cerr << "Error: Output file must be specified with -o\n";
             print_usage();
             return 1;
         }
+        if (!report_file.empty() && mode != Mode::Expr) {
+            std::cerr << "Error: --report is only supported in expr mode\n";
+            return 1;
+        }
     }
 
     std::ifstream in_stream(input_file);
@@ -220,16 +253,23 @@ int main(int argc, char* argv[]) {
 
         std::string postfix_code = engine.generateCode();
 
-        std::ofstream out_stream(output_file);
-        if (!out_stream) {
-            std::cerr << std::format("Error: Cannot open output file '{}'\n",
-                                     output_file);
-            return 1;
+        if (!output_file.empty()) {
+            std::ofstream out_stream(output_file);
+            if (!out_stream) {
+                std::cerr << std::format(
+                    "Error: Cannot open output file '{}'\n", output_file);
+                return 1;
+            }
+            out_stream << postfix_code << '\n';
+
+            std::cout << std::format("Successfully converted '{}' to '{}'\n",
+                                     input_file, output_file);
         }
-        out_stream << postfix_code << '\n';
 
-        std::cout << std::format("Successfully converted '{}' to '{}'\n",
-                                 input_file, output_file);
+        if (!report_file.empty()) {
+            writeKernelReport(postfix_code, report_width, report_height,
+                              report_file);
+        }
 
     } catch (const std::exception& e) {
         std::cerr << std::format("An error occurred: {}\n", e.what());
@@ -237,6 +237,20 @@ inline bool is_clip_name(const std::string& s) {
     return get_clip_index(s) != -1;
 }
 
+// Output index of a result variable: RESULT and RESULT0 are output 0, RESULTn
+// is output n. Returns -1 for other names.
+inline int get_result_index(const std::string& s) {
+    if (s == "RESULT" || s == "RESULT0") {
+        return 0;
+    }
+    if (s.size() > 6 && s.starts_with("RESULT") && s[6] != '0' &&
+        std::ranges::all_of(s.substr(6),
+                            [](char c) { return std::isdigit(c) != 0; })) {
+        return std::stoi(s.substr(6));
+    }
+    return -1;
+}
+
 } // namespace infix2postfix
 
 #endif
\ No newline at end of file
@@ -19,8 +19,12 @@
 
 #include "ExprIRGenerator.hpp"
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <format>
+#include <map>
+#include <ranges>
 
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Constants.h"
@@ -29,8 +33,23 @@
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/Instructions.h"
 
+#include "../utils/CpuInfo.hpp"
+#include "../utils/Interpolation.hpp"
+
 constexpr uint32_t EXIT_NAN_PAYLOAD = 0x7FC0E71F; // qNaN with payload 0xE71F
 
+namespace {
+
+// Absolute stores may hit the same pixel from several positions, so kernels
+// using them must keep the row-major write order.
+bool has_abs_store(const std::vector<Token>& tokens) {
+    return std::ranges::any_of(tokens, [](const Token& token) {
+        return token.type == TokenType::STORE_ABS;
+    });
+}
+
+} // namespace
+
 ExprIRGenerator::ExprIRGenerator(
     const std::vector<Token>& tokens_in, const VSVideoInfo* out_vi,
     const std::vector<const VSVideoInfo*>& in_vi, int width_in, int height_in,
@@ -38,11 +57,336 @@ ExprIRGenerator::ExprIRGenerator(
     const analysis::ExpressionAnalysisResults& analysis_results_in,
     llvm::LLVMContext& context_ref, llvm::Module& module_ref,
     llvm::IRBuilder<>& builder_ref, MathLibraryManager& math_mgr,
-    std::string func_name_in, int approx_math_in)
+    std::string func_name_in, int approx_math_in,
+    const LoopOptions& loop_options_in)
     : IRGeneratorBase(tokens_in, out_vi, in_vi, width_in, height_in, mirror,
                       p_map, analysis_results_in, context_ref, module_ref,
                       builder_ref, math_mgr, std::move(func_name_in),
-                      approx_math_in) {}
+                      approx_math_in),
+      loop_options(loop_options_in) {}
+
+void ExprIRGenerator::add_fused_plane(
+    std::unique_ptr<ExprIRGenerator> plane) {
+    fused_planes.push_back(std::move(plane));
+}
+
+int ExprIRGenerator::num_rwptrs() const {
+    return reduction_slot() +
+           (analysis_results.getReductionUsageResult().reductions.empty() ? 0
+                                                                          : 1);
+}
+
+int ExprIRGenerator::first_extra_output_slot() const {
+    // dst, sources, integral tables, patch distance planes, the planes read
+    // by plane-qualified access, then the extra outputs
+    return num_inputs + 1 +
+           static_cast<int>(
+               analysis_results.getIntegralUsageResult().planes.size() +
+               analysis_results.getPatchDistanceUsageResult().patches.size() +
+               analysis_results.getPlaneReadUsageResult().planes.size());
+}
+
+int ExprIRGenerator::reduction_slot() const {
+    return first_extra_output_slot() +
+           static_cast<int>(
+               analysis_results.getOutputUsageResult().outputs.size());
+}
+
+llvm::Value* ExprIRGenerator::row_offset(llvm::Value* y, int rwptr_index) {
+    const int clip_idx = rwptr_index - 1;
+    const int first_patch_slot =
+        num_inputs + 1 +
+        static_cast<int>(
+            analysis_results.getIntegralUsageResult().planes.size());
+    const int num_patches = static_cast<int>(
+        analysis_results.getPatchDistanceUsageResult().patches.size());
+    const bool band = (rwptr_index == 0 && loop_options.band_dst) ||
+                      (clip_idx >= loop_options.band_clip_begin &&
+                       clip_idx < loop_options.band_clip_end) ||
+                      (rwptr_index >= first_patch_slot &&
+                       rwptr_index < first_patch_slot + num_patches);
+    if (band) {
+        y = builder.CreateSub(y, y_origin);
+    }
+    return IRGeneratorBase::row_offset(y, rwptr_index);
+}
+
+void ExprIRGenerator::init_reductions() {
+    for (const auto& reduction :
+         analysis_results.getReductionUsageResult().reductions) {
+        llvm::Type* type = nullptr;
+        llvm::Value* identity = nullptr;
+        switch (reduction.kind) {
+        case ReduceKind::SUM:
+            type = builder.getDoubleTy();
+            identity = llvm::ConstantFP::get(type, 0.0);
+            break;
+        case ReduceKind::COUNT:
+            type = builder.getInt64Ty();
+            identity = builder.getInt64(0);
+            break;
+        case ReduceKind::MIN:
+        case ReduceKind::MAX:
+            type = builder.getFloatTy();
+            identity = llvm::ConstantFP::getInfinity(
+                type, reduction.kind == ReduceKind::MAX);
+            break;
+        }
+        llvm::Value* acc =
+            createAllocaInEntry(type, reduction.prop_name + ".acc");
+        builder.CreateStore(identity, acc);
+        reduction_accs.push_back(acc);
+    }
+}
+
+void ExprIRGenerator::store_reductions() {
+    const auto& reductions =
+        analysis_results.getReductionUsageResult().reductions;
+    for (size_t i = 0; i < reductions.size(); ++i) {
+        llvm::Type* type = llvm::cast<llvm::AllocaInst>(reduction_accs[i])
+                               ->getAllocatedType();
+        llvm::Value* value = builder.CreateLoad(type, reduction_accs[i]);
+        if (reductions[i].kind == ReduceKind::COUNT) {
+            value = builder.CreateUIToFP(value, builder.getDoubleTy());
+        } else if (reductions[i].kind != ReduceKind::SUM) {
+            value = builder.CreateFPExt(value, builder.getDoubleTy());
+        }
+        builder.CreateStore(
+            value, builder.CreateGEP(builder.getDoubleTy(),
+                                     preloaded_base_ptrs[reduction_slot()],
+                                     builder.getInt32(static_cast<int>(i))));
+    }
+}
+
+std::vector<ExprIRGenerator::SampleTap>
+ExprIRGenerator::generate_siting_taps(llvm::Value* pos, int size,
+                                      int src_size, int rel,
+                                      PlaneSiting siting) {
+    llvm::Type* float_ty = builder.getFloatTy();
+    std::vector<SampleTap> taps;
+
+    if (src_size == size) {
+        taps.push_back({.coord = builder.CreateAdd(pos, builder.getInt32(rel)),
+                        .weight = nullptr});
+        return taps;
+    }
+
+    if (src_size > size) {
+        // Each sample of this plane covers `ratio` samples of the source.
+        const int ratio = src_size / size;
+        llvm::Value* first = builder.CreateAdd(
+            builder.CreateShl(pos, std::countr_zero(
+                                       static_cast<unsigned>(ratio))),
+            builder.getInt32(rel));
+        if (siting != PlaneSiting::AVERAGE) {
+            taps.push_back({.coord = first, .weight = nullptr});
+            return taps;
+        }
+        llvm::Value* weight = llvm::ConstantFP::get(float_ty, 1.0 / ratio);
+        for (int i = 0; i < ratio; ++i) {
+            taps.push_back(
+                {.coord = builder.CreateAdd(first, builder.getInt32(i)),
+                 .weight = weight});
+        }
+        return taps;
+    }
+
+    // `ratio` samples of this plane share one sample of the source.
+    const int ratio = size / src_size;
+    if (siting == PlaneSiting::NEAREST) {
+        taps.push_back(
+            {.coord = builder.CreateAdd(
+                 builder.CreateAShr(
+                     pos, std::countr_zero(static_cast<unsigned>(ratio))),
+                 builder.getInt32(rel)),
+             .weight = nullptr});
+        return taps;
+    }
+
+    // Linear interpolation between the two nearest source samples. Centre
+    // sited samples sit in the middle of the `ratio` samples they cover,
+    // left sited ones on the first of them.
+    const double offset =
+        (siting == PlaneSiting::AVERAGE ? (0.5 / ratio) - 0.5 : 0.0) + rel;
+    llvm::Value* src_pos = builder.CreateFAdd(
+        builder.CreateFMul(builder.CreateSIToFP(pos, float_ty),
+                           llvm::ConstantFP::get(float_ty, 1.0 / ratio)),
+        llvm::ConstantFP::get(float_ty, offset));
+    llvm::Value* base = createIntrinsicCall(llvm::Intrinsic::floor, src_pos);
+    llvm::Value* frac = builder.CreateFSub(src_pos, base);
+    llvm::Value* coord = builder.CreateFPToSI(base, builder.getInt32Ty());
+    taps.push_back(
+        {.coord = coord,
+         .weight = builder.CreateFSub(llvm::ConstantFP::get(float_ty, 1.0),
+                                      frac)});
+    taps.push_back({.coord = builder.CreateAdd(coord, builder.getInt32(1)),
+                    .weight = frac});
+    return taps;
+}
+
+llvm::Value*
+ExprIRGenerator::generate_plane_read(const TokenPayload_ClipRelPlane& payload,
+                                     llvm::Value* x, llvm::Value* y) {
+    const VSVideoInfo* vinfo = vi[payload.clip_idx];
+    const VSVideoFormat& format = vinfo->format;
+    const int src_w = payload.plane_idx == 0
+                          ? vinfo->width
+                          : vinfo->width >> format.subSamplingW;
+    const int src_h = payload.plane_idx == 0
+                          ? vinfo->height
+                          : vinfo->height >> format.subSamplingH;
+
+    // MPEG-2 style chroma is only left sited horizontally.
+    const PlaneSiting siting_y = payload.siting == PlaneSiting::COSITED
+                                     ? PlaneSiting::AVERAGE
+                                     : payload.siting;
+    const std::vector<SampleTap> taps_x = generate_siting_taps(
+        x, width, src_w, payload.rel_x, payload.siting);
+    const std::vector<SampleTap> taps_y =
+        generate_siting_taps(y, height, src_h, payload.rel_y, siting_y);
+
+    int slot = // NOLINT(cppcoreguidelines-init-variables)
+        num_inputs + 1 +
+        static_cast<int>(
+            analysis_results.getIntegralUsageResult().planes.size() +
+            analysis_results.getPatchDistanceUsageResult().patches.size()) +
+        analysis_results.getPlaneReadUsageResult().slotOf(payload.clip_idx,
+                                                          payload.plane_idx);
+    const int bpp = format.bytesPerSample;
+
+    llvm::Value* result = nullptr;
+    for (const SampleTap& tap_y : taps_y) {
+        llvm::Value* final_y = get_final_coord(
+            tap_y.coord, builder.getInt32(src_h), mirror_boundary);
+        llvm::Value* row_ptr =
+            builder.CreateGEP(builder.getInt8Ty(), preloaded_base_ptrs[slot],
+                              builder.CreateMul(final_y,
+                                                preloaded_strides[slot]));
+        for (const SampleTap& tap_x : taps_x) {
+            llvm::Value* final_x = get_final_coord(
+                tap_x.coord, builder.getInt32(src_w), mirror_boundary);
+            llvm::Value* pixel_addr = builder.CreateGEP(
+                builder.getInt8Ty(), row_ptr,
+                builder.CreateMul(final_x, builder.getInt32(bpp)));
+            llvm::Value* value = generate_sample_load(pixel_addr, format, slot);
+
+            llvm::Value* weight = tap_x.weight;
+            if (tap_y.weight != nullptr) {
+                weight = weight == nullptr
+                             ? tap_y.weight
+                             : builder.CreateFMul(weight, tap_y.weight);
+            }
+            if (weight != nullptr) {
+                value = builder.CreateFMul(value, weight);
+            }
+            result =
+                result == nullptr ? value : builder.CreateFAdd(result, value);
+        }
+    }
+    return result;
+}
+
+llvm::Value* ExprIRGenerator::generate_interpolated_load(int clip_idx,
+                                                         InterpKind kind,
+                                                         llvm::Value* x_f,
+                                                         llvm::Value* y_f,
+                                                         bool mirror) {
+    // First tap and per-tap weights along one axis. When the position only
+    // depends on Y, all of this is loop invariant and LICM hoists it out of
+    // the x loop.
+    auto axis_taps = [&](llvm::Value* pos) {
+        llvm::Value* base = createIntrinsicCall(llvm::Intrinsic::floor, pos);
+        llvm::Value* first = builder.CreateAdd(
+            builder.CreateFPToSI(base, builder.getInt32Ty()),
+            builder.getInt32(interpolationFirstTap(kind)));
+        return std::make_pair(first, generate_interpolation_weights(
+                                         kind, builder.CreateFSub(pos, base)));
+    };
+    auto [first_x, weights_x] = axis_taps(x_f);
+    auto [first_y, weights_y] = axis_taps(y_f);
+
+    // Separable: filter each row horizontally, then combine the rows.
+    llvm::Value* result = nullptr;
+    for (size_t j = 0; j < weights_y.size(); ++j) {
+        llvm::Value* tap_y = builder.CreateAdd(
+            first_y, builder.getInt32(static_cast<int>(j)));
+        llvm::Value* row = nullptr;
+        for (size_t i = 0; i < weights_x.size(); ++i) {
+            llvm::Value* tap_x = builder.CreateAdd(
+                first_x, builder.getInt32(static_cast<int>(i)));
+            llvm::Value* value = builder.CreateFMul(
+                generate_pixel_load(clip_idx, tap_x, tap_y, mirror),
+                weights_x[i]);
+            row = row == nullptr ? value : builder.CreateFAdd(row, value);
+        }
+        row = builder.CreateFMul(row, weights_y[j]);
+        result = result == nullptr ? row : builder.CreateFAdd(result, row);
+    }
+    return result;
+}
+
+int ExprIRGenerator::resolve_strip_width(
+    const std::vector<ExprIRGenerator*>& kernels) const {
+    const int requested = loop_options.tile_width;
+    if (requested == 0 || loop_options.column_range ||
+        std::ranges::any_of(kernels, [](const ExprIRGenerator* kernel) {
+            return has_abs_store(kernel->tokens);
+        })) {
+        return 0;
+    }
+
+    int strip = requested;
+    if (requested < 0) {
+        // Every row in a clip's vertical stencil span is reused by the next
+        // output row, so that is what has to stay cached per column.
+        bool has_vertical_reuse = false;
+        size_t column_bytes = 0;
+        for (const ExprIRGenerator* kernel : kernels) {
+            std::map<int, std::pair<int, int>> spans;
+            for (const auto& access :
+                 kernel->analysis_results.getRelAccessAnalysisResult()
+                     .unique_rel_y_accesses) {
+                auto [it, inserted] = spans.try_emplace(
+                    access.clip_idx, access.rel_y, access.rel_y);
+                it->second.first = std::min(it->second.first, access.rel_y);
+                it->second.second = std::max(it->second.second, access.rel_y);
+            }
+
+            column_bytes += vo->format.bytesPerSample;
+            for (const auto& [clip_idx, span] : spans) {
+                const int rows = span.second - span.first + 1;
+                has_vertical_reuse = has_vertical_reuse || rows > 1;
+                column_bytes += static_cast<size_t>(rows) *
+                                vi[clip_idx]->format.bytesPerSample;
+            }
+        }
+        if (!has_vertical_reuse) {
+            return 0;
+        }
+
+        // Leave half of L2 for the output stream, stack and everything else.
+        const size_t budget = getL2CacheSize() / 2;
+        if (column_bytes * static_cast<size_t>(width) <= budget) {
+            return 0;
+        }
+        constexpr int STRIP_ALIGN = 64; // whole cache lines, vector friendly
+        strip = static_cast<int>(budget / column_bytes) / STRIP_ALIGN *
+                STRIP_ALIGN;
+        strip = std::max(strip, STRIP_ALIGN);
+    }
+    return strip < width ? strip : 0;
+}
+
+int ExprIRGenerator::resolve_row_block(
+    const std::vector<ExprIRGenerator*>& kernels) const {
+    if (height < loop_options.row_block ||
+        std::ranges::any_of(kernels, [](const ExprIRGenerator* kernel) {
+            return has_abs_store(kernel->tokens);
+        })) {
+        return 1;
+    }
+    return loop_options.row_block;
+}
 
 void ExprIRGenerator::define_function_signature() {
     llvm::Type* void_ty = llvm::Type::getVoidTy(context);
@@ -60,7 +404,11 @@ void ExprIRGenerator::define_function_signature() {
                                   func_name, &module);
     func->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::None);
 
-    // Context argument (index 0) not used in Expr mode
+    // The context argument (index 0) holds the row range when requested and
+    // is unused otherwise.
+    if (loop_options.row_range) {
+        func->addParamAttr(0, llvm::Attribute::ReadOnly);
+    }
     rwptrs_arg = func->getArg(1);
     rwptrs_arg->setName("rwptrs");
     strides_arg = func->getArg(2);
@@ -78,120 +426,301 @@ void ExprIRGenerator::generate_loops() {
     builder.SetInsertPoint(entry_bb);
 
     llvm::Function* parent_func = builder.GetInsertBlock()->getParent();
-    llvm::BasicBlock* loop_y_header =
-        llvm::BasicBlock::Create(context, "loop_y_header", parent_func);
-    llvm::BasicBlock* loop_y_body =
-        llvm::BasicBlock::Create(context, "loop_y_body", parent_func);
-    llvm::BasicBlock* loop_y_exit =
-        llvm::BasicBlock::Create(context, "loop_y_exit", parent_func);
+
+    // Fused planes share this function and its loop nest; each one only emits
+    // its per-pixel code.
+    std::vector<ExprIRGenerator*> kernels = {this};
+    for (const auto& plane : fused_planes) {
+        plane->func = func;
+        plane->rwptrs_arg = rwptrs_arg;
+        plane->strides_arg = strides_arg;
+        plane->props_arg = props_arg;
+        kernels.push_back(plane.get());
+    }
 
     llvm::Value* y_var =
         builder.CreateAlloca(builder.getInt32Ty(), nullptr, "y.var");
     llvm::Value* x_var =
         builder.CreateAlloca(builder.getInt32Ty(), nullptr, "x.var");
-    builder.CreateStore(builder.getInt32(0), y_var);
 
-    const auto& coord_usage = analysis_results.getCoordinateUsageResult();
+    llvm::Value* y_begin = builder.getInt32(0);
+    llvm::Value* y_end = builder.getInt32(height);
+    if (loop_options.row_range) {
+        llvm::Value* range = func->getArg(0);
+        y_begin = builder.CreateLoad(builder.getInt32Ty(), range, "y_begin");
+        y_end = builder.CreateLoad(
+            builder.getInt32Ty(),
+            builder.CreateGEP(builder.getInt32Ty(), range, builder.getInt32(1)),
+            "y_end");
+    }
+    builder.CreateStore(y_begin, y_var);
+    for (ExprIRGenerator* kernel : kernels) {
+        kernel->y_origin = y_begin;
+    }
+
+    const bool uses_x = std::ranges::any_of(kernels, [](const auto* kernel) {
+        return kernel->analysis_results.getCoordinateUsageResult().uses_x;
+    });
+    const bool uses_y = std::ranges::any_of(kernels, [](const auto* kernel) {
+        return kernel->analysis_results.getCoordinateUsageResult().uses_y;
+    });
 
     llvm::Value* x_fp_var = nullptr;
-    if (coord_usage.uses_x) {
+    if (uses_x) {
         x_fp_var = createAllocaInEntry(builder.getFloatTy(), "x_fp.var");
     }
     llvm::Value* y_fp_var = nullptr;
-    if (coord_usage.uses_y) {
+    if (uses_y) {
         y_fp_var = createAllocaInEntry(builder.getFloatTy(), "y_fp.var");
-        builder.CreateStore(llvm::ConstantFP::get(builder.getFloatTy(), 0.0),
-                            y_fp_var);
-    }
-
-    // Index 0 = dst, 1..num_inputs = sources
-    preloaded_base_ptrs.resize(num_inputs + 1);
-    preloaded_strides.resize(num_inputs + 1);
-    for (int i = 0; i <= num_inputs; ++i) {
-        llvm::Value* base_ptr_i = builder.CreateLoad(
-            llvm::PointerType::get(context, 0),
-            builder.CreateGEP(llvm::PointerType::get(context, 0), rwptrs_arg,
-                              builder.getInt32(i)));
-        llvm::Value* stride_i = builder.CreateLoad(
-            builder.getInt32Ty(),
-            builder.CreateGEP(builder.getInt32Ty(), strides_arg,
-                              builder.getInt32(i)));
-        preloaded_base_ptrs[i] = base_ptr_i;
-        preloaded_strides[i] = stride_i;
+        builder.CreateStore(
+            builder.CreateSIToFP(y_begin, builder.getFloatTy()), y_fp_var);
+    }
 
-        assumeAligned(base_ptr_i,
-                      32); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    // rwptrs holds one block per plane, each laid out as: index 0 = dst,
+    // 1..num_inputs = sources, then integral tables and patch distance planes
+    std::vector<int> block_offsets;
+    int total_rwptrs = 0;
+    for (const ExprIRGenerator* kernel : kernels) {
+        block_offsets.push_back(total_rwptrs);
+        total_rwptrs += kernel->num_rwptrs();
     }
 
+    std::vector<llvm::Value*> all_base_ptrs(total_rwptrs);
+    std::vector<llvm::Value*> all_strides(total_rwptrs);
+    for (size_t k = 0; k < kernels.size(); ++k) {
+        for (int i = 0; i < kernels[k]->num_rwptrs(); ++i) {
+            const int slot = block_offsets[k] + i;
+            llvm::Value* base_ptr_i = builder.CreateLoad(
+                llvm::PointerType::get(context, 0),
+                builder.CreateGEP(llvm::PointerType::get(context, 0),
+                                  rwptrs_arg, builder.getInt32(slot)));
+            llvm::Value* stride_i = builder.CreateLoad(
+                builder.getInt32Ty(),
+                builder.CreateGEP(builder.getInt32Ty(), strides_arg,
+                                  builder.getInt32(slot)));
+            all_base_ptrs[slot] = base_ptr_i;
+            all_strides[slot] = stride_i;
+
+            if (i <= num_inputs ||
+                (i >= kernels[k]->first_extra_output_slot() &&
+                 i < kernels[k]->reduction_slot())) {
+                assumeAligned(
+                    base_ptr_i,
+                    32); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            }
+        }
+    }
+
+    // All planes' pointers are given distinct scopes so that no store to one
+    // plane's output is assumed to alias a load from another's input.
     alias_scope_domain = llvm::MDNode::getDistinct(context, {});
-    alias_scopes.resize(num_inputs + 1);
-    for (int i = 0; i <= num_inputs; ++i) {
+    std::vector<llvm::MDNode*> all_scopes(total_rwptrs);
+    for (int i = 0; i < total_rwptrs; ++i) {
         llvm::SmallVector<llvm::Metadata*, 2> elems;
         elems.push_back(nullptr);
         llvm::Metadata* name_node = llvm::MDNode::get(
             context, {llvm::MDString::get(
                          context, std::format("rwptrs_{}", i).c_str())});
         elems.push_back(name_node);
-        alias_scopes[i] = llvm::MDNode::getDistinct(context, elems);
-        alias_scopes[i]->replaceOperandWith(0, alias_scopes[i]);
-    }
-    alias_scope_lists.resize(num_inputs + 1);
-    noalias_scope_lists.resize(num_inputs + 1);
-    for (int i = 0; i <= num_inputs; ++i) {
-        std::vector<llvm::Metadata*> self_list = {alias_scopes[i]};
-        alias_scope_lists[i] = llvm::MDNode::get(context, self_list);
+        all_scopes[i] = llvm::MDNode::getDistinct(context, elems);
+        all_scopes[i]->replaceOperandWith(0, all_scopes[i]);
+    }
+    std::vector<llvm::MDNode*> all_scope_lists(total_rwptrs);
+    std::vector<llvm::MDNode*> all_noalias_lists(total_rwptrs);
+    for (int i = 0; i < total_rwptrs; ++i) {
+        std::vector<llvm::Metadata*> self_list = {all_scopes[i]};
+        all_scope_lists[i] = llvm::MDNode::get(context, self_list);
         std::vector<llvm::Metadata*> others;
-        for (int j = 0; j <= num_inputs; ++j) {
+        for (int j = 0; j < total_rwptrs; ++j) {
             if (j == i) {
                 continue;
             }
-            others.push_back(alias_scopes[j]);
+            others.push_back(all_scopes[j]);
         }
-        noalias_scope_lists[i] = llvm::MDNode::get(context, others);
+        all_noalias_lists[i] = llvm::MDNode::get(context, others);
     }
 
+    for (size_t k = 0; k < kernels.size(); ++k) {
+        auto slice = [&](const auto& all) {
+            auto first = all.begin() + block_offsets[k];
+            return std::vector(first, first + kernels[k]->num_rwptrs());
+        };
+        kernels[k]->preloaded_base_ptrs = slice(all_base_ptrs);
+        kernels[k]->preloaded_strides = slice(all_strides);
+        kernels[k]->alias_scope_domain = alias_scope_domain;
+        kernels[k]->alias_scopes = slice(all_scopes);
+        kernels[k]->alias_scope_lists = slice(all_scope_lists);
+        kernels[k]->noalias_scope_lists = slice(all_noalias_lists);
+    }
+
+    for (ExprIRGenerator* kernel : kernels) {
+        kernel->init_reductions();
+    }
+    // Reductions are accumulated over the whole call and stored on return.
+    auto generate_return = [&]() {
+        for (ExprIRGenerator* kernel : kernels) {
+            kernel->store_reductions();
+        }
+        builder.CreateRetVoid();
+    };
+
+    strip_width = resolve_strip_width(kernels);
+    row_block = resolve_row_block(kernels);
+
+    // With column strips the whole y loop runs once per strip, so the frame
+    // is walked strip by strip and only a strip's rows need to stay cached.
+    // A column range is handled as a single strip.
+    llvm::Value* strip_x = builder.getInt32(0);
+    llvm::Value* strip_end = builder.getInt32(width);
+    llvm::BasicBlock* strip_header = nullptr;
+    llvm::Value* strip_var = nullptr;
+    if (loop_options.column_range) {
+        llvm::Value* range = func->getArg(0);
+        strip_x = builder.CreateLoad(
+            builder.getInt32Ty(),
+            builder.CreateGEP(builder.getInt32Ty(), range, builder.getInt32(2)),
+            "x_begin");
+        strip_end = builder.CreateLoad(
+            builder.getInt32Ty(),
+            builder.CreateGEP(builder.getInt32Ty(), range, builder.getInt32(3)),
+            "x_end");
+    } else if (strip_width > 0) {
+        strip_var = createAllocaInEntry(builder.getInt32Ty(), "strip_x.var");
+        builder.CreateStore(builder.getInt32(0), strip_var);
+
+        strip_header =
+            llvm::BasicBlock::Create(context, "strip_header", parent_func);
+        llvm::BasicBlock* strip_body =
+            llvm::BasicBlock::Create(context, "strip_body", parent_func);
+        llvm::BasicBlock* strip_exit =
+            llvm::BasicBlock::Create(context, "strip_exit", parent_func);
+
+        builder.CreateBr(strip_header);
+        builder.SetInsertPoint(strip_header);
+        strip_x = builder.CreateLoad(builder.getInt32Ty(), strip_var, "strip_x");
+        llvm::Value* strip_cond =
+            builder.CreateICmpSLT(strip_x, builder.getInt32(width));
+        builder.CreateCondBr(strip_cond, strip_body, strip_exit);
+
+        builder.SetInsertPoint(strip_exit);
+        generate_return();
+
+        builder.SetInsertPoint(strip_body);
+        llvm::Value* next_strip_x =
+            builder.CreateAdd(strip_x, builder.getInt32(strip_width));
+        strip_end = builder.CreateSelect(
+            builder.CreateICmpSLT(next_strip_x, builder.getInt32(width)),
+            next_strip_x, builder.getInt32(width), "strip_end");
+        builder.CreateStore(y_begin, y_var);
+        if (uses_y) {
+            builder.CreateStore(
+                builder.CreateSIToFP(y_begin, builder.getFloatTy()), y_fp_var);
+        }
+    }
+
+    const LoopState state{.kernels = kernels,
+                          .x_var = x_var,
+                          .x_fp_var = x_fp_var,
+                          .y_var = y_var,
+                          .y_fp_var = y_fp_var,
+                          .y_end = y_end,
+                          .strip_x = strip_x,
+                          .strip_end = strip_end};
+    if (row_block > 1) {
+        generate_row_loop(state, row_block);
+    }
+    generate_row_loop(state, 1);
+
+    if (strip_width > 0) {
+        builder.CreateStore(
+            builder.CreateAdd(strip_x, builder.getInt32(strip_width)),
+            strip_var);
+        builder.CreateBr(strip_header);
+    } else {
+        generate_return();
+    }
+}
+
+void ExprIRGenerator::generate_row_loop(const LoopState& state, int rows) {
+    llvm::Function* parent_func = builder.GetInsertBlock()->getParent();
+    const std::string suffix = rows > 1 ? std::format("_x{}", rows) : "";
+
+    llvm::BasicBlock* loop_y_header = llvm::BasicBlock::Create(
+        context, "loop_y_header" + suffix, parent_func);
+    llvm::BasicBlock* loop_y_body = llvm::BasicBlock::Create(
+        context, "loop_y_body" + suffix, parent_func);
+    llvm::BasicBlock* loop_y_exit = llvm::BasicBlock::Create(
+        context, "loop_y_exit" + suffix, parent_func);
+
     builder.CreateBr(loop_y_header);
 
     builder.SetInsertPoint(loop_y_header);
-    llvm::Value* y_val = builder.CreateLoad(builder.getInt32Ty(), y_var, "y");
-    llvm::Value* y_cond =
-        builder.CreateICmpSLT(y_val, builder.getInt32(height), "y.cond");
+    llvm::Value* y_val =
+        builder.CreateLoad(builder.getInt32Ty(), state.y_var, "y");
+    llvm::Value* y_cond = builder.CreateICmpSLT(
+        y_val, builder.CreateSub(state.y_end, builder.getInt32(rows - 1)),
+        "y.cond");
     builder.CreateCondBr(y_cond, loop_y_body, loop_y_exit);
 
     builder.SetInsertPoint(loop_y_body);
 
-    // Pre-calculate and cache row pointers
-    row_ptr_cache.clear();
-    const auto& clip_access_result =
-        analysis_results.getRelAccessAnalysisResult();
-    for (const auto& access : clip_access_result.unique_rel_y_accesses) {
-        int clip_idx = access.clip_idx;
-        int vs_clip_idx = clip_idx + 1;
-        int rel_y = access.rel_y;
-
-        llvm::Value* coord_y =
-            builder.CreateAdd(y_val, builder.getInt32(rel_y));
-        llvm::Value* final_y = get_final_coord(
-            coord_y, builder.getInt32(height), access.use_mirror);
-
-        llvm::Value* base_ptr = preloaded_base_ptrs[vs_clip_idx];
-        llvm::Value* stride = preloaded_strides[vs_clip_idx];
-
-        llvm::Value* y_offset = builder.CreateMul(final_y, stride);
-        llvm::Value* row_ptr = builder.CreateGEP(builder.getInt8Ty(), base_ptr,
-                                                 y_offset, "row_ptr");
-        row_ptr_cache[access] = row_ptr;
+    // Pre-calculate and cache row pointers. Row r of the block reading at
+    // rel_y uses the same source row as row 0 reading at rel_y + r, so such
+    // accesses share one pointer and their loads can be CSE'd across rows.
+    int min_rel_x = 0;
+    int max_rel_x = 0;
+    for (ExprIRGenerator* kernel : state.kernels) {
+        const auto& clip_access_result =
+            kernel->analysis_results.getRelAccessAnalysisResult();
+        min_rel_x = std::min(min_rel_x, clip_access_result.min_rel_x);
+        max_rel_x = std::max(max_rel_x, clip_access_result.max_rel_x);
+
+        std::map<analysis::RelYAccess, llvm::Value*> shared_row_ptrs;
+        kernel->block_row_ptrs.assign(rows, {});
+        for (int r = 0; r < rows; ++r) {
+            for (const auto& access :
+                 clip_access_result.unique_rel_y_accesses) {
+                analysis::RelYAccess shifted = access;
+                shifted.rel_y += r;
+                auto it = shared_row_ptrs.find(shifted);
+                if (it == shared_row_ptrs.end()) {
+                    int vs_clip_idx = access.clip_idx + 1;
+
+                    llvm::Value* coord_y = builder.CreateAdd(
+                        y_val, builder.getInt32(shifted.rel_y));
+                    llvm::Value* final_y = get_final_coord(
+                        coord_y, builder.getInt32(height), access.use_mirror);
+
+                    llvm::Value* base_ptr =
+                        kernel->preloaded_base_ptrs[vs_clip_idx];
+
+                    llvm::Value* y_offset =
+                        kernel->row_offset(final_y, vs_clip_idx);
+                    llvm::Value* row_ptr = builder.CreateGEP(
+                        builder.getInt8Ty(), base_ptr, y_offset, "row_ptr");
+                    it = shared_row_ptrs.emplace(shifted, row_ptr).first;
+                }
+                kernel->block_row_ptrs[r][access] = it->second;
+            }
+        }
     }
 
-    llvm::Value* width_val = builder.getInt32(width);
-    llvm::Value* start_main_x = builder.getInt32(-clip_access_result.min_rel_x);
+    auto clamp_to_strip = [&](llvm::Value* bound) -> llvm::Value* {
+        if (strip_width == 0 && !loop_options.column_range) {
+            return bound;
+        }
+        return builder.CreateSelect(
+            builder.CreateICmpSLT(bound, state.strip_end), bound,
+            state.strip_end);
+    };
+    llvm::Value* start_main_x = clamp_to_strip(builder.getInt32(-min_rel_x));
     llvm::Value* end_main_x =
-        builder.getInt32(width - clip_access_result.max_rel_x);
+        clamp_to_strip(builder.getInt32(width - max_rel_x));
 
     bool has_left_peel = // NOLINT(cppcoreguidelines-init-variables)
-        clip_access_result.min_rel_x < 0;
+        min_rel_x < 0;
     bool has_right_peel = // NOLINT(cppcoreguidelines-init-variables)
-        clip_access_result.max_rel_x > 0;
+        max_rel_x > 0;
 
     llvm::BasicBlock* loop_x_start_bb =
         llvm::BasicBlock::Create(context, "loop_x_start", parent_func);
@@ -201,10 +730,11 @@ void ExprIRGenerator::generate_loops() {
     builder.CreateBr(loop_x_start_bb);
     builder.SetInsertPoint(loop_x_start_bb);
 
-    builder.CreateStore(builder.getInt32(0), x_var);
-    if (coord_usage.uses_x) {
-        builder.CreateStore(llvm::ConstantFP::get(builder.getFloatTy(), 0.0),
-                            x_fp_var);
+    builder.CreateStore(state.strip_x, state.x_var);
+    if (state.x_fp_var != nullptr) {
+        builder.CreateStore(
+            builder.CreateSIToFP(state.strip_x, builder.getFloatTy()),
+            state.x_fp_var);
     }
 
     if (has_left_peel) {
@@ -218,14 +748,14 @@ void ExprIRGenerator::generate_loops() {
         builder.CreateBr(left_peel_header);
         builder.SetInsertPoint(left_peel_header);
         llvm::Value* x_val =
-            builder.CreateLoad(builder.getInt32Ty(), x_var, "x_peel_l");
+            builder.CreateLoad(builder.getInt32Ty(), state.x_var, "x_peel_l");
         llvm::Value* cond = builder.CreateICmpSLT(x_val, start_main_x);
         llvm::BranchInst* left_peel_br =
             builder.CreateCondBr(cond, left_peel_body, after_left_peel);
         add_loop_metadata(left_peel_br);
 
         builder.SetInsertPoint(left_peel_body);
-        generate_x_loop_body(x_var, x_fp_var, y_var, y_fp_var, false);
+        generate_x_loop_body(state, rows, false);
         builder.CreateBr(left_peel_header);
 
         builder.SetInsertPoint(after_left_peel);
@@ -241,7 +771,7 @@ void ExprIRGenerator::generate_loops() {
     builder.CreateBr(main_loop_header);
     builder.SetInsertPoint(main_loop_header);
     llvm::Value* x_val_main =
-        builder.CreateLoad(builder.getInt32Ty(), x_var, "x_main");
+        builder.CreateLoad(builder.getInt32Ty(), state.x_var, "x_main");
     llvm::Value* main_cond = builder.CreateICmpSLT(x_val_main, end_main_x);
 
     llvm::BranchInst* loop_br =
@@ -249,7 +779,7 @@ void ExprIRGenerator::generate_loops() {
     add_loop_metadata(loop_br);
 
     builder.SetInsertPoint(main_loop_body);
-    generate_x_loop_body(x_var, x_fp_var, y_var, y_fp_var, true);
+    generate_x_loop_body(state, rows, true);
     builder.CreateBr(main_loop_header);
 
     builder.SetInsertPoint(after_main_loop);
@@ -263,68 +793,82 @@ void ExprIRGenerator::generate_loops() {
         builder.CreateBr(right_peel_header);
         builder.SetInsertPoint(right_peel_header);
         llvm::Value* x_val =
-            builder.CreateLoad(builder.getInt32Ty(), x_var, "x_peel_r");
-        llvm::Value* cond = builder.CreateICmpSLT(x_val, width_val);
+            builder.CreateLoad(builder.getInt32Ty(), state.x_var, "x_peel_r");
+        llvm::Value* cond = builder.CreateICmpSLT(x_val, state.strip_end);
         llvm::BranchInst* right_peel_br =
             builder.CreateCondBr(cond, right_peel_body, loop_x_exit_bb);
         add_loop_metadata(right_peel_br);
 
         builder.SetInsertPoint(right_peel_body);
-        generate_x_loop_body(x_var, x_fp_var, y_var, y_fp_var, false);
+        generate_x_loop_body(state, rows, false);
         builder.CreateBr(right_peel_header);
     } else {
         builder.CreateBr(loop_x_exit_bb);
     }
 
     builder.SetInsertPoint(loop_x_exit_bb);
-    llvm::Value* y_next = builder.CreateAdd(y_val, builder.getInt32(1));
-    builder.CreateStore(y_next, y_var);
-    if (coord_usage.uses_y) {
+    llvm::Value* y_next = builder.CreateAdd(y_val, builder.getInt32(rows));
+    builder.CreateStore(y_next, state.y_var);
+    if (state.y_fp_var != nullptr) {
         llvm::Value* y_fp_val =
-            builder.CreateLoad(builder.getFloatTy(), y_fp_var);
+            builder.CreateLoad(builder.getFloatTy(), state.y_fp_var);
         llvm::Value* y_fp_next = builder.CreateFAdd(
-            y_fp_val, llvm::ConstantFP::get(builder.getFloatTy(), 1.0));
-        builder.CreateStore(y_fp_next, y_fp_var);
+            y_fp_val, llvm::ConstantFP::get(builder.getFloatTy(),
+                                            static_cast<double>(rows)));
+        builder.CreateStore(y_fp_next, state.y_fp_var);
     }
     builder.CreateBr(loop_y_header);
 
     builder.SetInsertPoint(loop_y_exit);
-    builder.CreateRetVoid();
 }
 
-void ExprIRGenerator::generate_x_loop_body(llvm::Value* x_var,
-                                           llvm::Value* x_fp_var,
-                                           llvm::Value* y_var,
-                                           llvm::Value* y_fp_var,
+void ExprIRGenerator::generate_x_loop_body(const LoopState& state, int rows,
                                            bool no_x_bounds_check) {
-    const auto& coord_usage = analysis_results.getCoordinateUsageResult();
-    llvm::Value* x_val = builder.CreateLoad(builder.getInt32Ty(), x_var, "x");
+    llvm::Value* x_val =
+        builder.CreateLoad(builder.getInt32Ty(), state.x_var, "x");
     llvm::Value* y_val =
-        builder.CreateLoad(builder.getInt32Ty(), y_var, "y_in_x_loop");
+        builder.CreateLoad(builder.getInt32Ty(), state.y_var, "y_in_x_loop");
 
     llvm::Value* x_fp = nullptr;
-    if (coord_usage.uses_x) {
-        x_fp = builder.CreateLoad(builder.getFloatTy(), x_fp_var, "x_fp");
+    if (state.x_fp_var != nullptr) {
+        x_fp = builder.CreateLoad(builder.getFloatTy(), state.x_fp_var, "x_fp");
     }
     llvm::Value* y_fp = nullptr;
-    if (coord_usage.uses_y) {
-        y_fp = builder.CreateLoad(builder.getFloatTy(), y_fp_var, "y_fp");
+    if (state.y_fp_var != nullptr) {
+        y_fp = builder.CreateLoad(builder.getFloatTy(), state.y_fp_var, "y_fp");
     }
 
-    generate_ir_from_tokens(x_val, y_val, x_fp, y_fp, no_x_bounds_check);
+    // All rows of the block, and all fused planes, are computed in the same
+    // x iteration, so the vectorizer sees one body in which shared loads and
+    // common subexpressions appear only once.
+    for (int r = 0; r < rows; ++r) {
+        llvm::Value* row_y =
+            r == 0 ? y_val : builder.CreateAdd(y_val, builder.getInt32(r));
+        llvm::Value* row_y_fp = y_fp;
+        if (y_fp != nullptr && r > 0) {
+            row_y_fp = builder.CreateFAdd(
+                y_fp, llvm::ConstantFP::get(builder.getFloatTy(),
+                                            static_cast<double>(r)));
+        }
+        for (ExprIRGenerator* kernel : state.kernels) {
+            kernel->row_ptr_cache = kernel->block_row_ptrs[r];
+            kernel->generate_ir_from_tokens(x_val, row_y, x_fp, row_y_fp,
+                                            no_x_bounds_check);
+        }
+    }
 
     llvm::Value* x_next = builder.CreateAdd(x_val, builder.getInt32(1));
-    builder.CreateStore(x_next, x_var);
-    if (coord_usage.uses_x) {
+    builder.CreateStore(x_next, state.x_var);
+    if (x_fp != nullptr) {
         llvm::Value* x_fp_next = builder.CreateFAdd(
             x_fp, llvm::ConstantFP::get(builder.getFloatTy(), 1.0));
-        builder.CreateStore(x_fp_next, x_fp_var);
+        builder.CreateStore(x_fp_next, state.x_fp_var);
     }
 }
 
 bool ExprIRGenerator::process_mode_specific_token(
     const Token& token, std::vector<llvm::Value*>& rpn_stack, llvm::Value* x,
-    [[maybe_unused]] llvm::Value* y, llvm::Value* x_fp, llvm::Value* y_fp,
+    llvm::Value* y, llvm::Value* x_fp, llvm::Value* y_fp,
     bool no_x_bounds_check) {
     llvm::Type* float_ty = builder.getFloatTy();
     llvm::Type* i32_ty = builder.getInt32Ty();
@@ -392,6 +936,113 @@ bool ExprIRGenerator::process_mode_specific_token(
         return true;
     }
 
+    case TokenType::CLIP_INTERP_REL: {
+        const auto& payload = std::get<TokenPayload_ClipInterp>(token.payload);
+        bool use_mirror = // NOLINT(cppcoreguidelines-init-variables)
+            payload.has_mode ? payload.use_mirror : mirror_boundary;
+        // Constant offsets give constant weights, so the taps are plain
+        // relative reads that vectorize without gathers.
+        llvm::Value* result = nullptr;
+        for (const auto& [rel_y, weight_y] :
+             interpolationTaps(payload.kind, payload.rel_y)) {
+            analysis::RelYAccess access{.clip_idx = payload.clip_idx,
+                                        .rel_y = rel_y,
+                                        .use_mirror = use_mirror};
+            llvm::Value* row_ptr = row_ptr_cache.at(access);
+            for (const auto& [rel_x, weight_x] :
+                 interpolationTaps(payload.kind, payload.rel_x)) {
+                llvm::Value* value = generate_load_from_row_ptr(
+                    row_ptr, payload.clip_idx, x, rel_x, use_mirror,
+                    no_x_bounds_check);
+                const double weight = weight_x * weight_y;
+                if (weight != 1.0) {
+                    value = builder.CreateFMul(
+                        value, llvm::ConstantFP::get(float_ty, weight));
+                }
+                result = result == nullptr ? value
+                                           : builder.CreateFAdd(result, value);
+            }
+        }
+        rpn_stack.push_back(result);
+        return true;
+    }
+    case TokenType::CLIP_INTERP_ABS: {
+        const auto& payload = std::get<TokenPayload_ClipInterp>(token.payload);
+        llvm::Value* coord_y_f = rpn_stack.back();
+        rpn_stack.pop_back();
+        llvm::Value* coord_x_f = rpn_stack.back();
+        rpn_stack.pop_back();
+        bool use_mirror = // NOLINT(cppcoreguidelines-init-variables)
+            payload.has_mode ? payload.use_mirror : mirror_boundary;
+        rpn_stack.push_back(generate_interpolated_load(
+            payload.clip_idx, payload.kind, coord_x_f, coord_y_f, use_mirror));
+        return true;
+    }
+
+    case TokenType::CLIP_REL_PLANE: {
+        const auto& payload =
+            std::get<TokenPayload_ClipRelPlane>(token.payload);
+        rpn_stack.push_back(generate_plane_read(payload, x, y));
+        return true;
+    }
+
+    case TokenType::CLIP_BOX_REL: {
+        const auto& payload = std::get<TokenPayload_ClipBox>(token.payload);
+        int slot = // NOLINT(cppcoreguidelines-init-variables)
+            num_inputs + 1 +
+            analysis_results.getIntegralUsageResult().slotOf(
+                payload.clip_idx, payload.plane_idx);
+        rpn_stack.push_back(generate_box_sum(
+            preloaded_base_ptrs[slot], preloaded_strides[slot], width, height,
+            builder.CreateAdd(x, builder.getInt32(payload.x0)),
+            builder.CreateAdd(y, builder.getInt32(payload.y0)),
+            builder.CreateAdd(x, builder.getInt32(payload.x1)),
+            builder.CreateAdd(y, builder.getInt32(payload.y1)), slot));
+        return true;
+    }
+    case TokenType::CLIP_BOX_ABS: {
+        const auto& payload = std::get<TokenPayload_ClipBox>(token.payload);
+        std::array<llvm::Value*, 4> coords{};
+        for (auto& coord : coords | std::views::reverse) {
+            llvm::Value* coord_f = rpn_stack.back();
+            rpn_stack.pop_back();
+            coord = builder.CreateFPToSI(
+                builder.CreateCall(
+                    llvm::Intrinsic::getOrInsertDeclaration(
+                        &module, llvm::Intrinsic::rint, {float_ty}),
+                    {coord_f}),
+                i32_ty);
+        }
+        int slot = // NOLINT(cppcoreguidelines-init-variables)
+            num_inputs + 1 +
+            analysis_results.getIntegralUsageResult().slotOf(
+                payload.clip_idx, payload.plane_idx);
+        rpn_stack.push_back(generate_box_sum(
+            preloaded_base_ptrs[slot], preloaded_strides[slot], width, height,
+            coords[0], coords[1], coords[2], coords[3], slot));
+        return true;
+    }
+    case TokenType::CLIP_PATCH_DIST: {
+        const auto& payload = std::get<TokenPayload_PatchDist>(token.payload);
+        int slot = // NOLINT(cppcoreguidelines-init-variables)
+            num_inputs + 1 +
+            static_cast<int>(
+                analysis_results.getIntegralUsageResult().planes.size()) +
+            analysis_results.getPatchDistanceUsageResult().slotOf(
+                analysis::PatchDistanceKey{.clip_idx = payload.clip_idx,
+                                           .dx = payload.dx,
+                                           .dy = payload.dy,
+                                           .radius = payload.radius});
+        llvm::Value* row_ptr =
+            builder.CreateGEP(builder.getInt8Ty(), preloaded_base_ptrs[slot],
+                              row_offset(y, slot));
+        llvm::LoadInst* li = builder.CreateLoad(
+            float_ty, builder.CreateGEP(float_ty, row_ptr, x));
+        setMemoryInstAttrs(li, sizeof(float), slot);
+        rpn_stack.push_back(li);
+        return true;
+    }
+
     case TokenType::EXIT_NO_WRITE: {
         rpn_stack.push_back(llvm::ConstantFP::get(
             float_ty, std::bit_cast<float>(EXIT_NAN_PAYLOAD)));
@@ -450,6 +1101,62 @@ bool ExprIRGenerator::process_mode_specific_token(
         return true;
     }
 
+    case TokenType::STORE_OUTPUT: {
+        const auto& payload =
+            std::get<TokenPayload_StoreOutput>(token.payload);
+        llvm::Value* val_to_store = rpn_stack.back();
+        rpn_stack.pop_back();
+        generate_pixel_store(
+            val_to_store, x, y,
+            first_extra_output_slot() +
+                analysis_results.getOutputUsageResult().slotOf(
+                    payload.output_idx));
+        return true;
+    }
+
+    case TokenType::PROP_REDUCE: {
+        const auto& payload = std::get<TokenPayload_PropReduce>(token.payload);
+        llvm::Value* value = rpn_stack.back();
+        rpn_stack.pop_back();
+        llvm::Value* acc_ptr =
+            reduction_accs[analysis_results.getReductionUsageResult().slotOf(
+                payload.prop_name)];
+        llvm::Type* acc_ty =
+            llvm::cast<llvm::AllocaInst>(acc_ptr)->getAllocatedType();
+        llvm::Value* acc = builder.CreateLoad(acc_ty, acc_ptr);
+
+        // The accumulators become loop-carried values that the loop
+        // vectorizer turns into vector reductions, reduced horizontally once
+        // after the loop. Sums need reassociation for that.
+        llvm::Value* next = nullptr;
+        switch (payload.kind) {
+        case ReduceKind::SUM: {
+            llvm::IRBuilderBase::FastMathFlagGuard guard(builder);
+            llvm::FastMathFlags fmf = builder.getFastMathFlags();
+            fmf.setAllowReassoc();
+            builder.setFastMathFlags(fmf);
+            next = builder.CreateFAdd(
+                acc, builder.CreateFPExt(value, builder.getDoubleTy()));
+            break;
+        }
+        case ReduceKind::COUNT:
+            next = builder.CreateAdd(
+                acc, builder.CreateZExt(
+                         builder.CreateFCmpOGT(
+                             value, llvm::ConstantFP::get(float_ty, 0.0)),
+                         acc_ty));
+            break;
+        case ReduceKind::MIN:
+            next = builder.CreateMinNum(acc, value);
+            break;
+        case ReduceKind::MAX:
+            next = builder.CreateMaxNum(acc, value);
+            break;
+        }
+        builder.CreateStore(next, acc_ptr);
+        return true;
+    }
+
     // Array
     case TokenType::ARRAY_ALLOC_STATIC: {
         const auto& payload = std::get<TokenPayload_ArrayOp>(token.payload);
@@ -20,7 +20,10 @@
 #ifndef LLVMEXPR_EXPRIRGENERATOR_HPP
 #define LLVMEXPR_EXPRIRGENERATOR_HPP
 
+#include <memory>
+
 #include "IRGeneratorBase.hpp"
+#include "LoopOptions.hpp"
 
 class ExprIRGenerator : public IRGeneratorBase {
   public:
@@ -32,7 +35,14 @@ class ExprIRGenerator : public IRGeneratorBase {
         const analysis::ExpressionAnalysisResults& analysis_results_in,
         llvm::LLVMContext& context_ref, llvm::Module& module_ref,
         llvm::IRBuilder<>& builder_ref, MathLibraryManager& math_mgr,
-        std::string func_name_in, int approx_math_in);
+        std::string func_name_in, int approx_math_in,
+        const LoopOptions& loop_options_in);
+
+    // Computes another plane of the same size in this kernel. Its pixels are
+    // produced in the same loop nest, reading and writing through its own
+    // block of rwptrs/strides, which follows the blocks of the planes added
+    // before it. Must be called before generate().
+    void add_fused_plane(std::unique_ptr<ExprIRGenerator> plane);
 
   protected:
     void define_function_signature() override;
@@ -47,13 +57,84 @@ class ExprIRGenerator : public IRGeneratorBase {
     void finalize_and_store_result(llvm::Value* result_val, llvm::Value* x,
                                    llvm::Value* y) override;
 
+    llvm::Value* row_offset(llvm::Value* y, int rwptr_index) override;
+
   private:
-    void generate_x_loop_body(llvm::Value* x_var, llvm::Value* x_fp_var,
-                              llvm::Value* y_var, llvm::Value* y_fp_var,
+    struct LoopState {
+        std::vector<ExprIRGenerator*> kernels; // this, then fused planes
+        llvm::Value* x_var;
+        llvm::Value* x_fp_var;
+        llvm::Value* y_var;
+        llvm::Value* y_fp_var;
+        llvm::Value* y_end;     // one past the last row to compute
+        llvm::Value* strip_x;   // first column of the current strip
+        llvm::Value* strip_end; // one past its last column
+    };
+
+    // Emits a y loop that computes `rows` output rows per iteration for as
+    // long as that many rows are left, leaving the builder after the loop.
+    void generate_row_loop(const LoopState& state, int rows);
+    void generate_x_loop_body(const LoopState& state, int rows,
                               bool no_x_bounds_check);
 
+    struct SampleTap {
+        llvm::Value* coord;
+        llvm::Value* weight; // nullptr for a weight of 1
+    };
+
+    // Taps along one axis for reading a plane with `src_size` samples at
+    // position `pos` of this plane, which has `size` samples on that axis.
+    std::vector<SampleTap> generate_siting_taps(llvm::Value* pos, int size,
+                                                int src_size, int rel,
+                                                PlaneSiting siting);
+    // Reads another plane of a clip at the position of (x, y) in this one.
+    llvm::Value*
+    generate_plane_read(const TokenPayload_ClipRelPlane& payload,
+                        llvm::Value* x, llvm::Value* y);
+
+    // Samples a clip at the fractional position (x_f, y_f) with the taps of
+    // `kind`, each tap coordinate following the boundary mode.
+    llvm::Value* generate_interpolated_load(int clip_idx, InterpKind kind,
+                                            llvm::Value* x_f, llvm::Value* y_f,
+                                            bool mirror);
+
+    // Number of rwptrs/strides entries this plane's kernel code reads.
+    [[nodiscard]] int num_rwptrs() const;
+    // rwptrs index of the first destination written by @N.
+    [[nodiscard]] int first_extra_output_slot() const;
+    // rwptrs index of the array receiving the reductions, after the extra
+    // outputs. Only present if the expression has reductions.
+    [[nodiscard]] int reduction_slot() const;
+
+    // Allocates the reduction accumulators and sets them to their identity.
+    void init_reductions();
+    // Stores the accumulated reductions to the result array, as doubles.
+    void store_reductions();
+
+    // Picks the column strip width for `tile_width` (-1 = auto, 0 = off).
+    // Returns 0 when the frame should be walked in full rows.
+    [[nodiscard]] int
+    resolve_strip_width(const std::vector<ExprIRGenerator*>& kernels) const;
+    [[nodiscard]] int
+    resolve_row_block(const std::vector<ExprIRGenerator*>& kernels) const;
+
+    LoopOptions loop_options;
+    // Width of the vertical strips the frame is processed in, 0 if untiled.
+    int strip_width = 0;
+    // Output rows per y iteration of the main row loop.
+    int row_block = 1;
+    // First row of the range the function is called for. Patch distance
+    // planes and the planes named by LoopOptions::band_dst/band_clip_* only
+    // hold the rows of that range and are indexed from it.
+    llvm::Value* y_origin = nullptr;
+    std::vector<std::unique_ptr<ExprIRGenerator>> fused_planes;
+    // Row pointers for each row of the block currently being generated.
+    std::vector<std::map<analysis::RelYAccess, llvm::Value*>> block_row_ptrs;
+
     // Arrays
     std::map<std::string, llvm::Value*> named_arrays;
+    // Accumulator of each reduction, in ReductionUsageResult order.
+    std::vector<llvm::Value*> reduction_accs;
 };
 
 #endif // LLVMEXPR_EXPRIRGENERATOR_HPP
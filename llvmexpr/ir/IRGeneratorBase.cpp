@@ -21,11 +21,16 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cmath>
 #include <format>
+#include <initializer_list>
 #include <map>
 #include <numbers>
 #include <numeric>
+#include <ranges>
 #include <unordered_map>
+#include <utility>
 
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Instructions.h"
@@ -129,12 +134,18 @@ llvm::Value* IRGeneratorBase::generate_load_from_row_ptr(
 
     const VSVideoFormat& format = vinfo->format;
     int bpp = format.bytesPerSample;
-    int vs_clip_idx = clip_idx + 1;
 
     llvm::Value* x_offset = builder.CreateMul(final_x, builder.getInt32(bpp));
     llvm::Value* pixel_addr =
         builder.CreateGEP(builder.getInt8Ty(), row_ptr, x_offset);
 
+    return generate_sample_load(pixel_addr, format, clip_idx + 1);
+}
+
+llvm::Value* IRGeneratorBase::generate_sample_load(llvm::Value* pixel_addr,
+                                                   const VSVideoFormat& format,
+                                                   int rwptr_index) {
+    int bpp = format.bytesPerSample;
     unsigned pixel_align = std::gcd(ALIGNMENT, bpp);
     assumeAligned(pixel_addr, pixel_align);
 
@@ -149,7 +160,7 @@ llvm::Value* IRGeneratorBase::generate_load_from_row_ptr(
             load_type = builder.getInt32Ty();
         }
         llvm::LoadInst* li = builder.CreateLoad(load_type, pixel_addr);
-        setMemoryInstAttrs(li, pixel_align, vs_clip_idx);
+        setMemoryInstAttrs(li, pixel_align, rwptr_index);
         loaded_val = builder.CreateZExtOrBitCast(li, builder.getInt32Ty());
         return builder.CreateUIToFP(loaded_val, builder.getFloatTy());
     }
@@ -157,13 +168,13 @@ llvm::Value* IRGeneratorBase::generate_load_from_row_ptr(
     if (bpp == 4) {
         llvm::LoadInst* li =
             builder.CreateLoad(builder.getFloatTy(), pixel_addr);
-        setMemoryInstAttrs(li, pixel_align, vs_clip_idx);
+        setMemoryInstAttrs(li, pixel_align, rwptr_index);
         return li;
     }
     if (bpp == 2) {
         llvm::LoadInst* li =
             builder.CreateLoad(builder.getHalfTy(), pixel_addr);
-        setMemoryInstAttrs(li, pixel_align, vs_clip_idx);
+        setMemoryInstAttrs(li, pixel_align, rwptr_index);
         return builder.CreateFPExt(li, builder.getFloatTy());
     }
     throw std::runtime_error("Unsupported float sample size.");
@@ -212,6 +223,10 @@ void IRGeneratorBase::add_loop_metadata(
     loop_br->setMetadata(llvm::LLVMContext::MD_loop, loop_id);
 }
 
+llvm::Value* IRGeneratorBase::row_offset(llvm::Value* y, int rwptr_index) {
+    return builder.CreateMul(y, preloaded_strides[rwptr_index]);
+}
+
 llvm::Value* IRGeneratorBase::generate_pixel_load(int clip_idx, llvm::Value* x,
                                                   llvm::Value* y, bool mirror) {
     llvm::Value* final_x = get_final_coord(x, builder.getInt32(width), mirror);
@@ -219,9 +234,8 @@ llvm::Value* IRGeneratorBase::generate_pixel_load(int clip_idx, llvm::Value* x,
 
     int vs_clip_idx = clip_idx + 1;
     llvm::Value* base_ptr = preloaded_base_ptrs[vs_clip_idx];
-    llvm::Value* stride = preloaded_strides[vs_clip_idx];
 
-    llvm::Value* y_offset = builder.CreateMul(final_y, stride);
+    llvm::Value* y_offset = row_offset(final_y, vs_clip_idx);
     llvm::Value* row_ptr =
         builder.CreateGEP(builder.getInt8Ty(), base_ptr, y_offset);
 
@@ -230,15 +244,14 @@ llvm::Value* IRGeneratorBase::generate_pixel_load(int clip_idx, llvm::Value* x,
 }
 
 void IRGeneratorBase::generate_pixel_store(llvm::Value* value_to_store,
-                                           llvm::Value* x, llvm::Value* y) {
+                                           llvm::Value* x, llvm::Value* y,
+                                           int dst_idx) {
     const VSVideoFormat& format = vo->format;
     int bpp = format.bytesPerSample;
-    int dst_idx = 0;
 
     llvm::Value* base_ptr = preloaded_base_ptrs[dst_idx];
-    llvm::Value* stride = preloaded_strides[dst_idx];
 
-    llvm::Value* y_offset = builder.CreateMul(y, stride);
+    llvm::Value* y_offset = row_offset(y, dst_idx);
     llvm::Value* x_offset = builder.CreateMul(x, builder.getInt32(bpp));
     llvm::Value* total_offset = builder.CreateAdd(y_offset, x_offset);
     llvm::Value* pixel_addr =
@@ -290,6 +303,248 @@ void IRGeneratorBase::generate_pixel_store(llvm::Value* value_to_store,
     }
 }
 
+llvm::Value* IRGeneratorBase::generate_box_sum(
+    llvm::Value* table_ptr, llvm::Value* table_stride, int plane_w,
+    int plane_h, llvm::Value* x0, llvm::Value* y0, llvm::Value* x1,
+    llvm::Value* y1, int rwptr_index) {
+    llvm::Type* double_ty = builder.getDoubleTy();
+    llvm::Value* zero = builder.getInt32(0);
+    llvm::Value* one = builder.getInt32(1);
+
+    auto clamp = [&](llvm::Value* v, llvm::Value* lo, llvm::Value* hi) {
+        llvm::Value* t =
+            builder.CreateBinaryIntrinsic(llvm::Intrinsic::smax, v, lo);
+        return builder.CreateBinaryIntrinsic(llvm::Intrinsic::smin, t, hi);
+    };
+
+    // Table coordinates: begin is inclusive, end is exclusive (+1). Forcing
+    // end >= begin makes empty rectangles sum to exactly zero.
+    llvm::Value* w_val = builder.getInt32(plane_w);
+    llvm::Value* h_val = builder.getInt32(plane_h);
+    llvm::Value* tx0 = clamp(x0, zero, w_val);
+    llvm::Value* ty0 = clamp(y0, zero, h_val);
+    llvm::Value* tx1 = clamp(builder.CreateAdd(x1, one), tx0, w_val);
+    llvm::Value* ty1 = clamp(builder.CreateAdd(y1, one), ty0, h_val);
+
+    llvm::Value* row0 = builder.CreateGEP(
+        builder.getInt8Ty(), table_ptr, builder.CreateMul(ty0, table_stride));
+    llvm::Value* row1 = builder.CreateGEP(
+        builder.getInt8Ty(), table_ptr, builder.CreateMul(ty1, table_stride));
+
+    auto load = [&](llvm::Value* row, llvm::Value* tx) -> llvm::Value* {
+        llvm::Value* addr = builder.CreateGEP(double_ty, row, tx);
+        llvm::LoadInst* li = builder.CreateLoad(double_ty, addr);
+        if (rwptr_index >= 0 &&
+            static_cast<size_t>(rwptr_index) < alias_scope_lists.size()) {
+            setMemoryInstAttrs(li, sizeof(double), rwptr_index);
+        } else {
+            li->setAlignment(llvm::Align(sizeof(double)));
+        }
+        return li;
+    };
+
+    llvm::Value* a = load(row0, tx0);
+    llvm::Value* b = load(row0, tx1);
+    llvm::Value* c = load(row1, tx0);
+    llvm::Value* d = load(row1, tx1);
+
+    llvm::Value* sum =
+        builder.CreateFAdd(builder.CreateFSub(builder.CreateFSub(d, b), c), a);
+    return builder.CreateFPTrunc(sum, builder.getFloatTy());
+}
+
+std::vector<llvm::Value*>
+IRGeneratorBase::generate_interpolation_weights(InterpKind kind,
+                                                llvm::Value* frac) {
+    llvm::Type* float_ty = builder.getFloatTy();
+    auto constant = [&](double value) {
+        return llvm::ConstantFP::get(float_ty, value);
+    };
+    // Evaluates coeffs[0] + v * (coeffs[1] + v * (...)).
+    auto horner = [&](llvm::Value* v, std::initializer_list<double> coeffs) {
+        llvm::Value* acc = nullptr;
+        for (double c : coeffs | std::views::reverse) {
+            acc = acc == nullptr ? constant(c)
+                                 : builder.CreateFAdd(
+                                       builder.CreateFMul(acc, v), constant(c));
+        }
+        return acc;
+    };
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+    switch (kind) {
+    case InterpKind::BILINEAR:
+        return {builder.CreateFSub(constant(1.0), frac), frac};
+    case InterpKind::BICUBIC:
+        // Catmull-Rom weights of the taps at -1, 0, 1 and 2.
+        return {horner(frac, {0.0, -0.5, 1.0, -0.5}),
+                horner(frac, {1.0, 0.0, -2.5, 1.5}),
+                horner(frac, {0.0, 0.5, 2.0, -1.5}),
+                horner(frac, {0.0, 0.0, -0.5, 0.5})};
+    case InterpKind::LANCZOS2: {
+        // For the tap at distance t = n - frac, sin(pi t) sin(pi t / 2) is
+        // +-sin(pi frac) times sin(pi frac / 2) or cos(pi frac / 2), and the
+        // common sin(pi frac) cancels when normalizing. Both half-angle terms
+        // are evaluated with short polynomials on [0, pi / 2), keeping the
+        // weights free of libm calls so the loop still vectorizes.
+        llvm::Value* is_integer = builder.CreateFCmpOEQ(frac, constant(0.0));
+        llvm::Value* f = builder.CreateSelect(is_integer, constant(0.5), frac);
+        llvm::Value* u = builder.CreateFMul(f, constant(std::numbers::pi / 2));
+        llvm::Value* u2 = builder.CreateFMul(u, u);
+        llvm::Value* sin_half = builder.CreateFMul(
+            u, horner(u2, {1.0, -1.0 / 6, 1.0 / 120, -1.0 / 5040,
+                           1.0 / 362880}));
+        llvm::Value* cos_half =
+            horner(u2, {1.0, -1.0 / 2, 1.0 / 24, -1.0 / 720, 1.0 / 40320,
+                        -1.0 / 3628800});
+
+        const std::array<llvm::Value*, 4> numerators = {
+            builder.CreateFNeg(cos_half), sin_half, cos_half,
+            builder.CreateFNeg(sin_half)};
+        std::vector<llvm::Value*> weights;
+        llvm::Value* sum = nullptr;
+        for (int k = 0; k < 4; ++k) {
+            llvm::Value* t = builder.CreateFSub(constant(k - 1), f);
+            llvm::Value* weight = builder.CreateFDiv(numerators.at(k),
+                                                     builder.CreateFMul(t, t));
+            weights.push_back(weight);
+            sum = sum == nullptr ? weight : builder.CreateFAdd(sum, weight);
+        }
+        llvm::Value* inv_sum = builder.CreateFDiv(constant(1.0), sum);
+        for (int k = 0; k < 4; ++k) {
+            weights[k] = builder.CreateSelect(
+                is_integer, constant(k == 1 ? 1.0 : 0.0),
+                builder.CreateFMul(weights[k], inv_sum));
+        }
+        return weights;
+    }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+    std::unreachable();
+}
+
+std::vector<llvm::Value*>
+IRGeneratorBase::generate_block_transform(TransformKind kind,
+                                          std::vector<llvm::Value*> values) {
+    const size_t n = values.size();
+    auto constant = [&](double c) {
+        return llvm::ConstantFP::get(builder.getFloatTy(), c);
+    };
+    // Orthonormal DCT scale for coefficient k of an n-point transform.
+    auto dct_scale = [&](size_t k) {
+        double s = std::sqrt(2.0 / static_cast<double>(n));
+        return k == 0 ? s / std::numbers::sqrt2 : s;
+    };
+    auto odd_cos = [](size_t i, size_t j, size_t len) {
+        return std::cos(std::numbers::pi * static_cast<double>(2 * i + 1) *
+                        static_cast<double>(2 * j + 1) /
+                        static_cast<double>(2 * len));
+    };
+
+    switch (kind) {
+    case TransformKind::HADAMARD:
+    case TransformKind::WHT: {
+        for (size_t h = 1; h < n; h *= 2) {
+            for (size_t i = 0; i < n; i += 2 * h) {
+                for (size_t j = i; j < i + h; ++j) {
+                    llvm::Value* a = values[j];
+                    llvm::Value* b = values[j + h];
+                    values[j] = builder.CreateFAdd(a, b);
+                    values[j + h] = builder.CreateFSub(a, b);
+                }
+            }
+        }
+        if (kind == TransformKind::HADAMARD) {
+            return values;
+        }
+        // Reorder from natural to sequency order and normalize.
+        const int bits = std::countr_zero(n);
+        llvm::Value* norm =
+            constant(1.0 / std::sqrt(static_cast<double>(n)));
+        std::vector<llvm::Value*> out(n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t gray = k ^ (k >> 1);
+            size_t natural = 0;
+            for (int b = 0; b < bits; ++b) {
+                natural |= ((gray >> b) & 1U) << (bits - 1 - b);
+            }
+            out[k] = builder.CreateFMul(values[natural], norm);
+        }
+        return out;
+    }
+    case TransformKind::DCT: {
+        // Unnormalized DCT-II by even/odd decomposition: the even outputs are
+        // a half-size DCT of the folded sums, the odd outputs a small matrix
+        // product of the folded differences.
+        auto dct = [&](auto& self, const std::vector<llvm::Value*>& x)
+            -> std::vector<llvm::Value*> {
+            const size_t len = x.size();
+            if (len == 1) {
+                return x;
+            }
+            const size_t half = len / 2;
+            std::vector<llvm::Value*> sum(half);
+            std::vector<llvm::Value*> diff(half);
+            for (size_t k = 0; k < half; ++k) {
+                sum[k] = builder.CreateFAdd(x[k], x[len - 1 - k]);
+                diff[k] = builder.CreateFSub(x[k], x[len - 1 - k]);
+            }
+            std::vector<llvm::Value*> even = self(self, sum);
+            std::vector<llvm::Value*> out(len);
+            for (size_t m = 0; m < half; ++m) {
+                out[2 * m] = even[m];
+                llvm::Value* acc = nullptr;
+                for (size_t k = 0; k < half; ++k) {
+                    llvm::Value* term = builder.CreateFMul(
+                        diff[k], constant(odd_cos(k, m, len)));
+                    acc = acc == nullptr ? term : builder.CreateFAdd(acc, term);
+                }
+                out[2 * m + 1] = acc;
+            }
+            return out;
+        };
+        std::vector<llvm::Value*> out = dct(dct, values);
+        for (size_t k = 0; k < n; ++k) {
+            out[k] = builder.CreateFMul(out[k], constant(dct_scale(k)));
+        }
+        return out;
+    }
+    case TransformKind::IDCT: {
+        // Inverse of the decomposition above (unnormalized DCT-III).
+        auto idct = [&](auto& self, const std::vector<llvm::Value*>& coeffs)
+            -> std::vector<llvm::Value*> {
+            const size_t len = coeffs.size();
+            if (len == 1) {
+                return coeffs;
+            }
+            const size_t half = len / 2;
+            std::vector<llvm::Value*> even_in(half);
+            for (size_t m = 0; m < half; ++m) {
+                even_in[m] = coeffs[2 * m];
+            }
+            std::vector<llvm::Value*> even = self(self, even_in);
+            std::vector<llvm::Value*> out(len);
+            for (size_t i = 0; i < half; ++i) {
+                llvm::Value* odd = nullptr;
+                for (size_t m = 0; m < half; ++m) {
+                    llvm::Value* term = builder.CreateFMul(
+                        coeffs[2 * m + 1], constant(odd_cos(i, m, len)));
+                    odd = odd == nullptr ? term : builder.CreateFAdd(odd, term);
+                }
+                out[i] = builder.CreateFAdd(even[i], odd);
+                out[len - 1 - i] = builder.CreateFSub(even[i], odd);
+            }
+            return out;
+        };
+        for (size_t k = 0; k < n; ++k) {
+            values[k] = builder.CreateFMul(values[k], constant(dct_scale(k)));
+        }
+        return idct(idct, values);
+    }
+    }
+    std::unreachable();
+}
+
 bool IRGeneratorBase::process_common_token(const Token& token,
                                            std::vector<llvm::Value*>& rpn_stack,
                                            llvm::Type* float_ty,
@@ -676,6 +931,20 @@ bool IRGeneratorBase::process_common_token(const Token& token,
         return true;
     }
 
+    case TokenType::BLOCK_TRANSFORM: {
+        const auto& payload = std::get<TokenPayload_Transform>(token.payload);
+        std::vector<llvm::Value*> values(payload.n);
+        for (int k = payload.n - 1; k >= 0; --k) {
+            values[k] = rpn_stack.back();
+            rpn_stack.pop_back();
+        }
+        for (llvm::Value* v :
+             generate_block_transform(payload.kind, std::move(values))) {
+            rpn_stack.push_back(v);
+        }
+        return true;
+    }
+
     // Control Flow (no-op during this pass)
     case TokenType::LABEL_DEF:
     case TokenType::JUMP:
@@ -752,8 +1021,10 @@ void IRGeneratorBase::generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
         }
     }
 
-    // Process blocks
+    // Process blocks. A token may emit its own loop, so the LLVM block a CFG
+    // block ends in is not necessarily the one it started in.
     std::map<int, std::vector<llvm::Value*>> block_final_stacks;
+    std::map<int, llvm::BasicBlock*> block_final_bbs;
 
     for (int i = 0; i < static_cast<int>(cfg_blocks.size()); ++i) {
         const auto& block_info = cfg_blocks[i];
@@ -774,6 +1045,10 @@ void IRGeneratorBase::generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
         for (int j = block_info.start_token_idx; j < block_info.end_token_idx;
              ++j) {
             const auto& token = tokens[j];
+            if (debug_scope != nullptr) {
+                builder.SetCurrentDebugLocation(
+                    llvm::DILocation::get(context, token.line, 0, debug_scope));
+            }
 
             // Try common tokens first
             if (process_common_token(token, rpn_stack, float_ty, i32_ty,
@@ -806,6 +1081,8 @@ void IRGeneratorBase::generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
         }
 
         // Create Terminator
+        builder.SetCurrentDebugLocation(llvm::DebugLoc());
+        block_final_bbs[i] = builder.GetInsertBlock();
         if (block_info.successors.empty()) {
             builder.CreateBr(exit_bb);
         } else if (block_info.successors.size() == 1) {
@@ -828,7 +1105,7 @@ void IRGeneratorBase::generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
             auto& phis = block_initial_stacks.at(i);
             for (int pred_idx : cfg_blocks[i].predecessors) {
                 auto& incoming_stack = block_final_stacks.at(pred_idx);
-                auto* incoming_block = llvm_blocks.at(pred_idx);
+                auto* incoming_block = block_final_bbs.at(pred_idx);
                 for (size_t j = 0; j < phis.size(); ++j) {
                     if (j < incoming_stack.size()) {
                         llvm::cast<llvm::PHINode>(phis[j])->addIncoming(
@@ -846,7 +1123,8 @@ void IRGeneratorBase::generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
         if (cfg_blocks[i].successors.empty()) {
             auto& stack = block_final_stacks.at(i);
             if (!stack.empty()) {
-                final_values.emplace_back(stack.back(), llvm_blocks.at(i));
+                final_values.emplace_back(stack.back(),
+                                          block_final_bbs.at(i));
             }
         }
     }
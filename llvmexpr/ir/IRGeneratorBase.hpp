@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "VapourSynth4.h"
+#include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/LLVMContext.h"
@@ -56,6 +57,10 @@ class IRGeneratorBase {
 
     void generate();
 
+    // Attaches the source line of each token to the instructions generated
+    // for it, in `scope` (the kernel's subprogram, or a file within it).
+    void set_debug_scope(llvm::DIScope* scope) { debug_scope = scope; }
+
   protected:
     // NOLINTBEGIN(cppcoreguidelines-non-private-member-variables-in-classes)
     // Input parameters
@@ -91,6 +96,8 @@ class IRGeneratorBase {
 
     std::map<analysis::RelYAccess, llvm::Value*> row_ptr_cache;
 
+    llvm::DIScope* debug_scope = nullptr;
+
     // NOLINTEND(cppcoreguidelines-non-private-member-variables-in-classes)
 
     virtual void define_function_signature() = 0;
@@ -118,13 +125,43 @@ class IRGeneratorBase {
                                             bool use_mirror,
                                             bool no_x_bounds_check);
 
+    // Loads one sample of the given format and converts it to float. The
+    // alias scopes of rwptrs[rwptr_index] are attached to the load.
+    llvm::Value* generate_sample_load(llvm::Value* pixel_addr,
+                                      const VSVideoFormat& format,
+                                      int rwptr_index);
+
     void add_loop_metadata(llvm::BranchInst* loop_br);
 
+    // Byte offset of row `y` of the plane at rwptrs[rwptr_index].
+    virtual llvm::Value* row_offset(llvm::Value* y, int rwptr_index);
+
     llvm::Value* generate_pixel_load(int clip_idx, llvm::Value* x,
                                      llvm::Value* y, bool mirror);
 
+    // Stores to the destination at rwptrs[dst_idx], 0 being the output.
     void generate_pixel_store(llvm::Value* value_to_store, llvm::Value* x,
-                              llvm::Value* y);
+                              llvm::Value* y, int dst_idx = 0);
+
+    // Sum over the inclusive rectangle [x0, x1] x [y0, y1] using an integral
+    // table (see utils/IntegralImage.hpp). The rectangle is intersected with
+    // the plane; an empty intersection yields 0.
+    llvm::Value* generate_box_sum(llvm::Value* table_ptr,
+                                  llvm::Value* table_stride, int plane_w,
+                                  int plane_h, llvm::Value* x0, llvm::Value* y0,
+                                  llvm::Value* x1, llvm::Value* y1,
+                                  int rwptr_index);
+
+    // Weights of the interpolation taps (see utils/Interpolation.hpp) for the
+    // fractional position `frac` in [0, 1), computed at run time.
+    std::vector<llvm::Value*> generate_interpolation_weights(InterpKind kind,
+                                                             llvm::Value* frac);
+
+    // Applies a fixed butterfly network for the given block transform to
+    // `values` (index 0 is the first element) and returns the coefficients.
+    std::vector<llvm::Value*>
+    generate_block_transform(TransformKind kind,
+                             std::vector<llvm::Value*> values);
 
     void generate_ir_from_tokens(llvm::Value* x, llvm::Value* y,
                                  llvm::Value* x_fp, llvm::Value* y_fp,
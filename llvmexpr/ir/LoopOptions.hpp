@@ -0,0 +1,49 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_LOOPOPTIONS_HPP
+#define LLVMEXPR_LOOPOPTIONS_HPP
+
+// Traversal options for the per-pixel (Expr) kernel. They only change the
+// order pixels are visited in, never the result.
+struct LoopOptions {
+    // Width of the vertical strips the plane is processed in.
+    // -1 = auto (from the stencil footprint and L2 size), 0 = full rows.
+    int tile_width = -1;
+    // Output rows computed per y iteration (1, 2 or 4). Rows of a block share
+    // their input row pointers, so loads common to several rows are CSE'd.
+    int row_block = 1;
+    // Compute only rows [begin, end) of the plane, read as two int32 at the
+    // kernel's context argument. The plane keeps its full height for
+    // boundary handling. Used to run multi-pass Chain kernels band by band.
+    bool row_range = false;
+    // With row_range, also compute only columns [begin, end), read as two
+    // more int32 after the rows. Column strips are disabled. Used to run
+    // masked Expr planes tile by tile.
+    bool column_range = false;
+    // With row_range, the destination (if band_dst) and the clips
+    // [band_clip_begin, band_clip_end) only hold the rows a call computes or
+    // reads, and are indexed from the first row of the range instead of from
+    // row 0. Used for the scratch planes of multi-pass Chain bands.
+    bool band_dst = false;
+    int band_clip_begin = 0;
+    int band_clip_end = 0;
+};
+
+#endif // LLVMEXPR_LOOPOPTIONS_HPP
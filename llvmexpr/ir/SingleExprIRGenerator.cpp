@@ -19,7 +19,10 @@
 
 #include "SingleExprIRGenerator.hpp"
 
+#include <array>
+#include <cstdint>
 #include <format>
+#include <ranges>
 
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -122,6 +125,23 @@ void SingleExprIRGenerator::
         }
     }
 
+    // Integral tables follow the plane pointers
+    const auto& integral_planes =
+        analysis_results.getIntegralUsageResult().planes;
+    integral_base_ptrs.resize(integral_planes.size());
+    integral_strides.resize(integral_planes.size());
+    for (size_t k = 0; k < integral_planes.size(); ++k) {
+        int flat_idx = ((num_inputs + 1) * num_planes) + static_cast<int>(k);
+        integral_base_ptrs[k] = builder.CreateLoad(
+            llvm::PointerType::get(context, 0),
+            builder.CreateGEP(llvm::PointerType::get(context, 0), rwptrs_arg,
+                              builder.getInt32(flat_idx)));
+        integral_strides[k] = builder.CreateLoad(
+            builder.getInt32Ty(),
+            builder.CreateGEP(builder.getInt32Ty(), strides_arg,
+                              builder.getInt32(flat_idx)));
+    }
+
     // Aligned loads for properties
     for (const auto& [key, idx] : prop_map) {
         llvm::Value* prop_val = builder.CreateLoad(
@@ -157,6 +177,8 @@ void SingleExprIRGenerator::
         }
     }
 
+    generate_plane_stats();
+
     // Only generate IR if there are tokens to process
     if (!tokens.empty()) {
         generate_ir_from_tokens(nullptr, nullptr, nullptr, nullptr, true);
@@ -280,6 +302,222 @@ void SingleExprIRGenerator::generate_pixel_store_plane(
     }
 }
 
+void SingleExprIRGenerator::generate_plane_loop(
+    int clip_idx, int plane_idx,
+    const std::function<void(llvm::Value*)>& body) {
+    const VSVideoInfo* vinfo = vi[clip_idx];
+    const VSVideoFormat& format = vinfo->format;
+    int plane_w = vinfo->width;
+    int plane_h = vinfo->height;
+    if (plane_idx > 0) {
+        plane_w >>= format.subSamplingW;
+        plane_h >>= format.subSamplingH;
+    }
+
+    llvm::Type* sample_ty = nullptr;
+    if (format.sampleType == stInteger) {
+        sample_ty = format.bytesPerSample == 1   ? builder.getInt8Ty()
+                    : format.bytesPerSample == 2 ? builder.getInt16Ty()
+                                                 : builder.getInt32Ty();
+    } else {
+        sample_ty = format.bytesPerSample == 2 ? builder.getHalfTy()
+                                               : builder.getFloatTy();
+    }
+
+    llvm::Type* i32_ty = builder.getInt32Ty();
+    llvm::Value* base_ptr = plane_base_ptrs[clip_idx + 1][plane_idx];
+    llvm::Value* stride = plane_strides[clip_idx + 1][plane_idx];
+
+    llvm::BasicBlock* preheader = builder.GetInsertBlock();
+    llvm::BasicBlock* row_bb =
+        llvm::BasicBlock::Create(context, "plane.row", func);
+    llvm::BasicBlock* sample_bb =
+        llvm::BasicBlock::Create(context, "plane.sample", func);
+    llvm::BasicBlock* row_latch_bb =
+        llvm::BasicBlock::Create(context, "plane.row.latch", func);
+    llvm::BasicBlock* exit_bb =
+        llvm::BasicBlock::Create(context, "plane.exit", func);
+    builder.CreateBr(row_bb);
+
+    builder.SetInsertPoint(row_bb);
+    llvm::PHINode* y = builder.CreatePHI(i32_ty, 2, "plane.y");
+    y->addIncoming(builder.getInt32(0), preheader);
+    llvm::Value* row_ptr = builder.CreateGEP(builder.getInt8Ty(), base_ptr,
+                                             builder.CreateMul(y, stride));
+    builder.CreateBr(sample_bb);
+
+    builder.SetInsertPoint(sample_bb);
+    llvm::PHINode* x = builder.CreatePHI(i32_ty, 2, "plane.x");
+    x->addIncoming(builder.getInt32(0), row_bb);
+    llvm::Value* sample = builder.CreateLoad(
+        sample_ty, builder.CreateGEP(sample_ty, row_ptr, x));
+    if (format.sampleType == stInteger) {
+        sample = builder.CreateZExtOrBitCast(sample, i32_ty);
+    } else if (format.bytesPerSample == 2) {
+        sample = builder.CreateFPExt(sample, builder.getFloatTy());
+    }
+    body(sample);
+    llvm::Value* x_next =
+        builder.CreateAdd(x, builder.getInt32(1), "", true, true);
+    x->addIncoming(x_next, builder.GetInsertBlock());
+    builder.CreateCondBr(
+        builder.CreateICmpSLT(x_next, builder.getInt32(plane_w)), sample_bb,
+        row_latch_bb);
+
+    builder.SetInsertPoint(row_latch_bb);
+    llvm::Value* y_next =
+        builder.CreateAdd(y, builder.getInt32(1), "", true, true);
+    y->addIncoming(y_next, row_latch_bb);
+    builder.CreateCondBr(
+        builder.CreateICmpSLT(y_next, builder.getInt32(plane_h)), row_bb,
+        exit_bb);
+
+    builder.SetInsertPoint(exit_bb);
+}
+
+void SingleExprIRGenerator::generate_plane_stats() {
+    llvm::Type* float_ty = builder.getFloatTy();
+    llvm::Type* double_ty = builder.getDoubleTy();
+    llvm::Type* i32_ty = builder.getInt32Ty();
+    llvm::Type* i64_ty = builder.getInt64Ty();
+
+    for (const auto& [clip_idx, plane_idx] :
+         analysis_results.getPlaneStatUsageResult().planes) {
+        const bool is_int = vi[clip_idx]->format.sampleType == stInteger;
+
+        // Integer samples are summed exactly and compared as integers. Float
+        // sums are accumulated in double, with reassociation so that they
+        // can be split into vector lanes.
+        llvm::Type* sum_ty = is_int ? i64_ty : double_ty;
+        llvm::Type* minmax_ty = is_int ? i32_ty : float_ty;
+        llvm::Value* sum_acc = createAllocaInEntry(sum_ty, "plane.sum");
+        llvm::Value* min_acc = createAllocaInEntry(minmax_ty, "plane.min");
+        llvm::Value* max_acc = createAllocaInEntry(minmax_ty, "plane.max");
+        if (is_int) {
+            builder.CreateStore(builder.getInt64(0), sum_acc);
+            builder.CreateStore(builder.getInt32(UINT32_MAX), min_acc);
+            builder.CreateStore(builder.getInt32(0), max_acc);
+        } else {
+            builder.CreateStore(llvm::ConstantFP::get(double_ty, 0.0),
+                                sum_acc);
+            builder.CreateStore(llvm::ConstantFP::getInfinity(float_ty, false),
+                                min_acc);
+            builder.CreateStore(llvm::ConstantFP::getInfinity(float_ty, true),
+                                max_acc);
+        }
+
+        generate_plane_loop(clip_idx, plane_idx, [&](llvm::Value* sample) {
+            llvm::Value* sum = builder.CreateLoad(sum_ty, sum_acc);
+            llvm::Value* min = builder.CreateLoad(minmax_ty, min_acc);
+            llvm::Value* max = builder.CreateLoad(minmax_ty, max_acc);
+            if (is_int) {
+                builder.CreateStore(
+                    builder.CreateAdd(sum, builder.CreateZExt(sample, i64_ty)),
+                    sum_acc);
+                builder.CreateStore(
+                    builder.CreateBinaryIntrinsic(llvm::Intrinsic::umin, min,
+                                                  sample),
+                    min_acc);
+                builder.CreateStore(
+                    builder.CreateBinaryIntrinsic(llvm::Intrinsic::umax, max,
+                                                  sample),
+                    max_acc);
+                return;
+            }
+            llvm::IRBuilderBase::FastMathFlagGuard guard(builder);
+            llvm::FastMathFlags fmf = builder.getFastMathFlags();
+            fmf.setAllowReassoc();
+            fmf.setNoNaNs();
+            builder.setFastMathFlags(fmf);
+            builder.CreateStore(
+                builder.CreateFAdd(sum, builder.CreateFPExt(sample, double_ty)),
+                sum_acc);
+            builder.CreateStore(builder.CreateMinNum(min, sample), min_acc);
+            builder.CreateStore(builder.CreateMaxNum(max, sample), max_acc);
+        });
+
+        llvm::Value* sum = builder.CreateLoad(sum_ty, sum_acc);
+        llvm::Value* min = builder.CreateLoad(minmax_ty, min_acc);
+        llvm::Value* max = builder.CreateLoad(minmax_ty, max_acc);
+        if (is_int) {
+            sum = builder.CreateUIToFP(sum, float_ty);
+            min = builder.CreateUIToFP(min, float_ty);
+            max = builder.CreateUIToFP(max, float_ty);
+        } else {
+            sum = builder.CreateFPTrunc(sum, float_ty);
+        }
+        plane_stats[{clip_idx, plane_idx}] = {sum, min, max};
+    }
+}
+
+llvm::Value* SingleExprIRGenerator::generate_plane_count(int clip_idx,
+                                                         int plane_idx,
+                                                         llvm::Value* lo,
+                                                         llvm::Value* hi) {
+    llvm::Type* float_ty = builder.getFloatTy();
+    llvm::Type* i64_ty = builder.getInt64Ty();
+    const bool is_int = vi[clip_idx]->format.sampleType == stInteger;
+
+    llvm::Value* count_acc = createAllocaInEntry(i64_ty, "plane.count");
+    builder.CreateStore(builder.getInt64(0), count_acc);
+    generate_plane_loop(clip_idx, plane_idx, [&](llvm::Value* sample) {
+        llvm::Value* v =
+            is_int ? builder.CreateUIToFP(sample, float_ty) : sample;
+        llvm::Value* in_range = builder.CreateAnd(
+            builder.CreateFCmpOGE(v, lo), builder.CreateFCmpOLT(v, hi));
+        builder.CreateStore(
+            builder.CreateAdd(builder.CreateLoad(i64_ty, count_acc),
+                              builder.CreateZExt(in_range, i64_ty)),
+            count_acc);
+    });
+    return builder.CreateUIToFP(builder.CreateLoad(i64_ty, count_acc),
+                                float_ty);
+}
+
+void SingleExprIRGenerator::generate_plane_histogram(
+    const TokenPayload_PlaneStat& payload, llvm::Value* lo, llvm::Value* hi) {
+    llvm::Type* float_ty = builder.getFloatTy();
+    llvm::Type* i64_ty = builder.getInt64Ty();
+    const bool is_int =
+        vi[payload.clip_idx]->format.sampleType == stInteger;
+
+    // One bin per array element, cleared first.
+    llvm::Value* name_str = builder.CreateGlobalString(
+        payload.array_name, payload.array_name + "_name");
+    llvm::Value* bins =
+        builder.CreateCall(llvmexpr_get_buffer_size_func, {name_str});
+    llvm::Value* array_ptr = array_ptr_cache.at(payload.array_name);
+    builder.CreateMemSet(array_ptr, builder.getInt8(0),
+                         builder.CreateMul(bins, builder.getInt64(4)),
+                         llvm::MaybeAlign(4));
+
+    llvm::Value* last_bin = builder.CreateSub(bins, builder.getInt64(1));
+    llvm::Value* scale = builder.CreateFDiv(
+        builder.CreateSIToFP(bins, float_ty), builder.CreateFSub(hi, lo));
+    generate_plane_loop(
+        payload.clip_idx, payload.plane_idx, [&](llvm::Value* sample) {
+            llvm::Value* v =
+                is_int ? builder.CreateUIToFP(sample, float_ty) : sample;
+            llvm::Value* in_range = builder.CreateAnd(
+                builder.CreateFCmpOGE(v, lo), builder.CreateFCmpOLT(v, hi));
+            // Samples outside [lo, hi) add 0 to bin 0, which keeps the body
+            // free of branches.
+            llvm::Value* bin = builder.CreateFPToSI(
+                builder.CreateFMul(builder.CreateFSub(v, lo), scale), i64_ty);
+            bin = builder.CreateSelect(
+                in_range,
+                builder.CreateBinaryIntrinsic(llvm::Intrinsic::smin, bin,
+                                              last_bin),
+                builder.getInt64(0));
+            llvm::Value* bin_ptr = builder.CreateGEP(float_ty, array_ptr, bin);
+            builder.CreateStore(
+                builder.CreateFAdd(
+                    builder.CreateLoad(float_ty, bin_ptr),
+                    builder.CreateUIToFP(in_range, float_ty)),
+                bin_ptr);
+        });
+}
+
 bool SingleExprIRGenerator::process_mode_specific_token(
     const Token& token, std::vector<llvm::Value*>& rpn_stack,
     [[maybe_unused]] llvm::Value* x, [[maybe_unused]] llvm::Value* y,
@@ -371,6 +609,87 @@ bool SingleExprIRGenerator::process_mode_specific_token(
             payload.clip_idx, payload.plane_idx, coord_x, coord_y));
         return true;
     }
+    case TokenType::CLIP_BOX_ABS_PLANE: {
+        const auto& payload = std::get<TokenPayload_ClipBox>(token.payload);
+        std::array<llvm::Value*, 4> coords{};
+        for (auto& coord : coords | std::views::reverse) {
+            llvm::Value* coord_f = rpn_stack.back();
+            rpn_stack.pop_back();
+            coord = builder.CreateFPToSI(
+                builder.CreateCall(
+                    llvm::Intrinsic::getOrInsertDeclaration(
+                        &module, llvm::Intrinsic::rint, {float_ty}),
+                    {coord_f}),
+                i32_ty);
+        }
+
+        const VSVideoInfo* vinfo = vi[payload.clip_idx];
+        int plane_w = vinfo->width;
+        int plane_h = vinfo->height;
+        if (payload.plane_idx > 0) {
+            plane_w >>= vinfo->format.subSamplingW;
+            plane_h >>= vinfo->format.subSamplingH;
+        }
+
+        int slot = // NOLINT(cppcoreguidelines-init-variables)
+            analysis_results.getIntegralUsageResult().slotOf(
+                payload.clip_idx, payload.plane_idx);
+        rpn_stack.push_back(generate_box_sum(
+            integral_base_ptrs[slot], integral_strides[slot], plane_w, plane_h,
+            coords[0], coords[1], coords[2], coords[3], -1));
+        return true;
+    }
+    case TokenType::PLANE_STAT: {
+        const auto& payload = std::get<TokenPayload_PlaneStat>(token.payload);
+        if (payload.kind == PlaneStatKind::COUNT) {
+            llvm::Value* hi = rpn_stack.back();
+            rpn_stack.pop_back();
+            llvm::Value* lo = rpn_stack.back();
+            rpn_stack.pop_back();
+            rpn_stack.push_back(generate_plane_count(
+                payload.clip_idx, payload.plane_idx, lo, hi));
+            return true;
+        }
+
+        const auto& [sum, min, max] =
+            plane_stats.at({payload.clip_idx, payload.plane_idx});
+        switch (payload.kind) {
+        case PlaneStatKind::SUM:
+            rpn_stack.push_back(sum);
+            break;
+        case PlaneStatKind::MEAN: {
+            const VSVideoInfo* vinfo = vi[payload.clip_idx];
+            int plane_w = vinfo->width;
+            int plane_h = vinfo->height;
+            if (payload.plane_idx > 0) {
+                plane_w >>= vinfo->format.subSamplingW;
+                plane_h >>= vinfo->format.subSamplingH;
+            }
+            rpn_stack.push_back(builder.CreateFDiv(
+                sum, llvm::ConstantFP::get(
+                         float_ty, static_cast<double>(plane_w) * plane_h)));
+            break;
+        }
+        case PlaneStatKind::MIN:
+            rpn_stack.push_back(min);
+            break;
+        case PlaneStatKind::MAX:
+            rpn_stack.push_back(max);
+            break;
+        case PlaneStatKind::COUNT: // handled above
+            break;
+        }
+        return true;
+    }
+    case TokenType::PLANE_HISTOGRAM: {
+        const auto& payload = std::get<TokenPayload_PlaneStat>(token.payload);
+        llvm::Value* hi = rpn_stack.back();
+        rpn_stack.pop_back();
+        llvm::Value* lo = rpn_stack.back();
+        rpn_stack.pop_back();
+        generate_plane_histogram(payload, lo, hi);
+        return true;
+    }
     case TokenType::STORE_ABS_PLANE: {
         const auto& payload =
             std::get<TokenPayload_StoreAbsPlane>(token.payload);
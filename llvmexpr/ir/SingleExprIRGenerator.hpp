@@ -20,6 +20,10 @@
 #ifndef LLVMEXPR_SINGLEEXPRIRGENERATOR_HPP
 #define LLVMEXPR_SINGLEEXPRIRGENERATOR_HPP
 
+#include <array>
+#include <functional>
+#include <utility>
+
 #include "IRGeneratorBase.hpp"
 
 class SingleExprIRGenerator : public IRGeneratorBase {
@@ -53,8 +57,25 @@ class SingleExprIRGenerator : public IRGeneratorBase {
     void generate_pixel_store_plane(llvm::Value* value_to_store, int plane_idx,
                                     llvm::Value* x, llvm::Value* y);
 
+    // Emits a loop over every sample of a plane of clip `clip_idx` and calls
+    // `body` on each sample, as i32 for integer formats and float otherwise.
+    // `body` must not create blocks, so that the loop stays vectorizable.
+    void generate_plane_loop(int clip_idx, int plane_idx,
+                             const std::function<void(llvm::Value*)>& body);
+    // Computes the sum, minimum and maximum of every plane in
+    // PlaneStatUsageResult, one loop per plane.
+    void generate_plane_stats();
+    llvm::Value* generate_plane_count(int clip_idx, int plane_idx,
+                                      llvm::Value* lo, llvm::Value* hi);
+    void generate_plane_histogram(const TokenPayload_PlaneStat& payload,
+                                  llvm::Value* lo, llvm::Value* hi);
+
     std::vector<std::vector<llvm::Value*>> plane_base_ptrs;
     std::vector<std::vector<llvm::Value*>> plane_strides;
+    std::vector<llvm::Value*> integral_base_ptrs;
+    std::vector<llvm::Value*> integral_strides;
+    // Sum, minimum and maximum of a (clip, plane), as floats.
+    std::map<std::pair<int, int>, std::array<llvm::Value*, 3>> plane_stats;
     std::map<std::string, llvm::Value*> prop_allocas;
     const std::vector<std::string>& output_props_list;
     std::map<std::string, int> output_prop_map;
@@ -19,14 +19,19 @@
 
 #include "Compiler.hpp"
 
+#include <filesystem>
+#include <format>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <system_error>
 #include <utility>
 #include <vector>
 
+#include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/IR/Attributes.h"
+#include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -38,6 +43,7 @@
 #include "../ir/ExprIRGenerator.hpp"
 #include "../ir/SingleExprIRGenerator.hpp"
 #include "../utils/Diagnostics.hpp"
+#include "../utils/Trace.hpp"
 
 Compiler::Compiler(
     std::vector<Token> tokens_in, const VSVideoInfo* out_vi,
@@ -45,6 +51,7 @@ Compiler::Compiler(
     bool mirror, std::string dump_path,
     const std::map<std::pair<int, std::string>, int>& p_map,
     std::string function_name, int opt_level_in, int approx_math_in,
+    const LoopOptions& loop_options_in,
     const analysis::ExpressionAnalysisResults& analysis_results_in,
     ExprMode mode, const std::vector<std::string>& output_props)
     : tokens(std::move(tokens_in)), vo(out_vi), vi(in_vi),
@@ -52,10 +59,25 @@ Compiler::Compiler(
       height(height_in), mirror_boundary(mirror),
       dump_ir_path(std::move(dump_path)), prop_map(p_map),
       func_name(std::move(function_name)), opt_level(opt_level_in),
-      approx_math(approx_math_in), expr_mode(mode), output_props(output_props),
+      approx_math(approx_math_in), loop_options(loop_options_in),
+      expr_mode(mode), output_props(output_props),
       analysis_results(analysis_results_in) {}
 
+void Compiler::add_fused_plane(
+    std::vector<Token> plane_tokens,
+    const analysis::ExpressionAnalysisResults& results) {
+    fused_planes.push_back({.tokens = std::move(plane_tokens),
+                            .analysis_results = results});
+}
+
+void Compiler::set_debug_sources(std::vector<std::string> source_paths) {
+    debug_sources = std::move(source_paths);
+}
+
+void Compiler::set_report(KernelReport* report_in) { report = report_in; }
+
 CompiledFunction Compiler::compile() {
+    const TraceScope trace("compile", "compile", func_name);
     if (approx_math == 2) {
         return compile_with_approx_math(1);
     }
@@ -65,10 +87,14 @@ CompiledFunction Compiler::compile() {
 CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
     bool needs_nans = false;
     if (expr_mode == ExprMode::EXPR) {
-        needs_nans = std::ranges::any_of(tokens, [](const auto& token) {
+        auto needs_nan = [](const auto& token) {
             return token.type == TokenType::EXIT_NO_WRITE ||
                    token.type == TokenType::PROP_EXISTS;
-        });
+        };
+        needs_nans = std::ranges::any_of(tokens, needs_nan) ||
+                     std::ranges::any_of(fused_planes, [&](const auto& plane) {
+                         return std::ranges::any_of(plane.tokens, needs_nan);
+                     });
     } else if (expr_mode == ExprMode::SINGLE_EXPR) {
         needs_nans = std::ranges::any_of(tokens, [](const auto& token) {
             return token.type == TokenType::PROP_STORE ||
@@ -83,9 +109,18 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
 
     // Create LLVM context and module
     auto context = std::make_unique<llvm::LLVMContext>();
-    context->setDiagnosticHandlerCallBack(
-        VectorizationDiagnosticHandler::diagnosticHandlerCallback,
-        &diagnostic_handler);
+    if (report != nullptr) {
+        *report = KernelReport{};
+        report->name = func_name;
+        report->approx_math = actual_approx_math != 0;
+        diagnostic_handler.setReport(report);
+        context->setDiagnosticHandler(
+            std::make_unique<RemarkDiagnosticHandler>(&diagnostic_handler));
+    } else {
+        context->setDiagnosticHandlerCallBack(
+            VectorizationDiagnosticHandler::diagnosticHandlerCallback,
+            &diagnostic_handler);
+    }
 
     auto module = std::make_unique<llvm::Module>("ExprJITModule", *context);
     module->setDataLayout(jit.getDataLayout());
@@ -100,20 +135,70 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
     // Create math library manager
     MathLibraryManager math_manager(module.get(), *context);
 
+    // Debug info: the kernel is a subprogram of the first plane's source,
+    // and the tokens of each plane are located in a file scope of their own.
+    std::unique_ptr<llvm::DIBuilder> di_builder;
+    llvm::DISubprogram* subprogram = nullptr;
+    std::vector<llvm::DIScope*> debug_scopes;
+    if (!debug_sources.empty()) {
+        di_builder = std::make_unique<llvm::DIBuilder>(*module);
+        std::vector<llvm::DIFile*> files;
+        for (const auto& source : debug_sources) {
+            const std::filesystem::path path(source);
+            files.push_back(di_builder->createFile(
+                path.filename().string(), path.parent_path().string()));
+        }
+        di_builder->createCompileUnit(llvm::dwarf::DW_LANG_C, files.front(),
+                                      "llvmexpr", true, "", 0);
+        subprogram = di_builder->createFunction(
+            files.front(), func_name, func_name, files.front(), 1,
+            di_builder->createSubroutineType(
+                di_builder->getOrCreateTypeArray({})),
+            1, llvm::DINode::FlagZero,
+            llvm::DISubprogram::SPFlagDefinition |
+                llvm::DISubprogram::SPFlagOptimized);
+        debug_scopes.push_back(subprogram);
+        for (size_t k = 1; k < files.size(); ++k) {
+            debug_scopes.push_back(
+                di_builder->createLexicalBlockFile(subprogram, files[k]));
+        }
+        module->addModuleFlag(llvm::Module::Warning, "Debug Info Version",
+                              llvm::DEBUG_METADATA_VERSION);
+        module->addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+    }
+    auto debug_scope = [&](size_t plane_idx) -> llvm::DIScope* {
+        return plane_idx < debug_scopes.size() ? debug_scopes[plane_idx]
+                                               : nullptr;
+    };
+
     // Create IR generator and generate code
+    std::optional<TraceScope> trace_phase;
+    trace_phase.emplace("compile", "IR generation");
     std::unique_ptr<IRGeneratorBase> ir_gen;
     if (expr_mode == ExprMode::EXPR) {
-        ir_gen = std::make_unique<ExprIRGenerator>(
+        auto expr_gen = std::make_unique<ExprIRGenerator>(
             tokens, vo, vi, width, height, mirror_boundary, prop_map,
             analysis_results, *context, *module, builder, math_manager,
-            func_name, actual_approx_math);
+            func_name, actual_approx_math, loop_options);
+        for (size_t k = 0; k < fused_planes.size(); ++k) {
+            const auto& plane = fused_planes[k];
+            auto plane_gen = std::make_unique<ExprIRGenerator>(
+                plane.tokens, vo, vi, width, height, mirror_boundary,
+                prop_map, plane.analysis_results, *context, *module, builder,
+                math_manager, func_name, actual_approx_math, loop_options);
+            plane_gen->set_debug_scope(debug_scope(k + 1));
+            expr_gen->add_fused_plane(std::move(plane_gen));
+        }
+        ir_gen = std::move(expr_gen);
     } else {
         ir_gen = std::make_unique<SingleExprIRGenerator>(
             tokens, vo, vi, mirror_boundary, prop_map, output_props,
             analysis_results, *context, *module, builder, math_manager,
             func_name, actual_approx_math);
     }
+    ir_gen->set_debug_scope(debug_scope(0));
     ir_gen->generate();
+    trace_phase.reset();
 
     // Get the generated function and set attributes
     llvm::Function* func = module->getFunction(func_name);
@@ -121,6 +206,23 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
         throw std::runtime_error("Failed to find generated function");
     }
 
+    if (di_builder) {
+        func->setSubprogram(subprogram);
+        // Helper functions have no subprogram, so their instructions must
+        // not carry locations.
+        for (auto& other : *module) {
+            if (&other == func) {
+                continue;
+            }
+            for (auto& block : other) {
+                for (auto& inst : block) {
+                    inst.setDebugLoc(llvm::DebugLoc());
+                }
+            }
+        }
+        di_builder->finalize();
+    }
+
     llvm::AttrBuilder FuncAttrs(func->getContext());
     if (FMF.allowContract()) {
         FuncAttrs.addAttribute("fp-contract", "fast");
@@ -188,23 +290,23 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
         PB.registerLoopAnalyses(LAM);
         PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-        llvm::ModulePassManager MPM;
-        std::string pipeline;
-        if (opt_level > 0) {
-            pipeline = "default<O3>";
-            for (int i = 1; i < opt_level; ++i) {
-                pipeline += ",default<O3>";
+        // The O3 pipeline runs opt_level times. Each round is a separate
+        // pass manager so that it can be traced on its own.
+        const std::string pipeline = "default<O3>";
+        for (int i = 0; i < opt_level; ++i) {
+            llvm::ModulePassManager MPM;
+            if (auto Err = PB.parsePassPipeline(MPM, pipeline)) {
+                llvm::errs() << "Failed to parse '" << pipeline
+                             << "' pipeline: "
+                             << llvm::toString(std::move(Err)) << "\n";
+                throw std::runtime_error(
+                    "Failed to create default optimization pipeline.");
             }
+            trace_phase.emplace("compile", std::format("O3 round {}", i + 1));
+            MPM.run(*module, MAM);
         }
-        if (auto Err = PB.parsePassPipeline(MPM, pipeline)) {
-            llvm::errs() << "Failed to parse '" << pipeline
-                         << "' pipeline: " << llvm::toString(std::move(Err))
-                         << "\n";
-            throw std::runtime_error(
-                "Failed to create default optimization pipeline.");
-        }
-        MPM.run(*module, MAM);
     }
+    trace_phase.reset();
 
     // Verify module after optimization
     if (llvm::verifyModule(*module, &llvm::errs())) {
@@ -229,15 +331,31 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
     // Handle vectorization fallback
     if (diagnostic_handler.hasVectorizationFailed() && approx_math == 2 &&
         actual_approx_math == 1) {
+        const TraceScope trace("compile", "approx_math fallback");
         Compiler fallback_compiler(std::vector<Token>(tokens), vo, vi, width,
                                    height, mirror_boundary, dump_ir_path,
                                    prop_map, func_name, opt_level, approx_math,
-                                   analysis_results, expr_mode, output_props);
+                                   loop_options, analysis_results, expr_mode,
+                                   output_props);
+        for (const auto& plane : fused_planes) {
+            fallback_compiler.add_fused_plane(plane.tokens,
+                                              plane.analysis_results);
+        }
+        fallback_compiler.set_debug_sources(debug_sources);
+        fallback_compiler.set_report(report);
         return fallback_compiler.compile_with_approx_math(0);
     }
 
-    // Add module to JIT and get function address
-    jit.addModule(std::move(module), std::move(context));
+    if (report != nullptr) {
+        const TraceScope trace("compile", "report");
+        analyzeKernel(*report, *module, *jit.createTargetMachine());
+        diagnostic_handler.setReport(nullptr);
+    }
+
+    // Add module to JIT and get function address. The lookup materializes
+    // the module, which runs the code generator.
+    trace_phase.emplace("compile", "codegen");
+    auto tracker = jit.addModule(std::move(module), std::move(context));
     void* func_addr = jit.getFunctionAddress(func_name);
 
     if (func_addr == nullptr) {
@@ -248,5 +366,8 @@ CompiledFunction Compiler::compile_with_approx_math(int actual_approx_math) {
     compiled.func_ptr =
         reinterpret_cast< // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
             ProcessProc>(func_addr);
+    compiled.approx_math = actual_approx_math != 0;
+    compiled.code = std::make_shared<JitCode>(
+        std::move(tracker), jit.takeCodeBytes(func_name));
     return compiled;
 }
@@ -28,6 +28,8 @@
 
 #include "../analysis/AnalysisResults.hpp"
 #include "../frontend/Tokenizer.hpp"
+#include "../ir/LoopOptions.hpp"
+#include "../utils/KernelReport.hpp"
 #include "Jit.hpp"
 
 class Compiler {
@@ -37,13 +39,34 @@ class Compiler {
              int height_in, bool mirror, std::string dump_path,
              const std::map<std::pair<int, std::string>, int>& p_map,
              std::string function_name, int opt_level_in, int approx_math_in,
+             const LoopOptions& loop_options_in,
              const analysis::ExpressionAnalysisResults& analysis_results_in,
              ExprMode mode = ExprMode::EXPR,
              const std::vector<std::string>& output_props = {});
 
+    // Expr only: computes another plane of the same size in the same kernel.
+    // The kernel then expects one rwptrs/strides block per plane, in the
+    // order the planes were added (this compiler's own plane first).
+    void add_fused_plane(std::vector<Token> plane_tokens,
+                         const analysis::ExpressionAnalysisResults& results);
+
+    // Emits line tables mapping the kernel to its source files, one per
+    // plane in the order of add_fused_plane (this compiler's plane first).
+    // The line of each instruction is that of the token it came from.
+    void set_debug_sources(std::vector<std::string> source_paths);
+
+    // Fills `report` with a static performance summary of the kernel while
+    // compiling it. Slows compilation down considerably.
+    void set_report(KernelReport* report_in);
+
     CompiledFunction compile();
 
   private:
+    struct FusedPlane {
+        std::vector<Token> tokens;
+        analysis::ExpressionAnalysisResults analysis_results;
+    };
+
     std::vector<Token> tokens;
     const VSVideoInfo* vo;
     const std::vector<const VSVideoInfo*>& vi;
@@ -56,12 +79,17 @@ class Compiler {
     std::string func_name;
     int opt_level;
     int approx_math;
+    LoopOptions loop_options;
     ExprMode expr_mode;
     const std::vector<std::string>& output_props;
 
     // Analysis results
     const analysis::ExpressionAnalysisResults& analysis_results;
 
+    std::vector<FusedPlane> fused_planes;
+    std::vector<std::string> debug_sources;
+    KernelReport* report = nullptr;
+
     CompiledFunction compile_with_approx_math(int actual_approx_math);
 };
 
@@ -0,0 +1,34 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Host API of SingleExpr arrays for executables without the plugin, which
+// defines the real functions. The JIT resolves these symbols when it starts,
+// but the kernels these tools compile never call them.
+
+#include <cstdint>
+
+extern "C" {
+
+float* llvmexpr_ensure_buffer(const char* /*name*/, int64_t /*size*/) {
+    return nullptr;
+}
+
+int64_t llvmexpr_get_buffer_size(const char* /*name*/) { return 0; }
+
+} // extern "C"
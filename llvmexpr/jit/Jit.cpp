@@ -19,24 +19,194 @@
 
 #include "Jit.hpp"
 
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/SymbolSize.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 // Forward declare the host API functions
 extern "C" {
 float* llvmexpr_ensure_buffer(const char*, int64_t);
 int64_t llvmexpr_get_buffer_size(const char*);
 }
 
+namespace {
+
+#ifdef __linux__
+// Appends the functions of every loaded object to /tmp/perf-<pid>.map, where
+// perf looks up the names of JIT code. Unlike the jitdump written by the
+// perf listener, this needs no `perf inject`.
+class PerfMapListener : public llvm::JITEventListener {
+  public:
+    void notifyObjectLoaded(ObjectKey /*key*/,
+                            const llvm::object::ObjectFile& obj,
+                            const llvm::RuntimeDyld::LoadedObjectInfo& info)
+        override {
+        // The debug object has the symbols at their load addresses.
+        const auto debug_obj = info.getObjectForDebug(obj);
+        if (debug_obj.getBinary() == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!stream.is_open()) {
+            stream.open(std::format("/tmp/perf-{}.map", getpid()),
+                        std::ios::app);
+        }
+        for (const auto& [symbol, size] :
+             llvm::object::computeSymbolSizes(*debug_obj.getBinary())) {
+            auto type = symbol.getType();
+            auto name = symbol.getName();
+            auto address = symbol.getAddress();
+            if (!type || !name || !address ||
+                *type != llvm::object::SymbolRef::ST_Function || size == 0) {
+                llvm::consumeError(type.takeError());
+                llvm::consumeError(name.takeError());
+                llvm::consumeError(address.takeError());
+                continue;
+            }
+            stream << std::format("{:x} {:x} {}\n", *address, size,
+                                  std::string_view(*name));
+        }
+        stream.flush();
+    }
+
+  private:
+    std::mutex mutex;
+    std::ofstream stream;
+};
+#endif
+
+// Registers the listeners making JIT code visible to profilers and
+// debuggers.
+void registerDebugListeners(llvm::orc::RTDyldObjectLinkingLayer& layer) {
+    layer.registerJITEventListener(
+        *llvm::JITEventListener::createGDBRegistrationListener());
+    // nullptr unless LLVM was built with LLVM_USE_PERF.
+    if (auto* perf = llvm::JITEventListener::createPerfJITEventListener()) {
+        layer.registerJITEventListener(*perf);
+    }
+#ifdef __linux__
+    static PerfMapListener perf_map;
+    layer.registerJITEventListener(perf_map);
+#endif
+}
+
+// Bytes of machine code loaded by either JIT, counted by JitCode.
+std::atomic<int64_t>
+    code_bytes{0}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Bytes of machine code in the objects emitted by either JIT and not yet
+// claimed by OrcJit::takeCodeBytes, keyed by the kernel symbol each object
+// defines. Every module defines exactly one process_* kernel.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex emitted_mutex;
+std::unordered_map<std::string, int64_t> emitted_code_bytes;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Object transform recording the size of the text sections of an object
+// under its kernel symbol on its way to the linker.
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+countCodeBytes(std::unique_ptr<llvm::MemoryBuffer> buffer) {
+    auto obj =
+        llvm::object::ObjectFile::createObjectFile(buffer->getMemBufferRef());
+    if (!obj) {
+        llvm::consumeError(obj.takeError());
+        return std::move(buffer);
+    }
+    int64_t bytes = 0;
+    for (const auto& section : (*obj)->sections()) {
+        if (section.isText()) {
+            bytes += static_cast<int64_t>(section.getSize());
+        }
+    }
+    for (const auto& symbol : (*obj)->symbols()) {
+        auto flags = symbol.getFlags();
+        auto name = symbol.getName();
+        if (!flags || !name) {
+            llvm::consumeError(flags.takeError());
+            llvm::consumeError(name.takeError());
+            continue;
+        }
+        const bool defined =
+            (*flags & llvm::object::SymbolRef::SF_Undefined) == 0;
+        if (defined && (name->starts_with("process_") ||
+                        name->starts_with("_process_"))) {
+            const std::scoped_lock lock(emitted_mutex);
+            emitted_code_bytes[name->str()] = bytes;
+            break;
+        }
+    }
+    return std::move(buffer);
+}
+
+} // namespace
+
+int64_t jitCodeBytes() { return code_bytes.load(); }
+
+JitCode::JitCode(llvm::orc::ResourceTrackerSP tracker_in, int64_t bytes_in)
+    : tracker(std::move(tracker_in)), bytes(bytes_in) {
+    code_bytes += bytes;
+}
+
+JitCode::~JitCode() {
+    if (auto err = tracker->remove()) {
+        llvm::errs() << "Failed to unload JIT code: "
+                     << llvm::toString(std::move(err)) << "\n";
+        return;
+    }
+    code_bytes -= bytes;
+}
+
+bool jitDebugEnabled() {
+    static const bool enabled = [] {
+        const char* value = std::getenv( // NOLINT(concurrency-mt-unsafe)
+            "LLVMEXPR_JIT_DEBUG");
+        return value != nullptr && std::string_view(value) == "1";
+    }();
+    return enabled;
+}
+
+std::string writeDebugSource(const std::string& name,
+                             const std::string& source) {
+    int fd = -1;
+    llvm::SmallString<128> path;
+    if (const std::error_code ec =
+            llvm::sys::fs::createTemporaryFile(name, "expr", fd, path)) {
+        throw std::runtime_error(std::format(
+            "Cannot create debug source file for {}: {}", name, ec.message()));
+    }
+    llvm::raw_fd_ostream stream(fd, /*shouldClose=*/true);
+    stream << source;
+    return path.str().str();
+}
+
 OrcJit::OrcJit(bool no_nans_fp_math) {
     static struct LLVMInitializer {
         LLVMInitializer() { // NOLINT(modernize-use-equals-default)
@@ -72,9 +242,27 @@ OrcJit::OrcJit(bool no_nans_fp_math) {
     Opts.NoInfsFPMath = true;
     Opts.NoNaNsFPMath = no_nans_fp_math;
     jtmb.setOptions(Opts);
+    target_builder =
+        std::make_unique<llvm::orc::JITTargetMachineBuilder>(jtmb);
 
     auto jit_builder = llvm::orc::LLJITBuilder();
     jit_builder.setJITTargetMachineBuilder(std::move(jtmb));
+    if (jitDebugEnabled()) {
+        // JIT event listeners are only supported by RuntimeDyld. The
+        // parameters after the session differ between LLVM versions.
+        jit_builder.setObjectLinkingLayerCreator(
+            [](llvm::orc::ExecutionSession& session, const auto&... /*args*/)
+                -> llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>> {
+                auto layer =
+                    std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+                        session, [](const auto&... /*args*/) {
+                            return std::make_unique<
+                                llvm::SectionMemoryManager>();
+                        });
+                registerDebugListeners(*layer);
+                return layer;
+            });
+    }
     auto temp_jit = jit_builder.create();
     if (!temp_jit) {
         llvm::errs() << "Failed to create LLJIT instance: "
@@ -82,6 +270,7 @@ OrcJit::OrcJit(bool no_nans_fp_math) {
         throw std::runtime_error("LLJIT creation failed");
     }
     lljit = std::move(*temp_jit);
+    lljit->getObjTransformLayer().setTransform(countCodeBytes);
 
     // Register Host API symbols for dynamic array management
     auto& main_jd = lljit->getMainJITDylib();
@@ -110,49 +299,39 @@ const llvm::DataLayout& OrcJit::getDataLayout() const {
     return lljit->getDataLayout();
 }
 
+std::unique_ptr<llvm::TargetMachine> OrcJit::createTargetMachine() {
+    auto tm = target_builder->createTargetMachine();
+    if (!tm) {
+        throw std::runtime_error("Failed to create target machine: " +
+                                 llvm::toString(tm.takeError()));
+    }
+    return std::move(*tm);
+}
+
 const llvm::Triple& OrcJit::getTargetTriple() const {
     return lljit->getTargetTriple();
 }
 
-void OrcJit::addModule(std::unique_ptr<llvm::Module> M,
-                       std::unique_ptr<llvm::LLVMContext> Ctx) {
-    std::vector<llvm::Function*> functions_to_remove;
+llvm::orc::ResourceTrackerSP
+OrcJit::addModule(std::unique_ptr<llvm::Module> M,
+                  std::unique_ptr<llvm::LLVMContext> Ctx) {
+    // Math helpers such as fast_exp_v8 are defined by every module using
+    // them; internal linkage keeps the copies apart.
     for (auto& F : *M) {
-        if (!F.isDeclaration()) {
-            std::string func_name = F.getName().str();
-
-            if (!func_name.starts_with("process_plane_")) {
-                if (func_name.starts_with("fast_") ||
-                    func_name.find("_v4") != std::string::npos ||
-                    func_name.find("_v8") != std::string::npos ||
-                    func_name.find("_v16") != std::string::npos) {
-
-                    // Try a test lookup to see if symbol exists
-                    auto test_sym = lljit->lookup(func_name);
-                    if (test_sym) {
-                        // Symbol already exists, mark for removal
-                        functions_to_remove.push_back(&F);
-                        continue;
-                    }
-                    // If test lookup failed, the symbol doesn't exist, so we can add it
-                    llvm::consumeError(test_sym.takeError());
-                }
-            }
+        if (!F.isDeclaration() && !F.getName().starts_with("process_")) {
+            F.setLinkage(llvm::GlobalValue::InternalLinkage);
         }
     }
 
-    // Remove duplicate functions from the module
-    for (auto* F : functions_to_remove) {
-        F->eraseFromParent();
-    }
-
+    auto tracker = lljit->getMainJITDylib().createResourceTracker();
     auto TSM = llvm::orc::ThreadSafeModule(std::move(M), std::move(Ctx));
-    auto Err = lljit->addIRModule(std::move(TSM));
+    auto Err = lljit->addIRModule(tracker, std::move(TSM));
     if (Err) {
         llvm::errs() << "Failed to add IR module: "
                      << llvm::toString(std::move(Err)) << "\n";
         throw std::runtime_error("Failed to add IR module to JIT");
     }
+    return tracker;
 }
 
 void* OrcJit::getFunctionAddress(const std::string& name) {
@@ -166,6 +345,18 @@ void* OrcJit::getFunctionAddress(const std::string& name) {
     return sym->toPtr<void*>();
 }
 
+int64_t OrcJit::takeCodeBytes(const std::string& name) {
+    const std::string symbol = (*lljit->mangleAndIntern(name)).str();
+    const std::scoped_lock lock(emitted_mutex);
+    auto it = emitted_code_bytes.find(symbol);
+    if (it == emitted_code_bytes.end()) {
+        return 0;
+    }
+    const int64_t bytes = it->second;
+    emitted_code_bytes.erase(it);
+    return bytes;
+}
+
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
 // Global JIT instances
 OrcJit global_jit_fast(true);
@@ -174,4 +365,6 @@ OrcJit global_jit_nan_safe(false);
 // JIT cache
 std::unordered_map<std::string, CompiledFunction> jit_cache;
 std::mutex cache_mutex;
+JitCacheCounters jit_cache_counters;
+int64_t jit_cache_generation = 0;
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
\ No newline at end of file
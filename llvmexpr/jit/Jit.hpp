@@ -26,22 +26,45 @@
 #include <string>
 #include <unordered_map>
 
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Triple.h"
 
 using ProcessProc = void (*)(void* context, uint8_t** rwptrs,
                              const int* strides, float* props);
 
+// The code of one module added to a JIT, unloaded when destroyed.
+class JitCode {
+  public:
+    JitCode(llvm::orc::ResourceTrackerSP tracker_in, int64_t bytes_in);
+    JitCode(const JitCode&) = delete;
+    JitCode& operator=(const JitCode&) = delete;
+    JitCode(JitCode&&) = delete;
+    JitCode& operator=(JitCode&&) = delete;
+    ~JitCode();
+
+  private:
+    llvm::orc::ResourceTrackerSP tracker;
+    int64_t bytes;
+};
+
 struct CompiledFunction {
     ProcessProc func_ptr = nullptr;
+    // Built with approximate math (approx_math=2 may have fallen back).
+    bool approx_math = false;
+    // Shared by jit_cache and every filter using the kernel, so the code is
+    // unloaded once it was cleared from the cache and is no longer used.
+    std::shared_ptr<JitCode> code;
 };
 
 class OrcJit {
   private:
     std::unique_ptr<llvm::orc::LLJIT> lljit;
+    std::unique_ptr<llvm::orc::JITTargetMachineBuilder> target_builder;
 
   public:
     explicit OrcJit(bool no_nans_fp_math);
@@ -50,12 +73,34 @@ class OrcJit {
 
     [[nodiscard]] const llvm::Triple& getTargetTriple() const;
 
-    void addModule(std::unique_ptr<llvm::Module> M,
-                   std::unique_ptr<llvm::LLVMContext> Ctx);
+    // Adds a module under a tracker of its own, which unloads it when
+    // removed. Functions other than the process_* kernels are made internal,
+    // so that modules never depend on each other.
+    llvm::orc::ResourceTrackerSP addModule(
+        std::unique_ptr<llvm::Module> M, std::unique_ptr<llvm::LLVMContext> Ctx);
 
     void* getFunctionAddress(const std::string& name);
+
+    // Bytes of machine code emitted for the module defining the kernel
+    // `name`, once getFunctionAddress materialized it. Each module's count
+    // is returned once.
+    int64_t takeCodeBytes(const std::string& name);
+
+    // A target machine generating the same code as the JIT, for inspecting
+    // that code outside of it.
+    std::unique_ptr<llvm::TargetMachine> createTargetMachine();
 };
 
+// Whether LLVMEXPR_JIT_DEBUG=1 asks for kernels to be registered with perf
+// and GDB, and compiled with line tables pointing at their source.
+bool jitDebugEnabled();
+
+// Writes `source` to a new file `<temp dir>/<name>-XXXXXX.expr` for the line
+// tables of a kernel to refer to, and returns its path. The file is kept for
+// perf and GDB to read after the process exits.
+std::string writeDebugSource(const std::string& name,
+                             const std::string& source);
+
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
 // Global JIT instances
 extern OrcJit global_jit_fast;
@@ -66,4 +111,23 @@ extern std::unordered_map<std::string, CompiledFunction> jit_cache;
 extern std::mutex cache_mutex;
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
+// Lookups of jit_cache by filters creating their kernels, and the time spent
+// compiling the misses. Guarded by cache_mutex.
+struct JitCacheCounters {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    double compile_seconds = 0.0;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+extern JitCacheCounters jit_cache_counters;
+
+// Number of times jit_cache was cleared. Kernels compiled before a clear may
+// still be loaded, so it is part of kernel names. Guarded by cache_mutex.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+extern int64_t jit_cache_generation;
+
+// Bytes of machine code currently loaded by both JIT instances.
+int64_t jitCodeBytes();
+
 #endif // LLVMEXPR_JIT_HPP
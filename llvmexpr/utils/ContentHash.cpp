@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ContentHash.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr int LANES = 4;
+constexpr int LANE_ROTATION = 31;
+
+uint64_t load64(const uint8_t* data) {
+    uint64_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t mixLane(uint64_t lane, uint64_t word) {
+    lane ^= word * PRIME_2;
+    return std::rotl(lane, LANE_ROTATION) * PRIME_1;
+}
+
+// Final avalanche of MurmurHash3.
+uint64_t fmix64(uint64_t h) {
+    h ^= h >> 33U;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33U;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33U;
+    return h;
+}
+
+} // namespace
+
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    std::array<uint64_t, LANES> lanes = {seed + PRIME_1, seed ^ PRIME_2,
+                                         seed - PRIME_1, ~seed};
+    constexpr size_t STEP = LANES * sizeof(uint64_t);
+    size_t i = 0;
+    for (; i + STEP <= size; i += STEP) {
+        for (int k = 0; k < LANES; ++k) {
+            lanes[k] =
+                mixLane(lanes[k], load64(data + i + (k * sizeof(uint64_t))));
+        }
+    }
+    uint64_t h = size;
+    for (int k = 0; k < LANES; ++k) {
+        h = mixLane(h, lanes[k]);
+    }
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        h = mixLane(h, load64(data + i));
+    }
+    if (i < size) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        h = mixLane(h, tail);
+    }
+    return fmix64(h);
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_CONTENTHASH_HPP
+#define LLVMEXPR_UTILS_CONTENTHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Hashes `size` bytes, continuing from `seed`. Not cryptographic: it tells
+// apart tiles of video for the Expr tile cache. Bytes are consumed 32 at a
+// time in four independent multiply-xor lanes, which compilers keep in
+// vector registers.
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed);
+
+#endif // LLVMEXPR_UTILS_CONTENTHASH_HPP
@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CpuInfo.hpp"
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <vector>
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t FALLBACK_L2_CACHE_SIZE = size_t{1} << 20;
+
+size_t queryL2CacheSize() {
+#if defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    if (length == 0) {
+        return 0;
+    }
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(
+        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (GetLogicalProcessorInformation(info.data(), &length) == 0) {
+        return 0;
+    }
+    for (const auto& entry : info) {
+        if (entry.Relationship == RelationCache && entry.Cache.Level == 2 &&
+            (entry.Cache.Type == CacheData ||
+             entry.Cache.Type == CacheUnified)) {
+            return entry.Cache.Size;
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    int64_t size = 0;
+    size_t length = sizeof(size);
+    // Apple Silicon reports the L2 per performance cluster; prefer it over
+    // the generic key, which may be absent.
+    if (sysctlbyname("hw.perflevel0.l2cachesize", &size, &length, nullptr,
+                     0) == 0 &&
+        size > 0) {
+        return static_cast<size_t>(size);
+    }
+    length = sizeof(size);
+    if (sysctlbyname("hw.l2cachesize", &size, &length, nullptr, 0) == 0 &&
+        size > 0) {
+        return static_cast<size_t>(size);
+    }
+    return 0;
+#elif defined(_SC_LEVEL2_CACHE_SIZE)
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+size_t getL2CacheSize() {
+    static const size_t size = [] {
+        size_t detected = queryL2CacheSize();
+        return detected != 0 ? detected : FALLBACK_L2_CACHE_SIZE;
+    }();
+    return size;
+}
@@ -0,0 +1,29 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_CPUINFO_HPP
+#define LLVMEXPR_UTILS_CPUINFO_HPP
+
+#include <cstddef>
+
+// Size in bytes of the per-core L2 data cache of the host. Queried once and
+// cached; falls back to a conservative 1 MiB when the OS does not report it.
+size_t getL2CacheSize();
+
+#endif // LLVMEXPR_UTILS_CPUINFO_HPP
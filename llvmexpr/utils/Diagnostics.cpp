@@ -19,6 +19,7 @@
 
 #include "Diagnostics.hpp"
 
+#include <algorithm>
 #include <string>
 
 #include "llvm/IR/DiagnosticPrinter.h"
@@ -45,7 +46,23 @@ void VectorizationDiagnosticHandler::handleDiagnostic(
         llvm::DiagnosticPrinterRawOStream printer(stream);
         DI.print(printer);
 
-        if (msg.find("loop not vectorized") != std::string::npos) {
+        // Only the remarks LLVM emits by default decide the fallback, so
+        // that collecting a report does not change the generated code.
+        bool emitted_by_default = true;
+        if (const auto* remark =
+                llvm::dyn_cast<llvm::DiagnosticInfoOptimizationBase>(&DI)) {
+            if (report != nullptr) {
+                collectRemark(*remark, msg);
+                const auto* analysis =
+                    llvm::dyn_cast<llvm::OptimizationRemarkAnalysis>(&DI);
+                emitted_by_default =
+                    DI.getSeverity() == llvm::DS_Warning ||
+                    (analysis != nullptr && analysis->shouldAlwaysPrint());
+            }
+        }
+
+        if (emitted_by_default &&
+            msg.find("loop not vectorized") != std::string::npos) {
             vectorization_failed.store(true);
             should_suppress = true;
         }
@@ -65,8 +82,85 @@ void VectorizationDiagnosticHandler::reset() {
     vectorization_failed.store(false);
 }
 
+void VectorizationDiagnosticHandler::setReport(KernelReport* report_in) {
+    report = report_in;
+}
+
+void VectorizationDiagnosticHandler::collectRemark(
+    const llvm::DiagnosticInfoOptimizationBase& remark,
+    const std::string& msg) {
+    const llvm::StringRef pass = remark.getPassName();
+    const llvm::StringRef name = remark.getRemarkName();
+
+    if (pass == "regalloc" && name == "SpillReloadCopies") {
+        for (const auto& arg : remark.getArgs()) {
+            int count = 0;
+            if (llvm::StringRef(arg.Val).getAsInteger(10, count)) {
+                continue;
+            }
+            if (arg.Key == "NumSpills" || arg.Key == "NumFoldedSpills") {
+                report->spills += count;
+            } else if (arg.Key == "NumReloads" ||
+                       arg.Key == "NumFoldedReloads") {
+                report->reloads += count;
+            }
+        }
+        return;
+    }
+
+    if (pass == "loop-vectorize" &&
+        (name == "Vectorized" || name == "Interleaved")) {
+        KernelReport::VectorizedLoop loop;
+        for (const auto& arg : remark.getArgs()) {
+            llvm::StringRef value(arg.Val);
+            if (arg.Key == "VectorizationFactor") {
+                loop.scalable = value.consume_front("vscale x ");
+                value.getAsInteger(10, loop.width);
+            } else if (arg.Key == "InterleaveCount") {
+                value.getAsInteger(10, loop.interleave);
+            }
+        }
+        report->vectorized_loops.push_back(loop);
+        return;
+    }
+
+    // Later O3 rounds revisit the loops that were vectorized already.
+    if (!remark.isPassed() &&
+        msg.find("loop not vectorized") != std::string::npos &&
+        msg.find("already been vectorized") == std::string::npos) {
+        const std::string reason = remark.getMsg();
+        if (std::ranges::find(report->vectorize_failures, reason) ==
+            report->vectorize_failures.end()) {
+            report->vectorize_failures.push_back(reason);
+        }
+    }
+}
+
 void VectorizationDiagnosticHandler::diagnosticHandlerCallback(
     const llvm::DiagnosticInfo* DI, void* Context) {
     static_cast<VectorizationDiagnosticHandler*>(Context)->handleDiagnostic(
         *DI);
 }
+
+RemarkDiagnosticHandler::RemarkDiagnosticHandler(
+    VectorizationDiagnosticHandler* handler)
+    : llvm::DiagnosticHandler(
+          handler,
+          VectorizationDiagnosticHandler::diagnosticHandlerCallback) {}
+
+bool RemarkDiagnosticHandler::isAnalysisRemarkEnabled(
+    llvm::StringRef pass_name) const {
+    return pass_name == "loop-vectorize";
+}
+
+bool RemarkDiagnosticHandler::isMissedOptRemarkEnabled(
+    llvm::StringRef pass_name) const {
+    return pass_name == "loop-vectorize" || pass_name == "regalloc";
+}
+
+bool RemarkDiagnosticHandler::isPassedOptRemarkEnabled(
+    llvm::StringRef pass_name) const {
+    return pass_name == "loop-vectorize";
+}
+
+bool RemarkDiagnosticHandler::isAnyRemarkEnabled() const { return true; }
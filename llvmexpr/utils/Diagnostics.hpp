@@ -25,6 +25,8 @@
 #include "llvm/IR/DiagnosticHandler.h"
 #include "llvm/IR/DiagnosticInfo.h"
 
+#include "KernelReport.hpp"
+
 class VectorizationDiagnosticHandler {
   public:
     VectorizationDiagnosticHandler();
@@ -39,6 +41,11 @@ class VectorizationDiagnosticHandler {
 
     void reset();
 
+    // Also collects the vectorizer and register allocator remarks into
+    // `report` (nullptr to stop). The remarks must be enabled by installing
+    // a RemarkDiagnosticHandler.
+    void setReport(KernelReport* report_in);
+
     static void diagnosticHandlerCallback(const llvm::DiagnosticInfo* DI,
                                           void* Context);
 
@@ -46,6 +53,28 @@ class VectorizationDiagnosticHandler {
     std::atomic<bool> vectorization_failed;
     llvm::DiagnosticHandler::DiagnosticHandlerTy original_handler;
     void* original_context;
+    KernelReport* report = nullptr;
+
+    void collectRemark(const llvm::DiagnosticInfoOptimizationBase& remark,
+                       const std::string& msg);
+};
+
+// Context diagnostic handler enabling the remarks a KernelReport is built
+// from, which LLVM does not emit by default, and passing all diagnostics on
+// to `handler`.
+class RemarkDiagnosticHandler : public llvm::DiagnosticHandler {
+  public:
+    explicit RemarkDiagnosticHandler(VectorizationDiagnosticHandler* handler);
+
+    using llvm::DiagnosticHandler::isAnyRemarkEnabled;
+
+    [[nodiscard]] bool
+    isAnalysisRemarkEnabled(llvm::StringRef pass_name) const override;
+    [[nodiscard]] bool
+    isMissedOptRemarkEnabled(llvm::StringRef pass_name) const override;
+    [[nodiscard]] bool
+    isPassedOptRemarkEnabled(llvm::StringRef pass_name) const override;
+    [[nodiscard]] bool isAnyRemarkEnabled() const override;
 };
 
 #endif // LLVMEXPR_UTILS_DIAGNOSTICS_HPP
@@ -0,0 +1,226 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "IntegralImage.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "CpuInfo.hpp"
+
+namespace {
+
+float halfToFloat(uint16_t h) {
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000U) << 16;
+    uint32_t exponent = (h >> 10) & 0x1FU;
+    uint32_t mantissa = h & 0x3FFU;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return std::bit_cast<float>(sign);
+        }
+        // Subnormal: renormalize.
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400U) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        mantissa &= 0x3FFU;
+        return std::bit_cast<float>(sign | (exponent << 23) | (mantissa << 13));
+    }
+    if (exponent == 0x1F) {
+        return std::bit_cast<float>(sign | 0x7F800000U | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) |
+                                (mantissa << 13));
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+}
+
+template <typename T>
+double loadSample(const uint8_t* row, int x) {
+    T value{};
+    std::memcpy(&value, row + (static_cast<ptrdiff_t>(x) * sizeof(T)),
+                sizeof(T));
+    return static_cast<double>(value);
+}
+
+template <typename LoadFn>
+void accumulate(const uint8_t* src, ptrdiff_t stride, int width, int height,
+                double* table, LoadFn load) {
+    const size_t tw = static_cast<size_t>(width) + 1;
+    std::memset(table, 0, tw * sizeof(double));
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = src + (static_cast<ptrdiff_t>(y) * stride);
+        const double* above = table + (static_cast<size_t>(y) * tw);
+        double* cur = table + ((static_cast<size_t>(y) + 1) * tw);
+        double row_sum = 0.0;
+        cur[0] = 0.0;
+        for (int x = 0; x < width; ++x) {
+            row_sum += load(row, x);
+            cur[x + 1] = above[x + 1] + row_sum;
+        }
+    }
+}
+
+double loadHalfSample(const uint8_t* row, int x) {
+    uint16_t bits = 0;
+    std::memcpy(&bits, row + (static_cast<ptrdiff_t>(x) * 2), 2);
+    return static_cast<double>(halfToFloat(bits));
+}
+
+// Invokes `fn` with the sample loader matching `format`.
+template <typename Fn> void withSampleLoader(const VSVideoFormat& format, Fn fn) {
+    if (format.sampleType == stInteger) {
+        switch (format.bytesPerSample) {
+        case 1:
+            fn(loadSample<uint8_t>);
+            return;
+        case 2:
+            fn(loadSample<uint16_t>);
+            return;
+        case 4:
+            fn(loadSample<uint32_t>);
+            return;
+        default:
+            break;
+        }
+    } else if (format.bytesPerSample == 4) {
+        fn(loadSample<float>);
+        return;
+    } else if (format.bytesPerSample == 2) {
+        fn(loadHalfSample);
+        return;
+    }
+    throw std::runtime_error("Unsupported sample format for integral image.");
+}
+
+} // anonymous namespace
+
+void computeIntegralImage(const uint8_t* src, ptrdiff_t stride, int width,
+                          int height, const VSVideoFormat& format,
+                          std::vector<double>& table) {
+    table.resize((static_cast<size_t>(width) + 1) *
+                 (static_cast<size_t>(height) + 1));
+    withSampleLoader(format, [&](auto load) {
+        accumulate(src, stride, width, height, table.data(), load);
+    });
+}
+
+void loadPlaneSamples(const uint8_t* src, ptrdiff_t stride, int width,
+                      int height, const VSVideoFormat& format,
+                      std::vector<double>& samples) {
+    samples.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    withSampleLoader(format, [&](auto load) {
+        double* dst = samples.data();
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* row = src + (static_cast<ptrdiff_t>(y) * stride);
+            for (int x = 0; x < width; ++x) {
+                *dst++ = load(row, x);
+            }
+        }
+    });
+}
+
+void computePatchDistance(const std::vector<double>& samples, int width,
+                          int height, int dx, int dy, int radius, int y0,
+                          int y1, float* distances,
+                          PatchDistanceScratch& scratch) {
+    const auto clamp_x = [width](int x) { return std::clamp(x, 0, width - 1); };
+    const auto clamp_y = [height](int y) {
+        return std::clamp(y, 0, height - 1);
+    };
+    const auto sample = [&](int x, int y) {
+        return samples[(static_cast<size_t>(y) * width) + x];
+    };
+
+    const int diameter = (2 * radius) + 1;
+    const size_t w = width;
+
+    // Horizontal box sums of the squared difference plane, one row per patch
+    // row, kept in a ring buffer indexed by (y + radius) % diameter.
+    std::vector<double>& ring = scratch.ring;
+    std::vector<double>& prefix = scratch.prefix;
+    ring.resize(static_cast<size_t>(diameter) * w);
+    prefix.resize(w + diameter);
+    const auto ring_row = [&](int y) {
+        return ring.data() +
+               (static_cast<size_t>((y + radius) % diameter) * w);
+    };
+    const auto fill_row = [&](int y) {
+        const int ya = clamp_y(y);
+        const int yb = clamp_y(y + dy);
+        prefix[0] = 0.0;
+        for (int i = 0; i < width + diameter - 1; ++i) {
+            const int x = i - radius;
+            const double diff =
+                sample(clamp_x(x), ya) - sample(clamp_x(x + dx), yb);
+            prefix[i + 1] = prefix[i] + (diff * diff);
+        }
+        double* row = ring_row(y);
+        for (size_t x = 0; x < w; ++x) {
+            row[x] = prefix[x + diameter] - prefix[x];
+        }
+    };
+
+    // Vertical running sums over the ring buffer, starting with the patch
+    // rows of y0.
+    std::vector<double>& column = scratch.column;
+    column.assign(w, 0.0);
+    for (int y = y0 - radius; y <= y0 + radius; ++y) {
+        fill_row(y);
+        const double* row = ring_row(y);
+        for (size_t x = 0; x < w; ++x) {
+            column[x] += row[x];
+        }
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        float* out = distances + (static_cast<size_t>(y - y0) * w);
+        for (size_t x = 0; x < w; ++x) {
+            out[x] = static_cast<float>(std::max(column[x], 0.0));
+        }
+        if (y + 1 == y1) {
+            break;
+        }
+        // Slide the window down: drop row y - radius, add row y + radius + 1.
+        const double* old_row = ring_row(y - radius);
+        for (size_t x = 0; x < w; ++x) {
+            column[x] -= old_row[x];
+        }
+        fill_row(y + radius + 1);
+        const double* new_row = ring_row(y + radius + 1);
+        for (size_t x = 0; x < w; ++x) {
+            column[x] += new_row[x];
+        }
+    }
+}
+
+int patchDistanceBandRows(size_t num_patches, int width, int height,
+                          int row_multiple) {
+    constexpr int MIN_BAND_ROWS = 32;
+    const size_t row_bytes = num_patches * patchDistanceStride(width);
+    const auto budget_rows =
+        static_cast<int>(getL2CacheSize() / 2 / row_bytes);
+    const int band =
+        std::max(budget_rows / row_multiple * row_multiple, MIN_BAND_ROWS);
+    return std::min(band, height);
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_INTEGRALIMAGE_HPP
+#define LLVMEXPR_UTILS_INTEGRALIMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "VapourSynth4.h"
+
+// Computes the summed-area table of a plane into `table`.
+// The table has (width + 1) x (height + 1) entries with a zero first row and
+// column, so that the sum over the inclusive rectangle [x0, x1] x [y0, y1] is
+//   T[y1 + 1][x1 + 1] - T[y0][x1 + 1] - T[y1 + 1][x0] + T[y0][x0].
+// Accumulation is done in double. Sums stay below 2^53, and so are exact, for
+// integer formats of up to 16 bits on planes of up to 2^37 pixels. Float
+// formats accumulate without the drift of a float table.
+void computeIntegralImage(const uint8_t* src, ptrdiff_t stride, int width,
+                          int height, const VSVideoFormat& format,
+                          std::vector<double>& table);
+
+// Row stride of an integral table in bytes.
+constexpr int integralImageStride(int width) {
+    return (width + 1) * static_cast<int>(sizeof(double));
+}
+
+// Converts a plane to a dense width x height array of doubles.
+void loadPlaneSamples(const uint8_t* src, ptrdiff_t stride, int width,
+                      int height, const VSVideoFormat& format,
+                      std::vector<double>& samples);
+
+// Buffers of computePatchDistance, reused across calls.
+struct PatchDistanceScratch {
+    std::vector<double> ring;
+    std::vector<double> prefix;
+    std::vector<double> column;
+};
+
+// Computes, for every pixel p of rows [y0, y1), the sum of squared
+// differences between the (2 * radius + 1)^2 patch centred at p and the one
+// centred at p + (dx, dy). Coordinates are clamped to the plane, matching
+// clamped pixel access. Each output costs O(1) thanks to separable running
+// sums, so a search window of S offsets costs O(S) per pixel instead of
+// O(S * patch size), plus 2 * radius rows of warm-up per call.
+// `distances` receives a dense width x (y1 - y0) band.
+void computePatchDistance(const std::vector<double>& samples, int width,
+                          int height, int dx, int dy, int radius, int y0,
+                          int y1, float* distances,
+                          PatchDistanceScratch& scratch);
+
+// Row stride of a patch distance plane in bytes.
+constexpr int patchDistanceStride(int width) {
+    return width * static_cast<int>(sizeof(float));
+}
+
+// Rows per band of `num_patches` distance planes of a width x height plane:
+// as many as keep the bands within half of L2, in multiples of
+// `row_multiple`, and at least 32.
+int patchDistanceBandRows(size_t num_patches, int width, int height,
+                          int row_multiple);
+
+#endif // LLVMEXPR_UTILS_INTEGRALIMAGE_HPP
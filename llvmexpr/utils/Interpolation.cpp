@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Interpolation.hpp"
+
+#include <cmath>
+#include <numbers>
+
+double interpolationKernel(InterpKind kind, double t) {
+    const double at = std::abs(t);
+    switch (kind) {
+    case InterpKind::BILINEAR:
+        return at < 1.0 ? 1.0 - at : 0.0;
+    case InterpKind::BICUBIC:
+        // Catmull-Rom (Keys, a = -0.5)
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+        if (at < 1.0) {
+            return ((1.5 * at - 2.5) * at * at) + 1.0;
+        }
+        if (at < 2.0) {
+            return (((-0.5 * at + 2.5) * at - 4.0) * at) + 2.0;
+        }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+        return 0.0;
+    case InterpKind::LANCZOS2: {
+        if (at == 0.0) {
+            return 1.0;
+        }
+        if (at >= 2.0) {
+            return 0.0;
+        }
+        const double pt = std::numbers::pi * at;
+        return 2.0 * std::sin(pt) * std::sin(pt / 2.0) / (pt * pt);
+    }
+    }
+    return 0.0;
+}
+
+std::vector<std::pair<int, double>> interpolationTaps(InterpKind kind,
+                                                      double pos) {
+    constexpr double EPSILON = 1e-9;
+    const double base = std::floor(pos);
+    const int first = static_cast<int>(base) + interpolationFirstTap(kind);
+
+    std::vector<std::pair<int, double>> taps;
+    double sum = 0.0;
+    for (int k = 0; k < interpolationTapCount(kind); ++k) {
+        const double weight =
+            interpolationKernel(kind, static_cast<double>(first + k) - pos);
+        if (std::abs(weight) > EPSILON) {
+            taps.emplace_back(first + k, weight);
+            sum += weight;
+        }
+    }
+    for (auto& tap : taps) {
+        tap.second /= sum;
+    }
+    return taps;
+}
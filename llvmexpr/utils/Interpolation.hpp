@@ -0,0 +1,49 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ *
+ * This file is part of Vapoursynth-llvmexpr.
+ *
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_INTERPOLATION_HPP
+#define LLVMEXPR_UTILS_INTERPOLATION_HPP
+
+#include <utility>
+#include <vector>
+
+#include "../frontend/Tokenizer.hpp"
+
+// The taps of an interpolation kernel sampling position p along one axis sit
+// at floor(p) + interpolationFirstTap(kind) + k for k in
+// [0, interpolationTapCount(kind)).
+constexpr int interpolationFirstTap(InterpKind kind) {
+    return kind == InterpKind::BILINEAR ? 0 : -1;
+}
+
+constexpr int interpolationTapCount(InterpKind kind) {
+    return kind == InterpKind::BILINEAR ? 2 : 4;
+}
+
+// Kernel value at distance t from the sampling position.
+double interpolationKernel(InterpKind kind, double t);
+
+// Integer offsets and weights of the taps sampling position `pos`, for
+// positions known at compile time. Weights are normalized to sum to 1 and
+// taps with zero weight are dropped, so an integer position yields a single
+// tap.
+std::vector<std::pair<int, double>> interpolationTaps(InterpKind kind,
+                                                      double pos);
+
+#endif // LLVMEXPR_UTILS_INTERPOLATION_HPP
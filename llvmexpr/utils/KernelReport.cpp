@@ -0,0 +1,462 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KernelReport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+namespace {
+
+// Kind of an IR instruction in the instruction mix.
+std::string_view instructionKind(const llvm::Instruction& inst) {
+    if (const auto* intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(&inst)) {
+        switch (intrinsic->getIntrinsicID()) {
+        case llvm::Intrinsic::masked_load:
+            return "load";
+        case llvm::Intrinsic::masked_store:
+            return "store";
+        case llvm::Intrinsic::masked_gather:
+            return "gather";
+        case llvm::Intrinsic::masked_scatter:
+            return "scatter";
+        case llvm::Intrinsic::fma:
+        case llvm::Intrinsic::fmuladd:
+            return "fp arith";
+        default:
+            return "intrinsic";
+        }
+    }
+    if (llvm::isa<llvm::CallInst>(inst)) {
+        return "call";
+    }
+    if (llvm::isa<llvm::CastInst>(inst)) {
+        return "conversion";
+    }
+    switch (inst.getOpcode()) {
+    case llvm::Instruction::Load:
+        return "load";
+    case llvm::Instruction::Store:
+        return "store";
+    case llvm::Instruction::FAdd:
+    case llvm::Instruction::FSub:
+    case llvm::Instruction::FMul:
+    case llvm::Instruction::FDiv:
+    case llvm::Instruction::FRem:
+    case llvm::Instruction::FNeg:
+        return "fp arith";
+    case llvm::Instruction::Add:
+    case llvm::Instruction::Sub:
+    case llvm::Instruction::Mul:
+    case llvm::Instruction::UDiv:
+    case llvm::Instruction::SDiv:
+    case llvm::Instruction::URem:
+    case llvm::Instruction::SRem:
+    case llvm::Instruction::Shl:
+    case llvm::Instruction::LShr:
+    case llvm::Instruction::AShr:
+    case llvm::Instruction::And:
+    case llvm::Instruction::Or:
+    case llvm::Instruction::Xor:
+        return "int arith";
+    case llvm::Instruction::ICmp:
+    case llvm::Instruction::FCmp:
+        return "compare";
+    case llvm::Instruction::Select:
+        return "select";
+    case llvm::Instruction::ShuffleVector:
+    case llvm::Instruction::ExtractElement:
+    case llvm::Instruction::InsertElement:
+        return "shuffle";
+    case llvm::Instruction::GetElementPtr:
+        return "address";
+    case llvm::Instruction::PHI:
+    case llvm::Instruction::Br:
+    case llvm::Instruction::Switch:
+        return "control";
+    default:
+        return "other";
+    }
+}
+
+// Counts the instructions of the largest innermost loop of `func`.
+void countHotLoop(KernelReport& report, llvm::Function& func) {
+    const llvm::DominatorTree dom_tree(func);
+    const llvm::LoopInfo loop_info(dom_tree);
+    const llvm::Loop* hot_loop = nullptr;
+    size_t hot_size = 0;
+    for (const llvm::Loop* loop : loop_info.getLoopsInPreorder()) {
+        if (!loop->isInnermost()) {
+            continue;
+        }
+        size_t size = 0;
+        for (const llvm::BasicBlock* block : loop->blocks()) {
+            size += block->size();
+        }
+        if (size > hot_size) {
+            hot_loop = loop;
+            hot_size = size;
+        }
+    }
+    if (hot_loop == nullptr) {
+        return;
+    }
+    for (const llvm::BasicBlock* block : hot_loop->blocks()) {
+        for (const llvm::Instruction& inst : *block) {
+            ++report.instruction_mix[std::string(instructionKind(inst))];
+            ++report.hot_loop_instructions;
+            if (inst.getType()->isVectorTy()) {
+                ++report.hot_loop_vector_instructions;
+            }
+        }
+    }
+}
+
+// Runs the code generator of `tm` on a copy of `module`.
+std::string emitCode(const llvm::Module& module, llvm::TargetMachine& tm,
+                     llvm::CodeGenFileType type) {
+    const std::unique_ptr<llvm::Module> copy = llvm::CloneModule(module);
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream stream(buffer);
+    llvm::legacy::PassManager pass_manager;
+    if (tm.addPassesToEmitFile(pass_manager, stream, nullptr, type)) {
+        throw std::runtime_error("The target cannot emit this file type.");
+    }
+    pass_manager.run(*copy);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+uint64_t codeSize(const std::string& object) {
+    auto file = llvm::object::ObjectFile::createObjectFile(
+        llvm::MemoryBufferRef(object, "kernel"));
+    if (!file) {
+        llvm::consumeError(file.takeError());
+        return 0;
+    }
+    uint64_t bytes = 0;
+    for (const auto& [symbol, size] :
+         llvm::object::computeSymbolSizes(**file)) {
+        auto type = symbol.getType();
+        if (!type) {
+            llvm::consumeError(type.takeError());
+            continue;
+        }
+        if (*type == llvm::object::SymbolRef::ST_Function) {
+            bytes += size;
+        }
+    }
+    return bytes;
+}
+
+std::string_view trim(std::string_view text) {
+    const size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// A basic block of verbose assembly: its label (empty for blocks entered by
+// falling through), the comments after the label, and its instructions.
+struct AsmBlock {
+    std::string label;
+    std::string comments;
+    std::vector<std::string> instructions;
+};
+
+std::vector<AsmBlock> parseAsmBlocks(const std::string& assembly,
+                                     std::string_view comment) {
+    std::vector<AsmBlock> blocks(1);
+    std::istringstream stream(assembly);
+    std::string line;
+    while (std::getline(stream, line)) {
+        const std::string_view text = trim(line);
+        if (text.empty()) {
+            continue;
+        }
+        if (text.starts_with(comment)) {
+            // Blocks without a label start with "# %bb.N:".
+            if (trim(text.substr(comment.size())).starts_with("%bb.")) {
+                blocks.emplace_back();
+            }
+            blocks.back().comments += text;
+            blocks.back().comments += '\n';
+            continue;
+        }
+        const size_t comment_pos = text.find(comment);
+        const std::string_view code = trim(text.substr(0, comment_pos));
+        if (line.front() != ' ' && line.front() != '\t' &&
+            code.ends_with(':')) {
+            blocks.emplace_back();
+            blocks.back().label = code.substr(0, code.size() - 1);
+            if (comment_pos != std::string_view::npos) {
+                blocks.back().comments += text.substr(comment_pos);
+                blocks.back().comments += '\n';
+            }
+        } else if (!code.empty() && !code.starts_with('.')) {
+            blocks.back().instructions.emplace_back(code);
+        }
+    }
+    return blocks;
+}
+
+// The largest innermost loop of the verbose `assembly`, as llvm-mca input.
+// The loop comments of the asm printer name blocks BB<function>_<block>,
+// without the private label prefix.
+std::string hotLoopAssembly(const std::string& assembly,
+                            std::string_view comment) {
+    const std::vector<AsmBlock> blocks = parseAsmBlocks(assembly, comment);
+    std::string best;
+    size_t best_size = 0;
+    for (const auto& header : blocks) {
+        const size_t bb = header.label.find("BB");
+        if (header.comments.find("Inner Loop Header") == std::string::npos ||
+            bb == std::string::npos) {
+            continue;
+        }
+        const std::string member =
+            std::format("in Loop: Header={} ", header.label.substr(bb));
+        std::string loop;
+        size_t size = 0;
+        for (const auto& block : blocks) {
+            if (&block != &header &&
+                block.comments.find(member) == std::string::npos) {
+                continue;
+            }
+            if (!block.label.empty()) {
+                loop += block.label + ":\n";
+            }
+            for (const auto& inst : block.instructions) {
+                loop += inst + '\n';
+            }
+            size += block.instructions.size();
+        }
+        if (size > best_size) {
+            best = std::move(loop);
+            best_size = size;
+        }
+    }
+    return best;
+}
+
+// llvm-mca as given by LLVMEXPR_LLVM_MCA (a path, or a name looked up in
+// PATH), or else llvm-mca-<major> for the LLVM the plugin was built with or
+// llvm-mca from PATH. `name` is set to the program looked up last.
+llvm::ErrorOr<std::string> findLlvmMca(std::string& name) {
+    const char* path = std::getenv( // NOLINT(concurrency-mt-unsafe)
+        "LLVMEXPR_LLVM_MCA");
+    if (path != nullptr && *path != '\0') {
+        name = path;
+        return llvm::sys::findProgramByName(name);
+    }
+    name = "llvm-mca-" + std::to_string(LLVM_VERSION_MAJOR);
+    if (llvm::ErrorOr<std::string> program =
+            llvm::sys::findProgramByName(name)) {
+        return program;
+    }
+    name = "llvm-mca";
+    return llvm::sys::findProgramByName(name);
+}
+
+} // namespace
+
+int KernelReport::pixelsPerIteration() const {
+    int pixels = 1;
+    for (const auto& loop : vectorized_loops) {
+        pixels = std::max(pixels, loop.width * loop.interleave);
+    }
+    return pixels;
+}
+
+std::string KernelReport::format() const {
+    std::string text = std::format("{}\n", name);
+    text += std::format("  math: {}\n", approx_math ? "approx" : "precise");
+    if (vectorized_loops.empty()) {
+        text += "  vectorized: no\n";
+    }
+    for (const auto& loop : vectorized_loops) {
+        text += std::format("  vectorized: width {}{}, interleave {}\n",
+                            loop.scalable ? "vscale x " : "", loop.width,
+                            loop.interleave);
+    }
+    for (const auto& failure : vectorize_failures) {
+        text += std::format("  not vectorized: {}\n", failure);
+    }
+    if (hot_loop_instructions > 0) {
+        text += std::format("  hot loop: {} IR instructions, {} vector:",
+                            hot_loop_instructions,
+                            hot_loop_vector_instructions);
+        std::vector<std::pair<std::string, int>> mix(instruction_mix.begin(),
+                                                     instruction_mix.end());
+        std::ranges::stable_sort(mix, [](const auto& a, const auto& b) {
+            return a.second > b.second;
+        });
+        for (size_t i = 0; i < mix.size(); ++i) {
+            text += std::format("{} {} {}", i == 0 ? "" : ",", mix[i].second,
+                                mix[i].first);
+        }
+        text += '\n';
+    }
+    text += std::format("  spills: {}, reloads: {}\n", spills, reloads);
+    text += std::format("  code size: {} bytes\n", code_bytes);
+    if (block_rthroughput >= 0) {
+        const int pixels = pixelsPerIteration();
+        text += std::format(
+            "  throughput: block RThroughput {:.2f} cycles, {:.3f} "
+            "cycles/pixel at {} pixels/iteration (llvm-mca, without "
+            "loop-carried dependencies)\n",
+            block_rthroughput, block_rthroughput / pixels, pixels);
+    } else {
+        text += std::format("  throughput: unavailable ({})\n", mca_error);
+    }
+    return text;
+}
+
+void analyzeKernel(KernelReport& report, llvm::Module& module,
+                   llvm::TargetMachine& tm) {
+    if (llvm::Function* func = module.getFunction(report.name)) {
+        countHotLoop(report, *func);
+    }
+
+    tm.Options.MCOptions.AsmVerbose = true; // loop comments
+    const std::string assembly =
+        emitCode(module, tm, llvm::CodeGenFileType::AssemblyFile);
+
+    // The second run of the code generator reports the same spills again.
+    const std::pair spill_counts{report.spills, report.reloads};
+    report.code_bytes =
+        codeSize(emitCode(module, tm, llvm::CodeGenFileType::ObjectFile));
+    std::tie(report.spills, report.reloads) = spill_counts;
+
+    const llvm::StringRef comment = tm.getMCAsmInfo()->getCommentString();
+    report.hot_loop = hotLoopAssembly(assembly, comment.str());
+    report.triple = tm.getTargetTriple().str();
+    report.cpu = tm.getTargetCPU().str();
+    report.features = tm.getTargetFeatureString().str();
+}
+
+void estimateThroughput(KernelReport& report) {
+    if (report.hot_loop.empty()) {
+        report.mca_error = "no loop found";
+        return;
+    }
+    std::string mca;
+    const llvm::ErrorOr<std::string> program = findLlvmMca(mca);
+    if (!program) {
+        report.mca_error = std::format("could not find {}", mca);
+        return;
+    }
+
+    // Unique files, removed when the FileRemovers go out of scope.
+    int input_fd = -1;
+    llvm::SmallString<128> input_path;
+    llvm::SmallString<128> output_path;
+    if (const std::error_code ec = llvm::sys::fs::createTemporaryFile(
+            "llvmexpr-mca", "s", input_fd, input_path)) {
+        report.mca_error =
+            std::format("could not create a temporary file: {}", ec.message());
+        return;
+    }
+    const llvm::FileRemover input_remover(input_path);
+    {
+        llvm::raw_fd_ostream stream(input_fd, /*shouldClose=*/true);
+        stream << report.hot_loop;
+    }
+    if (const std::error_code ec = llvm::sys::fs::createTemporaryFile(
+            "llvmexpr-mca", "txt", output_path)) {
+        report.mca_error =
+            std::format("could not create a temporary file: {}", ec.message());
+        return;
+    }
+    const llvm::FileRemover output_remover(output_path);
+
+    const std::string triple = "-mtriple=" + report.triple;
+    const std::string cpu = "-mcpu=" + report.cpu;
+    const std::string attr = "-mattr=" + report.features;
+    const std::array<llvm::StringRef, 5> args = {*program, triple, cpu, attr,
+                                                 input_path};
+    // No stdin; stdout and stderr both go to the output file.
+    const std::array<std::optional<llvm::StringRef>, 3> redirects = {
+        llvm::StringRef(""), llvm::StringRef(output_path),
+        llvm::StringRef(output_path)};
+    std::string error;
+    const int status = llvm::sys::ExecuteAndWait(
+        *program, args, std::nullopt, redirects, 0, 0, &error);
+
+    std::ifstream result(output_path.str().str());
+    std::string line;
+    std::string first_line;
+    while (std::getline(result, line)) {
+        if (first_line.empty()) {
+            first_line = line;
+        }
+        constexpr std::string_view key = "Block RThroughput:";
+        if (const size_t pos = line.find(key); pos != std::string::npos) {
+            report.block_rthroughput =
+                std::strtod(line.c_str() + pos + key.size(), nullptr);
+        }
+    }
+
+    if (report.block_rthroughput < 0) {
+        if (!first_line.empty()) {
+            report.mca_error = first_line;
+        } else if (status < 0) {
+            report.mca_error = std::format("could not run {}: {}", mca, error);
+        } else {
+            report.mca_error = std::format("could not run {}", mca);
+        }
+    }
+}
+
+void appendKernelReport(const std::string& path, const KernelReport& report) {
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock(mutex);
+    std::ofstream stream(path, std::ios::app);
+    if (!stream) {
+        throw std::runtime_error(
+            std::format("Cannot open report file '{}'.", path));
+    }
+    stream << report.format() << '\n';
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_KERNELREPORT_HPP
+#define LLVMEXPR_UTILS_KERNELREPORT_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+// Static performance summary of a compiled kernel, for tuning expressions
+// without reading the IR or the assembly.
+struct KernelReport {
+    struct VectorizedLoop {
+        int width = 1; // minimum lanes if scalable
+        bool scalable = false;
+        int interleave = 1;
+    };
+
+    std::string name;
+    bool approx_math = false;
+
+    // From the remarks of the loop vectorizer.
+    std::vector<VectorizedLoop> vectorized_loops;
+    std::vector<std::string> vectorize_failures; // distinct messages
+
+    // From the remarks of the register allocator, over the whole kernel.
+    int spills = 0;
+    int reloads = 0;
+
+    // IR instructions of the hot loop (the largest innermost loop) by kind.
+    std::map<std::string, int> instruction_mix;
+    int hot_loop_instructions = 0;
+    int hot_loop_vector_instructions = 0;
+
+    // Machine code of all functions of the kernel's module.
+    uint64_t code_bytes = 0;
+
+    // Assembly of the hot loop and the target it was compiled for, the
+    // input of llvm-mca.
+    std::string hot_loop;
+    std::string triple;
+    std::string cpu;
+    std::string features;
+
+    // llvm-mca's Block RThroughput of the hot loop: the cycles per iteration
+    // its instructions need from the execution ports, ignoring dependencies
+    // carried from one iteration to the next. A lower bound on the cycles
+    // per iteration. < 0 with the reason in `mca_error` if unavailable.
+    double block_rthroughput = -1.0;
+    std::string mca_error;
+
+    // Pixels one iteration of the widest vectorized loop computes.
+    [[nodiscard]] int pixelsPerIteration() const;
+
+    // A human-readable summary, one item per line.
+    [[nodiscard]] std::string format() const;
+};
+
+// Fills the parts of `report` derived from the optimized `module`: the
+// instruction mix of the hot loop, the code size and the llvm-mca input.
+// The code generator of `tm` runs on copies of the module, and its spill
+// remarks reach the diagnostic handler of the module's context.
+void analyzeKernel(KernelReport& report, llvm::Module& module,
+                   llvm::TargetMachine& tm);
+
+// Fills the llvm-mca estimate of `report` from the input analyzeKernel
+// found. This runs llvm-mca as a child process, so call it without holding
+// locks other threads wait on.
+void estimateThroughput(KernelReport& report);
+
+// Appends `report` to the file at `path`. Safe to call from several threads.
+void appendKernelReport(const std::string& path, const KernelReport& report);
+
+#endif // LLVMEXPR_UTILS_KERNELREPORT_HPP
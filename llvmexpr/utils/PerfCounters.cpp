@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <array>
+#include <utility>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Counters of one thread, opened on its first read and closed when it
+// exits.
+class ThreadCounters {
+  public:
+    ThreadCounters() {
+        constexpr std::array<std::pair<uint32_t, uint64_t>, 3> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        }};
+        for (size_t i = 0; i < events.size(); ++i) {
+            perf_event_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+    }
+
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+    ThreadCounters(ThreadCounters&&) = delete;
+    ThreadCounters& operator=(ThreadCounters&&) = delete;
+    ~ThreadCounters() { close_all(); }
+
+    std::optional<HardwareCounts> read() const {
+        if (fds[0] < 0) {
+            return std::nullopt;
+        }
+        std::array<uint64_t, 3> values = {};
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (::read(fds[i], &values[i], sizeof(uint64_t)) !=
+                sizeof(uint64_t)) {
+                return std::nullopt;
+            }
+        }
+        return HardwareCounts{.cycles = values[0],
+                              .instructions = values[1],
+                              .llc_misses = values[2]};
+    }
+
+  private:
+    std::array<int, 3> fds = {-1, -1, -1};
+
+    void close_all() {
+        for (int& fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            fd = -1;
+        }
+    }
+};
+
+} // namespace
+
+std::optional<HardwareCounts> readHardwareCounters() {
+    thread_local const ThreadCounters counters;
+    return counters.read();
+}
+
+#else
+
+std::optional<HardwareCounts> readHardwareCounters() { return std::nullopt; }
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_PERFCOUNTERS_HPP
+#define LLVMEXPR_UTILS_PERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <optional>
+
+// Hardware events counted on the calling thread.
+struct HardwareCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llc_misses = 0;
+
+    HardwareCounts operator-(const HardwareCounts& other) const {
+        return {.cycles = cycles - other.cycles,
+                .instructions = instructions - other.instructions,
+                .llc_misses = llc_misses - other.llc_misses};
+    }
+};
+
+// Reads the calling thread's hardware counters, opened with perf_event_open
+// on first use. Returns nullopt where they are unavailable: outside Linux,
+// or when perf_event_paranoid forbids them.
+std::optional<HardwareCounts> readHardwareCounters();
+
+#endif // LLVMEXPR_UTILS_PERFCOUNTERS_HPP
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RuntimeStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace {
+
+constexpr double MS_PER_SECOND = 1e3;
+
+// The q-quantile of `values` (nearest rank).
+double quantile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<size_t>(
+        std::ceil(q * static_cast<double>(values.size())));
+    const size_t index = std::clamp<size_t>(rank, 1, values.size()) - 1;
+    std::ranges::nth_element(values, values.begin() +
+                                         static_cast<std::ptrdiff_t>(index));
+    return values[index];
+}
+
+} // namespace
+
+void KernelStats::record(double seconds, int64_t pixels_in,
+                         int64_t bytes_read_in, int64_t bytes_written_in,
+                         const std::optional<HardwareCounts>& hardware_in) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++calls;
+    total_seconds += seconds;
+    pixels += pixels_in;
+    bytes_read += bytes_read_in;
+    bytes_written += bytes_written_in;
+    if (recent_seconds.size() < RECENT_CALLS) {
+        recent_seconds.push_back(seconds);
+    } else {
+        recent_seconds[next_recent] = seconds;
+        next_recent = (next_recent + 1) % RECENT_CALLS;
+    }
+    if (hardware_in) {
+        const HardwareCounts total = hardware.value_or(HardwareCounts{});
+        hardware = HardwareCounts{
+            .cycles = total.cycles + hardware_in->cycles,
+            .instructions = total.instructions + hardware_in->instructions,
+            .llc_misses = total.llc_misses + hardware_in->llc_misses};
+    }
+}
+
+void KernelStats::recordCompile(double seconds, bool approx_math_in) {
+    std::lock_guard<std::mutex> lock(mutex);
+    compile_seconds = compile_seconds.value_or(0.0) + seconds;
+    approx_math = approx_math_in;
+}
+
+std::string KernelStats::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string json = std::format(
+        R"({{"calls": {}, "total_ms": {:.3f}, "p50_ms": {:.3f}, )"
+        R"("p99_ms": {:.3f}, "mpix_per_s": {:.1f}, "bytes_read": {}, )"
+        R"("bytes_written": {})",
+        calls, total_seconds * MS_PER_SECOND,
+        quantile(recent_seconds, 0.5) * MS_PER_SECOND,
+        quantile(recent_seconds, 0.99) * MS_PER_SECOND,
+        total_seconds > 0.0
+            ? static_cast<double>(pixels) / total_seconds / 1e6
+            : 0.0,
+        bytes_read, bytes_written);
+    if (compile_seconds) {
+        json += std::format(R"(, "compile_ms": {:.3f}, "tier": "{}")",
+                            *compile_seconds * MS_PER_SECOND,
+                            approx_math ? "approx_math" : "precise");
+    }
+    if (hardware) {
+        json += std::format(
+            R"(, "cycles": {}, "instructions": {}, "ipc": {:.2f}, )"
+            R"("llc_misses": {})",
+            hardware->cycles, hardware->instructions,
+            hardware->cycles > 0
+                ? static_cast<double>(hardware->instructions) /
+                      static_cast<double>(hardware->cycles)
+                : 0.0,
+            hardware->llc_misses);
+    }
+    return json + "}";
+}
+
+void KernelStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls = 0;
+    total_seconds = 0.0;
+    pixels = 0;
+    bytes_read = 0;
+    bytes_written = 0;
+    recent_seconds.clear();
+    next_recent = 0;
+    hardware.reset();
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_RUNTIMESTATS_HPP
+#define LLVMEXPR_UTILS_RUNTIMESTATS_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+// Run time of one kernel over the frames a filter instance processed: call
+// count, total and recent percentile times, traffic, and hardware counts
+// when they were collected. Thread-safe.
+class KernelStats {
+  public:
+    void record(double seconds, int64_t pixels, int64_t bytes_read,
+                int64_t bytes_written,
+                const std::optional<HardwareCounts>& hardware);
+
+    // The kernel was compiled by this instance in `seconds` (0 when it came
+    // from the JIT cache), with approximate math or not.
+    void recordCompile(double seconds, bool approx_math);
+
+    // A JSON object with the counters; times are in milliseconds.
+    [[nodiscard]] std::string toJson() const;
+
+    void reset();
+
+  private:
+    // Percentiles are taken over the most recent calls.
+    static constexpr size_t RECENT_CALLS = 1024;
+
+    mutable std::mutex mutex;
+    int64_t calls = 0;
+    double total_seconds = 0.0;
+    int64_t pixels = 0;
+    int64_t bytes_read = 0;
+    int64_t bytes_written = 0;
+    std::vector<double> recent_seconds;
+    size_t next_recent = 0;
+    std::optional<HardwareCounts> hardware;
+    std::optional<double> compile_seconds;
+    bool approx_math = false;
+};
+
+#endif // LLVMEXPR_UTILS_RUNTIMESTATS_HPP
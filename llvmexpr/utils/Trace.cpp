@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// The process-wide time origin of all trace timestamps.
+const TraceFile::Clock::time_point trace_epoch = TraceFile::Clock::now();
+
+std::atomic<int> next_thread_id{1};
+
+int currentThreadId() {
+    thread_local const int id = next_thread_id++;
+    return id;
+}
+
+thread_local TraceFile* current_target = nullptr;
+thread_local PhaseTimes* current_phase_times = nullptr;
+
+double microseconds(TraceFile::Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+std::string escapeJson(std::string_view text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += std::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+TraceFile::TraceFile(const std::string& path) : stream(path) {
+    if (!stream) {
+        throw std::runtime_error(
+            std::format("Could not open trace file {}", path));
+    }
+    stream << "[\n"
+           << R"({"name": "process_name", "ph": "M", "pid": 1, "tid": 0, )"
+           << R"("args": {"name": "llvmexpr"}},)" << "\n";
+    stream.flush();
+}
+
+void TraceFile::addEvent(std::string_view category, std::string_view name,
+                         Clock::time_point start, Clock::time_point end,
+                         std::string_view detail) {
+    const int tid = currentThreadId();
+    std::string event;
+    if (!detail.empty()) {
+        event = std::format(R"(, "args": {{"detail": "{}"}})",
+                            escapeJson(detail));
+    }
+    event = std::format(
+        R"({{"name": "{}", "cat": "{}", "ph": "X", "ts": {:.3f}, )"
+        R"("dur": {:.3f}, "pid": 1, "tid": {}{}}},)"
+        "\n",
+        escapeJson(name), escapeJson(category),
+        microseconds(start - trace_epoch), microseconds(end - start), tid,
+        event);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (named_threads.insert(tid).second) {
+        stream << std::format(
+            R"({{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, )"
+            R"("args": {{"name": "thread {}"}}}},)"
+            "\n",
+            tid, tid);
+    }
+    stream << event;
+    stream.flush();
+}
+
+TraceFile* openTraceFile(const std::string& path) {
+    if (path.empty()) {
+        return nullptr;
+    }
+    // Files stay open for the lifetime of the process, so that instances
+    // sharing a path write to one trace.
+    static std::mutex files_mutex;
+    static std::map<std::string, std::unique_ptr<TraceFile>> files;
+    std::lock_guard<std::mutex> lock(files_mutex);
+    auto& file = files[path];
+    if (!file) {
+        file = std::make_unique<TraceFile>(path);
+    }
+    return file.get();
+}
+
+TraceFile* defaultTraceFile() {
+    const char* path =
+        std::getenv("LLVMEXPR_TRACE"); // NOLINT(concurrency-mt-unsafe)
+    return path != nullptr ? openTraceFile(path) : nullptr;
+}
+
+bool traceKernels() {
+    static const bool enabled = [] {
+        const char* value = std::getenv( // NOLINT(concurrency-mt-unsafe)
+            "LLVMEXPR_TRACE_KERNELS");
+        return value != nullptr && std::string_view(value) == "1";
+    }();
+    return enabled;
+}
+
+TraceTarget::TraceTarget(TraceFile* file) : previous(current_target) {
+    current_target = file;
+}
+
+TraceTarget::~TraceTarget() { current_target = previous; }
+
+PhaseTimes::PhaseTimes() : previous(current_phase_times) {
+    current_phase_times = this;
+}
+
+PhaseTimes::~PhaseTimes() { current_phase_times = previous; }
+
+TraceScope::TraceScope(std::string_view category_in, std::string name_in,
+                       std::string detail_in)
+    : file(current_target), phase_times(current_phase_times),
+      category(category_in), name(std::move(name_in)),
+      detail(std::move(detail_in)) {
+    if (file != nullptr || phase_times != nullptr) {
+        start = TraceFile::Clock::now();
+    }
+}
+
+TraceScope::~TraceScope() {
+    if (file == nullptr && phase_times == nullptr) {
+        return;
+    }
+    const TraceFile::Clock::time_point end = TraceFile::Clock::now();
+    if (file != nullptr) {
+        file->addEvent(category, name, start, end, detail);
+    }
+    if (phase_times != nullptr) {
+        phase_times->totals[name] +=
+            std::chrono::duration<double>(end - start).count();
+    }
+}
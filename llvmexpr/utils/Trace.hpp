@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2025 yuygfgg
+ * 
+ * This file is part of Vapoursynth-llvmexpr.
+ * 
+ * Vapoursynth-llvmexpr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Vapoursynth-llvmexpr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LLVMEXPR_UTILS_TRACE_HPP
+#define LLVMEXPR_UTILS_TRACE_HPP
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+
+// A trace in the Chrome trace event format (JSON array), readable by
+// chrome://tracing and Perfetto. Each thread gets its own track. Events are
+// written and flushed as they complete, and the closing bracket the format
+// allows to omit is never written, so the file stays valid if the process
+// exits at any point.
+class TraceFile {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TraceFile(const std::string& path);
+
+    // Records a complete event on the calling thread's track. `detail`, if
+    // not empty, is shown as the event's argument.
+    void addEvent(std::string_view category, std::string_view name,
+                  Clock::time_point start, Clock::time_point end,
+                  std::string_view detail = {});
+
+  private:
+    std::mutex mutex;
+    std::ofstream stream;
+    std::set<int> named_threads;
+};
+
+// The trace file at `path`, opened on first use and shared by all callers.
+// Returns nullptr for an empty path, and throws std::runtime_error when the
+// file cannot be created.
+TraceFile* openTraceFile(const std::string& path);
+
+// The trace file named by the LLVMEXPR_TRACE environment variable, or
+// nullptr when it is not set.
+TraceFile* defaultTraceFile();
+
+// Whether LLVMEXPR_TRACE_KERNELS=1 asks for kernel calls to be traced, not
+// only compilation.
+bool traceKernels();
+
+// Directs the TraceScopes of the calling thread to `file` (no tracing when
+// nullptr) until destroyed.
+class TraceTarget {
+  public:
+    explicit TraceTarget(TraceFile* file);
+    ~TraceTarget();
+
+    TraceTarget(const TraceTarget&) = delete;
+    TraceTarget& operator=(const TraceTarget&) = delete;
+    TraceTarget(TraceTarget&&) = delete;
+    TraceTarget& operator=(TraceTarget&&) = delete;
+
+  private:
+    TraceFile* previous;
+};
+
+// Adds up the time of the TraceScopes of the calling thread by name while it
+// exists, whether or not they go to a trace file. For tools reporting where
+// compilation time goes without writing a trace.
+class PhaseTimes {
+  public:
+    PhaseTimes();
+    ~PhaseTimes();
+
+    PhaseTimes(const PhaseTimes&) = delete;
+    PhaseTimes& operator=(const PhaseTimes&) = delete;
+    PhaseTimes(PhaseTimes&&) = delete;
+    PhaseTimes& operator=(PhaseTimes&&) = delete;
+
+    // Total seconds by scope name. Nested scopes are counted in their own
+    // entry and in that of every enclosing scope.
+    [[nodiscard]] const std::map<std::string, double>& seconds() const {
+        return totals;
+    }
+
+  private:
+    friend class TraceScope;
+
+    PhaseTimes* previous;
+    std::map<std::string, double> totals;
+};
+
+// Records its lifetime as an event in the calling thread's current
+// TraceTarget and PhaseTimes, if any.
+class TraceScope {
+  public:
+    TraceScope(std::string_view category, std::string name,
+               std::string detail = {});
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    TraceScope(TraceScope&&) = delete;
+    TraceScope& operator=(TraceScope&&) = delete;
+
+  private:
+    TraceFile* file;
+    PhaseTimes* phase_times;
+    std::string_view category;
+    std::string name;
+    std::string detail;
+    TraceFile::Clock::time_point start;
+};
+
+#endif // LLVMEXPR_UTILS_TRACE_HPP
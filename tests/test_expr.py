@@ -29,6 +29,7 @@ along with Vapoursynth-llvmexpr.  If not, see <https://www.gnu.org/licenses/>.
 import pytest
 import vapoursynth as vs
 import numpy as np
+import json
 import random
 
 core = vs.core
@@ -253,6 +254,54 @@ def test_large_sort(n: int, numbers: list[float]) -> None:
         assert val == pytest.approx(sorted(numbers)[n - 1 - i])
 
 
+def _hadamard_matrix(n: int) -> np.ndarray:
+    h = np.array([[1.0]])
+    while h.shape[0] < n:
+        h = np.block([[h, h], [h, -h]])
+    return h
+
+
+def _transform_matrix(kind: str, n: int) -> np.ndarray:
+    if kind in ("dct", "idct"):
+        k = np.arange(n)[:, None]
+        i = np.arange(n)[None, :]
+        m = np.sqrt(2.0 / n) * np.cos(np.pi * (2 * i + 1) * k / (2 * n))
+        m[0] /= np.sqrt(2.0)
+        return m if kind == "dct" else m.T
+    h = _hadamard_matrix(n)
+    if kind == "hadamard":
+        return h
+    # Sequency order: row k has exactly k sign changes.
+    changes = [(np.diff(np.sign(row)) != 0).sum() for row in h]
+    return h[np.argsort(changes)] / np.sqrt(n)
+
+
+@pytest.mark.parametrize("kind", ["dct", "idct", "wht", "hadamard"])
+@pytest.mark.parametrize("n", [2, 4, 8, 16])
+def test_block_transform(kind: str, n: int) -> None:
+    c0 = core.std.BlankClip(format=vs.GRAYS, color=0.0)
+    rng = random.Random(n)
+    numbers = [rng.uniform(-100, 100) for _ in range(n)]
+    expected = _transform_matrix(kind, n) @ np.array(numbers)
+    expr = " ".join(map(str, numbers)) + f" {kind}{n}"
+
+    for i in range(n):
+        full_expr = expr + f" drop{n - i - 1} a! drop{i} a@"
+        res = core.llvmexpr.Expr(c0, full_expr, vs.GRAYS)
+        val = res.get_frame(0)[0][0, 0]
+        assert val == pytest.approx(expected[i], rel=1e-4, abs=1e-3)
+
+
+def test_block_transform_roundtrip() -> None:
+    c0 = core.std.BlankClip(format=vs.GRAYS, color=0.0)
+    res = core.llvmexpr.Expr(
+        c0, "1 2 3 4 5 6 7 8 dct8 idct8 swap7 drop7", vs.GRAYS
+    )
+    assert res.get_frame(0)[0][0, 0] == pytest.approx(8.0, abs=1e-4)
+    res = core.llvmexpr.Expr(c0, "1 5 2 7 wht4 wht4 drop3", vs.GRAYS)
+    assert res.get_frame(0)[0][0, 0] == pytest.approx(1.0, abs=1e-4)
+
+
 def test_named_variables_and_loop_power() -> None:
     c = core.std.BlankClip(format=vs.GRAYS, color=2.0)
     y = core.std.BlankClip(format=vs.GRAYS, color=4.0)
@@ -296,6 +345,429 @@ def test_pixel_access_static_and_dynamic() -> None:
     assert res_abs.get_frame(0)[0][0, 0] == pytest.approx(1.0)
 
 
+def test_temporal_access() -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=8, height=4, length=5)
+    src = core.llvmexpr.Expr(base, "N 10 * X +")
+    res = core.llvmexpr.Expr(src, "x[0,0,-1] x[1,0,1] 100 * + x[0,0,2] 10000 * +")
+    for n in range(5):
+        prev, nxt, far = max(n - 1, 0), min(n + 1, 4), min(n + 2, 4)
+        frame = res.get_frame(n)
+        for x in (0, 3, 7):
+            x1 = min(x + 1, 7)
+            expected = (prev * 10 + x) + (nxt * 10 + x1) * 100 + (far * 10 + x) * 10000
+            assert frame[0][2, x] == pytest.approx(expected)
+
+
+def test_temporal_access_multiple_clips() -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=4, height=2, length=3)
+    a = core.llvmexpr.Expr(base, "N")
+    b = core.llvmexpr.Expr(base, "N 100 *")
+    res = core.llvmexpr.Expr([a, b], "x[0,0,1] y[0,0,1] + y[0,0,0] +")
+    assert res.get_frame(1)[0][0, 0] == pytest.approx(2 + 200 + 100)
+    assert res.get_frame(2)[0][1, 3] == pytest.approx(2 + 200 + 200)
+
+
+def test_multiple_outputs() -> None:
+    a = core.std.BlankClip(format=vs.YUV420P8, width=8, height=4, color=[100, 50, 60])
+    b = core.std.BlankClip(format=vs.YUV420P8, width=8, height=4, color=[40, 70, 90])
+    outputs = core.llvmexpr.Expr([a, b], ["x y - abs d! d@ 2 * @1 d@ 3 * @2 x y + 2 /", ""])
+    assert isinstance(outputs, list) and len(outputs) == 3
+
+    expected = [(70, 50, 60), (120, 50, 60), (180, 50, 60)]
+    for clip, (luma, cb, cr) in zip(outputs, expected):
+        frame = clip.get_frame(0)
+        assert frame[0][1, 3] == luma
+        assert frame[1][0, 0] == cb
+        assert frame[2][1, 3] == cr
+        assert "_LLVMExprOutputs" not in frame.props
+
+
+def test_multiple_outputs_per_plane() -> None:
+    base = core.std.BlankClip(format=vs.RGBS, width=4, height=2, length=2)
+    outputs = core.llvmexpr.Expr(base, ["N 1 + @1 X", "Y", "7 @2 1"])
+    assert len(outputs) == 3
+    frame = [clip.get_frame(1) for clip in outputs]
+    assert frame[0][0][1, 3] == pytest.approx(3.0)
+    assert frame[0][1][1, 3] == pytest.approx(1.0)
+    assert frame[1][0][0, 0] == pytest.approx(2.0)
+    assert frame[2][2][1, 2] == pytest.approx(7.0)
+    # Planes that do not write an output copy the first clip.
+    assert frame[1][2][0, 0] == pytest.approx(0.0)
+    assert frame[2][0][0, 0] == pytest.approx(0.0)
+
+
+def test_multiple_outputs_format() -> None:
+    base = core.std.BlankClip(format=vs.YUV420P8, width=8, height=4, color=[100, 50, 60])
+    outputs = core.llvmexpr.Expr(base, ["x 2 * @1 x", "x", "x"], format=vs.YUV420P16)
+    assert len(outputs) == 2
+    frame = outputs[1].get_frame(0)
+    assert frame.format.id == vs.YUV420P16
+    assert frame[0][1, 3] == 200
+    # Planes that do not write output 1 cannot be copied from the 8-bit clip.
+    assert frame[1][0, 0] == 32768
+    assert frame[2][1, 3] == 32768
+
+
+def test_multiple_outputs_infix() -> None:
+    a = core.std.BlankClip(format=vs.GRAYS, width=4, height=2, color=5.0)
+    avg, diff = core.llvmexpr.Expr(
+        [a, a.std.Expr("x 3 -")],
+        "d = $x - $y\nRESULT1 = d\nRESULT = ($x + $y) / 2",
+        infix=1,
+    )
+    assert avg.get_frame(0)[0][0, 0] == pytest.approx(3.5)
+    assert diff.get_frame(0)[0][1, 3] == pytest.approx(3.0)
+
+
+@pytest.mark.parametrize("fuse_planes", [0, 1])
+def test_reductions(fuse_planes: int) -> None:
+    base = core.std.BlankClip(format=vs.RGBS, width=13, height=7)
+    src = core.llvmexpr.Expr(base, ["X 3 * Y 5 * + 11 % 5 -", "X Y -", "Y"])
+    res = core.llvmexpr.Expr(
+        src,
+        [
+            "x Sum$sum x Lo$min x Hi$max x Pos$count x",
+            "x Sum$sum x Hi$max x",
+            "x Lo$min x",
+        ],
+        fuse_planes=fuse_planes,
+    )
+    frame = res.get_frame(0)
+    planes = [np.asarray(src.get_frame(0)[p], dtype=np.float64) for p in range(3)]
+    assert frame.props["Sum"] == pytest.approx(planes[0].sum() + planes[1].sum())
+    assert frame.props["Lo"] == pytest.approx(min(planes[0].min(), planes[2].min()))
+    assert frame.props["Hi"] == pytest.approx(max(planes[0].max(), planes[1].max()))
+    assert frame.props["Pos"] == int((planes[0] > 0).sum())
+    assert isinstance(frame.props["Pos"], int)
+    np.testing.assert_array_equal(np.asarray(frame[0]), planes[0])
+
+
+def test_reductions_chain_and_infix() -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=9, height=20)
+    src = core.llvmexpr.Expr(base, "X Y * 7 %")
+    res = core.llvmexpr.Chain(src, ["x[1,0] x -", "y[0,1] Total$sum y"], band_rows=3)
+    diff = core.llvmexpr.Expr(src, "x[1,0] x -")
+    expected = np.asarray(diff.get_frame(0)[0], dtype=np.float64)
+    expected = np.concatenate([expected[1:], expected[-1:]]).sum()
+    assert res.get_frame(0).props["Total"] == pytest.approx(expected, rel=1e-6)
+
+    res = core.llvmexpr.Expr(src, "reduce_count(Big, $x - 3)\nRESULT = $x", infix=1)
+    assert res.get_frame(0).props["Big"] == int((np.asarray(src.get_frame(0)[0]) > 3).sum())
+
+
+@pytest.mark.parametrize(
+    "exprs, err_msg",
+    [
+        pytest.param(["x P$sum x P$max x"], "reduced as both", id="same_plane"),
+        pytest.param(["x P$sum x", "x P$min x", ""], "reduced in different ways", id="across_planes"),
+    ],
+)
+def test_reductions_invalid(exprs: list[str], err_msg: str) -> None:
+    c = core.std.BlankClip(format=vs.YUV444PS)
+    with pytest.raises(vs.Error, match=err_msg):
+        core.llvmexpr.Expr(c, exprs)
+
+
+@pytest.mark.parametrize("output_format", [None, vs.YUV444P16])
+def test_copied_planes(output_format: int | None) -> None:
+    base = core.std.BlankClip(format=vs.YUV444P8, width=13, height=7, length=2)
+    src = core.llvmexpr.Expr(base, ["X Y * 7 %", "X 3 * Y + 11 %", "Y 5 *"])
+    other = core.llvmexpr.Expr(base, ["X Y + 9 %", "Y 2 *", "X"])
+    res = core.llvmexpr.Expr(
+        [src, other], ["y", "y 0 + a! a@ 1 *", "x y drop"], output_format
+    )
+    frame = res.get_frame(1)
+    for plane, clip in enumerate([other, other, src]):
+        np.testing.assert_array_equal(
+            np.asarray(frame[plane]), np.asarray(clip.get_frame(1)[plane])
+        )
+
+
+@pytest.mark.parametrize("fuse_planes", [0, 1])
+def test_frame_constant_planes(fuse_planes: int) -> None:
+    base = core.std.BlankClip(format=vs.YUV420P16, width=14, height=10, length=3)
+    src = core.std.SetFrameProps(base, Level=100)
+    res = core.llvmexpr.Expr(
+        src,
+        ["x 1 +", "N 1000 * x.Level + a! a@ 3 > a@ 0 ?", "x.Missing? 7 2 ?"],
+        fuse_planes=fuse_planes,
+    )
+    for n in range(3):
+        frame = res.get_frame(n)
+        assert np.all(np.asarray(frame[1]) == n * 1000 + 100)
+        assert np.all(np.asarray(frame[2]) == 2)
+        assert np.all(np.asarray(frame[0]) == 1)
+
+
+@pytest.mark.parametrize("input_format", [vs.YUV420P8, vs.GRAY16, vs.GRAYS])
+def test_mask_matches_unmasked(input_format: int) -> None:
+    base = core.std.BlankClip(format=input_format, width=150, height=40)
+    src = core.llvmexpr.Expr(base, "X 3 * Y 5 * + 17 %")
+    mask = core.llvmexpr.Expr(base, "X 70 > X 90 < and Y 20 > and 1 0 ?")
+    exprs = ["y 0 = x x[1,0] x[-1,1] + X + 2 / ? v! v@ Sum$sum v@", "y x +"]
+
+    ref = core.llvmexpr.Expr([src, mask], exprs)
+    res = core.llvmexpr.Expr([src, mask], exprs, mask=1)
+
+    ref_frame = ref.get_frame(0)
+    res_frame = res.get_frame(0)
+    for plane in range(ref.format.num_planes):
+        np.testing.assert_array_equal(
+            np.asarray(res_frame[plane]), np.asarray(ref_frame[plane])
+        )
+    assert res_frame.props["Sum"] == pytest.approx(ref_frame.props["Sum"])
+
+
+@pytest.mark.parametrize(
+    "expr, mask, err_msg",
+    [
+        pytest.param("y[1,0] x +", 1, "only be read at the current pixel", id="offset"),
+        pytest.param("x X Y @[] y", 1, "cannot be used with", id="abs_store"),
+        pytest.param("y x +", 2, "mask must be -1", id="index"),
+    ],
+)
+def test_mask_invalid(expr: str, mask: int, err_msg: str) -> None:
+    c = core.std.BlankClip(format=vs.GRAYS)
+    with pytest.raises(vs.Error, match=err_msg):
+        core.llvmexpr.Expr([c, c], expr, mask=mask)
+
+
+def test_tile_cache() -> None:
+    base = core.std.BlankClip(format=vs.YUV444P16, width=300, height=40, length=3)
+    src = core.llvmexpr.Expr(base, "X Y * 7 % N 2 >= X 200 > and 1000 * +")
+    src = core.std.SetFrameProps(src, Gain=2)
+    expr = "x[1,0] x[-1,-1] + x.Gain * y[0,1] +"
+
+    ref = core.llvmexpr.Expr([src, src], expr)
+    res = core.llvmexpr.Expr([src, src], expr, tile_cache=1)
+
+    # Frame 1 repeats frame 0; frame 2 only differs right of X = 200.
+    expected_hits = [0, 18, 6]
+    for n in range(3):
+        ref_frame = ref.get_frame(n)
+        res_frame = res.get_frame(n)
+        for plane in range(3):
+            np.testing.assert_array_equal(
+                np.asarray(res_frame[plane]), np.asarray(ref_frame[plane])
+            )
+        assert res_frame.props["_LLVMExprCacheTiles"] == 18
+        assert res_frame.props["_LLVMExprCacheHits"] == expected_hits[n]
+
+
+def test_stats() -> None:
+    c = core.std.BlankClip(format=vs.YUV420P8, width=64, height=32, length=4)
+    res = core.llvmexpr.Expr(c, ["x[1,0] x[-1,0] + 2 /", "x 1 +"], stats=1)
+    for n in range(4):
+        assert res.get_frame(n).props["_LLVMExprTime"] >= 0
+
+    instances = json.loads(core.llvmexpr.Stats())["instances"]
+    inst = [i for i in instances if i["filter"] == "Expr" and i["frames"] == 4]
+    assert inst
+    planes = inst[-1]["planes"]
+    assert len(planes) == 3
+    assert planes[0]["calls"] == 4
+    assert planes[0]["mpix_per_s"] > 0
+    assert planes[0]["bytes_written"] == 4 * 64 * 32
+
+    json.loads(core.llvmexpr.Stats(reset=1))
+    for i in json.loads(core.llvmexpr.Stats())["instances"]:
+        assert i["frames"] == 0
+
+    with pytest.raises(vs.Error, match="stats must be"):
+        core.llvmexpr.Expr(c, "x", stats=3)
+
+
+def test_cache_key_options() -> None:
+    # The same expression with other compiler options must not reuse the
+    # cached kernel.
+    c = core.std.BlankClip(format=vs.GRAYS, width=24, height=8, length=1)
+    tiers = []
+    for approx_math in [1, 0]:
+        core.llvmexpr.Stats(reset=1)
+        core.llvmexpr.Expr(
+            c, "x 0.37 + sin", approx_math=approx_math, stats=1
+        ).get_frame(0)
+        instances = json.loads(core.llvmexpr.Stats())["instances"]
+        inst = [i for i in instances if i["filter"] == "Expr" and i["frames"]]
+        tiers.append(inst[-1]["planes"][0]["tier"])
+    assert tiers == ["approx_math", "precise"]
+
+
+def test_precompile() -> None:
+    expr = ["x 0.4129 *", "x 0.6131 *"]
+    before = core.llvmexpr.CacheInfo()
+
+    # Planes 1 and 2 share a kernel.
+    res = core.llvmexpr.Precompile(
+        formats=[vs.YUV420P8], width=64, height=32, expr=expr
+    )
+    assert res["kernels"] == 3
+    assert res["compiled"] == 2
+    info = core.llvmexpr.CacheInfo()
+    assert info["entries"] == before["entries"] + 2
+    assert info["misses"] == before["misses"] + 2
+    assert info["hits"] == before["hits"] + 1
+    assert info["code_bytes"] > before["code_bytes"]
+    assert info["compile_ms"] > before["compile_ms"]
+
+    # A filter of the same format and size finds every kernel.
+    c = core.std.BlankClip(format=vs.YUV420P8, width=64, height=32, length=1)
+    assert core.llvmexpr.Precompile(c, expr)["compiled"] == 0
+    core.llvmexpr.Expr(c, expr).get_frame(0)
+    after = core.llvmexpr.CacheInfo(reset=1)
+    assert after["misses"] == info["misses"]
+    assert after["hits"] == info["hits"] + 6
+    assert core.llvmexpr.CacheInfo()["hits"] == 0
+
+    with pytest.raises(vs.Error, match="Exactly one of clips and formats"):
+        core.llvmexpr.Precompile(expr="x")
+    with pytest.raises(vs.Error, match="width and height"):
+        core.llvmexpr.Precompile(formats=[vs.GRAY8], expr="x")
+
+
+def test_clear_cache() -> None:
+    c = core.std.BlankClip(format=vs.GRAYS, width=64, height=8, length=2)
+    expr = "x 0.5813 * 1 +"
+    old = core.llvmexpr.Expr(c, expr)
+    ref = np.asarray(old.get_frame(0)[0]).copy()
+
+    assert core.llvmexpr.ClearCache() >= 1
+    assert core.llvmexpr.CacheInfo()["entries"] == 0
+
+    # The old filter keeps its kernel, and a new one compiles the same
+    # expression again next to it.
+    misses = core.llvmexpr.CacheInfo()["misses"]
+    new = core.llvmexpr.Expr(c, expr)
+    np.testing.assert_array_equal(np.asarray(new.get_frame(0)[0]), ref)
+    np.testing.assert_array_equal(np.asarray(old.get_frame(1)[0]), ref)
+    assert core.llvmexpr.CacheInfo()["misses"] == misses + 1
+
+    # Cleared kernels no filter uses are unloaded.
+    core.llvmexpr.Precompile(
+        formats=[vs.GRAYS], width=64, height=8, expr="x 0.7207 *"
+    )
+    loaded = core.llvmexpr.CacheInfo()["code_bytes"]
+    core.llvmexpr.ClearCache()
+    assert core.llvmexpr.CacheInfo()["code_bytes"] < loaded
+
+
+def test_trace(tmp_path) -> None:
+    path = tmp_path / "trace.json"
+    c = core.std.BlankClip(format=vs.GRAYS, width=32, height=8)
+    res = core.llvmexpr.Expr(
+        c, "RESULT = $x * 0.3217 + 1", infix=1, opt_level=2, trace=str(path)
+    )
+    res.get_frame(0)
+
+    # The trace is an unterminated JSON array.
+    events = json.loads(path.read_text().rstrip().rstrip(",") + "]")
+    names = {e["name"] for e in events if e["ph"] == "X"}
+    for name in ["Expr", "preprocess", "tokenize", "analyze", "compile"]:
+        assert name in names
+    for name in ["IR generation", "O3 round 1", "O3 round 2", "codegen"]:
+        assert name in names
+    assert "O3 round 3" not in names
+
+
+def test_report(tmp_path) -> None:
+    path = tmp_path / "report.txt"
+    c = core.std.BlankClip(format=vs.GRAYS, width=64, height=8)
+    res = core.llvmexpr.Expr(c, "x 0.2731 * 5 +", report=str(path))
+    res.get_frame(0)
+
+    report = path.read_text()
+    assert "process_Expr_plane0_x_0_2731_5" in report
+    assert "vectorized: width" in report
+    assert "hot loop:" in report
+    assert "code size:" in report
+    assert "throughput:" in report
+
+
+def test_kernel_names(tmp_path) -> None:
+    c = core.std.BlankClip(format=vs.GRAYS, width=32, height=8)
+    res = core.llvmexpr.Expr(c, "x 2 *", dump_ir=str(tmp_path / "k.ll"))
+    res.get_frame(0)
+    assert list(tmp_path.glob("k.process_Expr_plane0_x_2_*"))
+
+    res = core.llvmexpr.SingleExpr(
+        c, "src0^0.mean Mean$", dump_ir=str(tmp_path / "s.ll")
+    )
+    res.get_frame(0)
+    assert list(tmp_path.glob("s.process_SingleExpr_src0_0_mean_Mean_*"))
+
+
+def test_chain_matches_separate_exprs() -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=16, height=8)
+    src = core.llvmexpr.Expr(base, "X 3 * Y 5 * + 7 %")
+    ref = core.llvmexpr.Expr(base, "X Y * 0.1 *")
+    stages = [
+        "x 0.5 * t! t@ t@ *",
+        "src2 y - abs",
+        "x[1,0] x[-1,0] - src3 +",
+        "src4 src2 max 10 min",
+    ]
+    chained = core.llvmexpr.Chain([src, ref], stages)
+
+    s0 = core.llvmexpr.Expr(src, stages[0])
+    s1 = core.llvmexpr.Expr([src, ref, s0], stages[1])
+    s2 = core.llvmexpr.Expr([src, ref, s0, s1], stages[2])
+    s3 = core.llvmexpr.Expr([src, ref, s0, s1, s2], stages[3])
+    np.testing.assert_allclose(
+        np.asarray(chained.get_frame(0)[0]), np.asarray(s3.get_frame(0)[0]), rtol=1e-6
+    )
+
+
+def test_chain_private_variables_and_infix() -> None:
+    c = core.std.BlankClip(format=vs.GRAYS, width=4, height=2, color=2.0)
+    res = core.llvmexpr.Chain(c, ["3 v! x v@ *", "1 v! y v@ +"])
+    assert res.get_frame(0)[0][0, 0] == pytest.approx(7.0)
+
+    res = core.llvmexpr.Chain(c, ["RESULT = $x * 3", "RESULT = $y + $x"], infix=1)
+    assert res.get_frame(0)[0][1, 3] == pytest.approx(8.0)
+
+
+@pytest.mark.parametrize("boundary", [0, 1])
+@pytest.mark.parametrize("band_rows", [-1, 1, 3])
+def test_chain_neighbourhood_stages(boundary: int, band_rows: int) -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=16, height=11)
+    src = core.llvmexpr.Expr(base, "X 7 * Y Y * 3 * + 13 %")
+    stages = [
+        "x[-1,0] x x[1,0] + + 3 /",  # read at an offset
+        "y[0,-1] y y[0,1] + + 3 /",  # reads a scratch plane, read at an offset
+        "z[0,2] z[0,-2] - y +",      # reads two scratch planes
+        "a y - x[2,1] +",            # reads stage 2 in a variable, stage 0 from its plane
+    ]
+    chained = core.llvmexpr.Chain(src, stages, boundary=boundary, band_rows=band_rows)
+
+    clips = [src]
+    for stage in stages:
+        clips.append(core.llvmexpr.Expr(clips, stage, boundary=boundary))
+    np.testing.assert_allclose(
+        np.asarray(chained.get_frame(0)[0]), np.asarray(clips[-1].get_frame(0)[0]), rtol=1e-6
+    )
+
+    with pytest.raises(vs.Error, match="band_rows"):
+        core.llvmexpr.Chain(src, stages, band_rows=0)
+
+
+@pytest.mark.parametrize(
+    "stages, err_msg",
+    [
+        pytest.param(["x", "y[1,0,1]"], "at another frame", id="stage_temporal_access"),
+        pytest.param(["x", "y.box[-1,-1,1,1]"], "unsupported access", id="stage_box_access"),
+        pytest.param(["x", "y[1,0] x.box[-1,-1,1,1] +"], "not supported in a chain", id="box_with_scratch"),
+        pytest.param(["x", "z"], "Invalid clip index", id="forward_reference"),
+        pytest.param(["^exit^", "y"], "only allowed in the last stage", id="output_control"),
+        pytest.param(["x S$sum x", "y"], "only allowed in the last stage", id="stage_reduction"),
+        pytest.param(["x 1", "y"], "stage 0", id="stage_stack"),
+    ],
+)
+def test_chain_invalid(stages: list[str], err_msg: str) -> None:
+    c = core.std.BlankClip(format=vs.GRAYS)
+    with pytest.raises(vs.Error, match=err_msg):
+        core.llvmexpr.Chain(c, stages)
+
+
 def test_frame_property_access() -> None:
     c = core.std.BlankClip(format=vs.GRAYS, color=0.0)
     c = core.std.SetFrameProps(c, _TestProp=0.25)
@@ -403,6 +875,230 @@ def test_boundary_conditions(
     assert frame[0][y, x] == pytest.approx(expected)
 
 
+box_sum_test_cases = [
+    pytest.param("x.box[-1,-1,1,1]", 1, 1, 45.0, id="rel_3x3_interior"),
+    pytest.param("x.box[-1,-1,1,1]", 0, 0, 10.0, id="rel_3x3_topleft_clipped"),
+    pytest.param("x.box[0,0,0,0]", 2, 3, 14.0, id="rel_single_pixel"),
+    pytest.param("x.box[1,0,5,0]", 3, 2, 0.0, id="rel_fully_outside"),
+    pytest.param("0 0 3 3 x.box[]", 2, 2, 120.0, id="abs_whole_frame"),
+    pytest.param("X Y X 1 + Y x.box[]", 1, 2, 19.0, id="abs_dynamic"),
+    pytest.param("x.pdist[0,0,1]", 1, 1, 0.0, id="patch_dist_zero_offset"),
+    pytest.param("x.pdist[1,0,1]", 1, 1, 9.0, id="patch_dist_horizontal"),
+    pytest.param("x.pdist[0,1,1]", 1, 1, 144.0, id="patch_dist_vertical"),
+    pytest.param("x.pdist[1,1,0]", 1, 1, 25.0, id="patch_dist_single_pixel"),
+    pytest.param("x.pdist[1,0,0]", 3, 0, 0.0, id="patch_dist_clamped_edge"),
+]
+
+
+@pytest.mark.parametrize("expr, x, y, expected", box_sum_test_cases)
+def test_box_sum(
+    ramp_clip: vs.VideoNode, expr: str, x: int, y: int, expected: float
+) -> None:
+    res = core.llvmexpr.Expr(ramp_clip, expr)
+    frame = res.get_frame(0)
+    assert frame[0][y, x] == pytest.approx(expected)
+
+
+@pytest.mark.parametrize("mask", [-1, 1])
+def test_patch_distance_bands(mask: int) -> None:
+    # Wide enough for the distance planes to be computed in several bands.
+    base = core.std.BlankClip(format=vs.GRAY8, width=2048, height=150)
+    src = core.llvmexpr.Expr(base, "X 37 * Y 101 * + 256 %")
+    mask_clip = core.llvmexpr.Expr(
+        base, "X 64 / floor Y 16 / floor + 3 % 0 = 255 0 ?"
+    )
+    offsets = [(1, 2), (-2, 1), (0, -3), (3, 3)]
+    terms = [
+        f"x[{i},{j}]:c x[{dx + i},{dy + j}]:c - dup *"
+        for dx, dy in offsets
+        for i in (-1, 0, 1)
+        for j in (-1, 0, 1)
+    ]
+    explicit = terms[0] + "".join(f" {t} +" for t in terms[1:])
+    pdist = " ".join(
+        f"x.pdist[{dx},{dy},1]" + (" +" if k else "")
+        for k, (dx, dy) in enumerate(offsets)
+    )
+
+    res = core.llvmexpr.Expr(
+        [src, mask_clip], f"y 0 = 0 {pdist} ?", format=vs.GRAYS, mask=mask
+    )
+    ref = core.llvmexpr.Expr(
+        [src, mask_clip], f"y 0 = 0 {explicit} ?", format=vs.GRAYS
+    )
+
+    np.testing.assert_array_equal(
+        np.asarray(res.get_frame(0)[0]), np.asarray(ref.get_frame(0)[0])
+    )
+
+
+@pytest.mark.parametrize("tile_width", [1, 7, 64, 1000])
+@pytest.mark.parametrize("boundary", [0, 1])
+def test_tile_width_matches_untiled(tile_width: int, boundary: int) -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=150, height=12)
+    src = core.llvmexpr.Expr(base, "X 7 * Y 13 * + 17 %")
+    expr = "x[-2,-3] x[2,0] + x[0,3] 2 * + x[-1,1] - X 0.5 * + Y +"
+
+    ref = core.llvmexpr.Expr(src, expr, boundary=boundary, tile_width=0)
+    res = core.llvmexpr.Expr(src, expr, boundary=boundary, tile_width=tile_width)
+
+    np.testing.assert_array_equal(
+        np.asarray(res.get_frame(0)[0]), np.asarray(ref.get_frame(0)[0])
+    )
+
+
+@pytest.mark.parametrize("row_block", [2, 4])
+@pytest.mark.parametrize("height", [12, 13, 3])
+def test_row_block_matches_single_row(row_block: int, height: int) -> None:
+    base = core.std.BlankClip(format=vs.GRAY16, width=37, height=height)
+    src = core.llvmexpr.Expr(base, "X 131 * Y 977 * + 65535 %")
+    expr = "x[0,-2] x[0,-1] + x x[0,1] + x[1,2]:m + 5 / Y 3 * +"
+
+    ref = core.llvmexpr.Expr(src, expr, row_block=1)
+    res = core.llvmexpr.Expr(src, expr, row_block=row_block, tile_width=16)
+
+    np.testing.assert_array_equal(
+        np.asarray(res.get_frame(0)[0]), np.asarray(ref.get_frame(0)[0])
+    )
+
+
+@pytest.mark.parametrize("input_format", [vs.RGBS, vs.YUV444P16, vs.YUV420P8])
+def test_fuse_planes_matches_separate(input_format: int) -> None:
+    base = core.std.BlankClip(format=input_format, width=48, height=10)
+    src = core.llvmexpr.Expr(base, ["X Y * 7 %", "X 3 * Y + 11 %", "Y 5 * X - 13 %"])
+    other = core.llvmexpr.Expr(base, "X Y + 9 %")
+    exprs = [
+        "x[-1,0] x[1,1] + y - X Y * 0.5 * + abs 2 /",
+        "x y max x[0,-2] min X Y * 0.5 * +",
+        "",
+    ]
+
+    ref = core.llvmexpr.Expr([src, other], exprs, fuse_planes=0)
+    res = core.llvmexpr.Expr([src, other], exprs, fuse_planes=1)
+
+    ref_frame = ref.get_frame(0)
+    res_frame = res.get_frame(0)
+    for plane in range(ref.format.num_planes):
+        np.testing.assert_array_equal(
+            np.asarray(res_frame[plane]), np.asarray(ref_frame[plane])
+        )
+
+
+def test_loop_options_invalid() -> None:
+    c = core.std.BlankClip(format=vs.GRAYS)
+    with pytest.raises(vs.Error, match="tile_width must be"):
+        core.llvmexpr.Expr(c, "x", tile_width=-2)
+    with pytest.raises(vs.Error, match="row_block must be"):
+        core.llvmexpr.Expr(c, "x", row_block=3)
+
+
+interp_test_cases = [
+    # ramp_clip holds 4 * y + x
+    pytest.param("x.bilinear[0.5,0.25]", 1, 1, 6.5, id="bilinear_rel"),
+    pytest.param("x.bilinear[0,0]", 2, 3, 14.0, id="bilinear_rel_integer"),
+    pytest.param("x.bicubic[0.5,0]", 1, 1, 5.5, id="bicubic_rel_linear_data"),
+    pytest.param("x.lanczos2[-1,0]", 2, 2, 9.0, id="lanczos2_rel_integer"),
+    pytest.param("x.bilinear[1.5,0]", 3, 0, 3.0, id="bilinear_rel_clamped"),
+    pytest.param("1.25 2.5 x.bilinear[]", 0, 0, 11.25, id="bilinear_abs"),
+    pytest.param("1.5 1 x.bicubic[]", 0, 0, 5.5, id="bicubic_abs"),
+    pytest.param("2 1 x.lanczos2[]", 0, 0, 6.0, id="lanczos2_abs_integer"),
+    pytest.param("3.5 0 x.bilinear[]", 0, 0, 3.0, id="bilinear_abs_clamped"),
+    pytest.param("X 0.5 + Y x.bilinear[]", 1, 2, 9.5, id="bilinear_abs_dynamic"),
+]
+
+
+@pytest.mark.parametrize("expr, x, y, expected", interp_test_cases)
+def test_interpolated_access(
+    ramp_clip: vs.VideoNode, expr: str, x: int, y: int, expected: float
+) -> None:
+    res = core.llvmexpr.Expr(ramp_clip, expr)
+    frame = res.get_frame(0)
+    assert frame[0][y, x] == pytest.approx(expected, abs=1e-4)
+
+
+@pytest.mark.parametrize("kind", ["bilinear", "bicubic", "lanczos2"])
+def test_interpolated_rel_matches_abs(kind: str) -> None:
+    base = core.std.BlankClip(format=vs.GRAYS, width=40, height=9)
+    src = core.llvmexpr.Expr(base, "X 5 * Y 11 * + 13 % X Y * 0.1 * +")
+    rel = core.llvmexpr.Expr(src, f"x.{kind}[0.25,-0.75]")
+    dyn = core.llvmexpr.Expr(src, f"X 0.25 + Y 0.75 - x.{kind}[]:b")
+    np.testing.assert_allclose(
+        np.asarray(rel.get_frame(0)[0]), np.asarray(dyn.get_frame(0)[0]), atol=1e-3
+    )
+
+
+def _sited_read(plane: np.ndarray, size: tuple[int, int], siting: str) -> np.ndarray:
+    """Reference for clip^plane:siting reads of `plane` into a plane of `size`."""
+
+    def axis(n: int, src_n: int, mode: str) -> list[list[tuple[int, float]]]:
+        if src_n >= n:
+            r = src_n // n
+            if mode == "a":
+                return [[(i * r + k, 1 / r) for k in range(r)] for i in range(n)]
+            return [[(i * r, 1.0)] for i in range(n)]
+        r = n // src_n
+        if mode == "n":
+            return [[(i // r, 1.0)] for i in range(n)]
+        taps = []
+        for i in range(n):
+            pos = i / r + (0.5 / r - 0.5 if mode == "a" else 0.0)
+            base = int(np.floor(pos))
+            frac = pos - base
+            taps.append([(base, 1 - frac), (base + 1, frac)])
+        return taps
+
+    h, w = size
+    src_h, src_w = plane.shape
+    taps_y = axis(h, src_h, "a" if siting == "s" else siting)
+    taps_x = axis(w, src_w, siting)
+    out = np.zeros(size)
+    for y in range(h):
+        for x in range(w):
+            for ty, wy in taps_y[y]:
+                for tx, wx in taps_x[x]:
+                    out[y, x] += (
+                        wy * wx * plane[min(max(ty, 0), src_h - 1), min(max(tx, 0), src_w - 1)]
+                    )
+    return out
+
+
+@pytest.mark.parametrize("siting", ["n", "a", "s"])
+def test_cross_plane_siting(siting: str) -> None:
+    base = core.std.BlankClip(format=vs.YUV420PS, width=16, height=8)
+    src = core.llvmexpr.Expr(base, ["X Y 16 * +", "X 3 * Y 7 * -", "X Y *"])
+    res = core.llvmexpr.Expr(src, [f"x^1:{siting}", f"x^0:{siting}", f"x^0[1,-1]:{siting}"])
+
+    src_frame = src.get_frame(0)
+    frame = res.get_frame(0)
+    luma = np.asarray(src_frame[0])
+    chroma = np.asarray(src_frame[1])
+    np.testing.assert_allclose(
+        np.asarray(frame[0]), _sited_read(chroma, luma.shape, siting), rtol=1e-5, atol=1e-4
+    )
+    np.testing.assert_allclose(
+        np.asarray(frame[1]), _sited_read(luma, chroma.shape, siting), rtol=1e-5
+    )
+    shifted = np.pad(luma, ((1, 0), (0, 1)), mode="edge")[:-1, 1:]
+    np.testing.assert_allclose(
+        np.asarray(frame[2]), _sited_read(shifted, chroma.shape, siting), rtol=1e-5
+    )
+
+
+def test_cross_plane_same_size() -> None:
+    base = core.std.BlankClip(format=vs.RGBS, width=8, height=4)
+    src = core.llvmexpr.Expr(base, ["X", "Y", "X Y +"])
+    res = core.llvmexpr.Expr(src, ["x^2", "x^0[1,0] x^1 +", "x"])
+    frame = res.get_frame(0)
+    assert frame[0][3, 5] == pytest.approx(8.0)
+    assert frame[1][2, 7] == pytest.approx(9.0)
+
+
+def test_cross_plane_invalid() -> None:
+    c = core.std.BlankClip(format=vs.GRAYS)
+    with pytest.raises(vs.Error, match="has no plane 1"):
+        core.llvmexpr.Expr(c, "x^1")
+
+
 # Tests for absolute pixel access boundary conditions
 abs_boundary_test_cases = [
     # Default is clamp
@@ -90,6 +90,15 @@ val2 = dyn($src0, 50, 50, 1)
         assert "100 200 x^0[]" in output
         assert "50 50 src0^1[]" in output
 
+    def test_box_sum_single(self):
+        """Test box_sum() with 6 arguments (clip, x0, y0, x1, y1, plane)."""
+        infix = """
+total = box_sum($x, 0, 0, 7, 7, 1)
+"""
+        success, output = run_infix2postfix(infix, "single")
+        assert success, f"Failed to convert: {output}"
+        assert "0 0 7 7 x^1.box[]" in output
+
     def test_store_four_args(self):
         """Test store() with 4 arguments (x, y, plane, value)."""
         infix = """
@@ -187,6 +196,38 @@ set_prop(MyProperty, my_value)
         assert "inconsistent types" in output
         assert "MyProp" in output
 
+    def test_reduce(self):
+        """Test reduce_*() for frame property reductions in Expr mode."""
+        infix = """
+reduce_sum(Total, $x)
+reduce_count(Bright, $x - 200)
+RESULT = $x
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x Total$sum" in output
+        assert "x 200 - Bright$count" in output
+
+        success, output = run_infix2postfix("reduce_max(M, 1)", "single")
+        assert not success, "reduce_max should not be available in SingleExpr"
+
+    def test_plane_stats(self):
+        """Test plane statistic functions in SingleExpr mode."""
+        infix = """
+set_prop(Mean, plane_mean($x, 0))
+set_prop(Bright, plane_count_if($x, 0, 200, 256))
+h = new(16)
+plane_histogram(h, $x, 1, 0, 256)
+"""
+        success, output = run_infix2postfix(infix, "single")
+        assert success, f"Failed to convert: {output}"
+        assert "x^0.mean Mean$f" in output
+        assert "200 256 x^0.count Bright$f" in output
+        assert "0 256 x^1.hist{" in output
+
+        success, output = run_infix2postfix("RESULT = plane_sum($x, 0)", "expr")
+        assert not success, "plane_sum should not be available in Expr"
+
     def test_complex_single_expr(self):
         """Test a complex SingleExpr script."""
         infix = """
@@ -245,6 +286,45 @@ RESULT = right + left + top
         assert "x[-1,0]" in output
         assert "y[0,-1]" in output
 
+    def test_temporal_pixel_access(self):
+        """Test static pixel access with a frame offset like $x[0, 0, -1]."""
+        infix = """
+prev = $x[0, 0, -1]
+next = $x[1, -2, 1]:m
+same = $y[-1, -1, 0]
+RESULT = prev + next + same
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x[0,0,-1]" in output
+        assert "x[1,-2,1]:m" in output
+        assert "y[-1,-1]" in output
+
+    def test_multiple_results(self):
+        """Test that RESULT1, RESULT2 are written to the extra outputs."""
+        infix = """
+d = abs($x - $y)
+RESULT2 = d * 2
+RESULT1 = d
+RESULT0 = $x
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert output.rstrip().endswith("RESULT1@ @1 RESULT2@ @2 RESULT0@")
+
+    def test_multiple_results_errors(self):
+        """Test scope and naming rules of the result variables."""
+        success, _ = run_infix2postfix("RESULT = $x\nRESULT0 = $y\n", "expr")
+        assert not success, "RESULT and RESULT0 together should fail"
+        infix = """
+if ($X > 1) {
+    RESULT1 = $y
+}
+RESULT = $x
+"""
+        success, _ = run_infix2postfix(infix, "expr")
+        assert not success, "RESULT1 outside the global scope should fail"
+
     def test_dyn_three_args(self):
         """Test dyn() with 3 arguments (clip, x, y) in Expr mode."""
         infix = """
@@ -257,6 +337,54 @@ RESULT = val
         assert "Y 2 /" in output
         assert "x[]" in output
 
+    def test_box_sum_expr(self):
+        """Test box_sum() and box_sum_rel() in Expr mode."""
+        infix = """
+a = box_sum_rel($x, -2, -1, 2, 1)
+b = box_sum($y, $X - 1, $Y, $X + 1, $Y)
+RESULT = a + b
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x.box[-2,-1,2,1]" in output
+        assert "y.box[]" in output
+
+    def test_patch_distance(self):
+        """Test patch_distance() in Expr mode."""
+        infix = """
+RESULT = patch_distance($x, -1, 2, 3)
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x.pdist[-1,2,3]" in output
+
+    def test_interpolated_access(self):
+        """Test bilinear()/bicubic()/lanczos2() and their _rel forms."""
+        infix = """
+a = bilinear($x, $X * 0.5, $Y * 0.5)
+b = bicubic($y, $X, $Y, 1)
+c = lanczos2_rel($x, -0.5, 0.25)
+RESULT = a + b + c
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x.bilinear[]" in output
+        assert "y.bicubic[]:m" in output
+        assert "x.lanczos2[-0.5,0.25]" in output
+
+    def test_plane_at(self):
+        """Test plane_at() in Expr mode."""
+        infix = """
+a = plane_at($x, 0)
+b = plane_at($y, 1, -1, 2)
+RESULT = a + b + plane_at($x, 2, 0, 0, 2)
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert "x^0[0,0]" in output
+        assert "y^1[-1,2]" in output
+        assert "x^2[0,0]:s" in output
+
     def test_store_three_args(self):
         """Test store() with 3 arguments (x, y, value) in Expr mode."""
         infix = """
@@ -1155,6 +1283,23 @@ RESULT = arr[0]
         assert "255 0 arr{}!" in output
         assert "0 arr{}@" in output
 
+    def test_array_block_transform(self):
+        """Test in-place block transforms on arrays."""
+        infix = """
+blk = new(8)
+blk[0] = $x
+dct4(blk)
+hadamard2(blk, 1, 4)
+RESULT = blk[0]
+"""
+        success, output = run_infix2postfix(infix, "expr")
+        assert success, f"Failed to convert: {output}"
+        assert (
+            "0 blk{}@ 1 blk{}@ 2 blk{}@ 3 blk{}@ dct4 "
+            "3 blk{}! 2 blk{}! 1 blk{}! 0 blk{}!" in output
+        )
+        assert "1 blk{}@ 5 blk{}@ hadamard2 5 blk{}! 1 blk{}!" in output
+
     def test_array_creation_single_mode_literal(self):
         """Test array creation with literal size in SingleExpr mode."""
         infix = """
@@ -140,6 +140,70 @@ def test_multi_plane_write():
     assert frame[2][0, 0] == 128
 
 
+def test_box_sum_read():
+    """Test box sums over a plane through the integral image."""
+    clip = core.std.BlankClip(
+        format=vs.YUV420P8, width=16, height=16, color=[16, 128, 128]
+    )
+    res = core.llvmexpr.SingleExpr(
+        clip,
+        "0 0 15 15 x^0.box[] LumaSum$ 0 0 7 7 x^1.box[] ChromaSum$ "
+        "-4 -4 1 1 x^0.box[] CornerSum$",
+    )
+    frame = res.get_frame(0)
+    assert frame.props["LumaSum"] == pytest.approx(16 * 256)
+    assert frame.props["ChromaSum"] == pytest.approx(128 * 64)
+    assert frame.props["CornerSum"] == pytest.approx(16 * 4)
+
+
+@pytest.mark.parametrize("format", [vs.YUV420P8, vs.YUV420P16, vs.YUV420PS])
+def test_plane_stats(format):
+    """Test whole-plane statistics against numpy."""
+    base = core.std.BlankClip(format=format, width=38, height=21)
+    clip = core.llvmexpr.Expr(base, ["X 7 * Y 13 * + 101 %", "X Y * 37 % 3 +"])
+    res = core.llvmexpr.SingleExpr(
+        clip,
+        "x^0.sum Sum$ x^0.mean Mean$ x^0.min Min$ x^0.max Max$ "
+        "x^1.max ChromaMax$ x^1.sum x^1.mean / ChromaCount$ "
+        "20 50 x^0.count InRange$",
+    )
+    props = res.get_frame(0).props
+    luma = np.asarray(clip.get_frame(0)[0], dtype=np.float64)
+    chroma = np.asarray(clip.get_frame(0)[1], dtype=np.float64)
+    assert props["Sum"] == pytest.approx(luma.sum(), rel=1e-6)
+    assert props["Mean"] == pytest.approx(luma.mean(), rel=1e-6)
+    assert props["Min"] == luma.min()
+    assert props["Max"] == luma.max()
+    assert props["ChromaMax"] == chroma.max()
+    assert props["ChromaCount"] == pytest.approx(chroma.size)
+    assert props["InRange"] == ((luma >= 20) & (luma < 50)).sum()
+
+
+def test_plane_histogram():
+    """Test building a histogram into an array."""
+    base = core.std.BlankClip(format=vs.GRAY8, width=40, height=30)
+    clip = core.llvmexpr.Expr(base, "X 5 * Y 3 * + 256 %")
+    res = core.llvmexpr.SingleExpr(
+        clip,
+        "h{}^4 0 256 x^0.hist{h} "
+        "0 h{}@ H0$ 1 h{}@ H1$ 2 h{}@ H2$ 3 h{}@ H3$ "
+        "g{}^2 64 128 x^0.hist{g} 0 g{}@ G0$ 1 g{}@ G1$",
+    )
+    props = res.get_frame(0).props
+    luma = np.asarray(clip.get_frame(0)[0])
+    expected, _ = np.histogram(luma, bins=4, range=(0, 256))
+    assert [props[f"H{i}"] for i in range(4)] == list(expected)
+    expected, _ = np.histogram(luma[(luma >= 64) & (luma < 128)], bins=2, range=(64, 128))
+    assert [props["G0"], props["G1"]] == list(expected)
+
+
+def test_plane_histogram_uninitialized_error():
+    """Test that a histogram needs an allocated array."""
+    clip = core.std.BlankClip(format=vs.GRAY8)
+    with pytest.raises(vs.Error, match="Array is uninitialized"):
+        core.llvmexpr.SingleExpr(clip, "0 256 x^0.hist{h}")
+
+
 def test_atomic_prop_write():
     """Test that property writes are visible within the same expression."""
     clip = core.std.BlankClip()
@@ -489,6 +553,14 @@ def test_clip_dimensions_tokens():
     assert frame.props["c3h"] == 1080
 
 
+@pytest.mark.parametrize("expr", ["y:width W$", "src3:height^0 H$"])
+def test_clip_dimensions_invalid_clip(expr):
+    """Test that dimensions of a missing clip are rejected."""
+    clip = core.std.BlankClip(format=vs.GRAY8)
+    with pytest.raises(vs.Error, match="Invalid clip index"):
+        core.llvmexpr.SingleExpr(clip, expr)
+
+
 @pytest.mark.parametrize(
     "expr, prop_name, expected_value, expected_type",
     [